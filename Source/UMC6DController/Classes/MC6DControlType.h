@@ -10,6 +10,9 @@
 *	Acceleration - set acceleration directly: distance(rad) / time^2, the effect is independent
 *	Force - set force(torque): mass * distance(rad) / time^2
 *	Impulse - set impulse: mass * distance(rad) / time
+*	StablePD - implicit PD force(torque) on the predicted next step state, P and D are the stiffness and damping,
+*		stable for high gains at large time steps (uses the body mass and inertia, no integral term)
+*	Spring - closed form damped spring towards the target applied as velocity, parameterized by half-life (frame rate independent)
 */
 UENUM()
 enum class EMC6DControlType : uint8
@@ -20,4 +23,6 @@ enum class EMC6DControlType : uint8
 	Acceleration			UMETA(DisplayName = "Acceleration"),
 	Force					UMETA(DisplayName = "Force/Torque"),
 	Impulse					UMETA(DisplayName = "Impulse"),
+	StablePD				UMETA(DisplayName = "Stable PD"),
+	Spring					UMETA(DisplayName = "Spring"),
 };
\ No newline at end of file
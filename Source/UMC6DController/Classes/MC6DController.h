@@ -5,7 +5,10 @@
 
 #include "EngineMinimal.h"
 #include "MCPIDController3D.h"
+#include "MCSpringController3D.h"
 #include "MC6DControlType.h"
+#include "MC6DRotationError.h"
+#include "MC6DPhysicsCommands.h"
 #include "MC6DController.generated.h"
 
 // Forward declarations
@@ -75,9 +78,40 @@ public:
 	// Reset the rotation pid controller
 	void ResetRot(float P, float I, float D, float Max, bool bClearErrors = true);
 
-	// Call the update function pointer
+	// Replace the location pid controller with a relay (auto tune), until the next ResetLoc
+	void ResetLocAsRelay(float Amplitude, float Band);
+
+	// Replace the rotation pid controller with a relay (auto tune), until the next ResetRot
+	void ResetRotAsRelay(float Amplitude, float Band);
+
+	// Set the rotation error type and the frame of the rotation controller
+	void SetRotationError(EMC6DRotationErrorType InType, EMC6DRotationFrame InFrame, bool bClearErrors = true);
+
+	// Set the spring controllers parameters (Spring control type)
+	void SetSprings(const FMCSpringController3D& InLocSpring, const FMCSpringController3D& InRotSpring);
+
+	// Force control: treat the pid outputs as accelerations and scale them by the body mass and inertia
+	void SetComputedTorque(bool bEnable, bool bInCompensateGravity = true);
+
+	// Set the anti-windup, derivative filtering and slew limiting of the pid controllers
+	// (the location derivative on measurement uses the mesh location, the rotation always differentiates the error)
+	void SetPIDSettings(const FMCPIDSettings& InLocSettings, const FMCPIDSettings& InRotSettings, bool bClearErrors = true);
+
+	// Set the time step range and non finite error handling of the pid controllers
+	void SetPIDGuard(const FMCPIDGuard& InGuard);
+
+	// Sum of the guard counters of the pid controllers
+	FMCPIDGuardCounters GetGuardCounters() const;
+
+	// Call the update function pointer, the physics writes are applied under a single scene write lock
 	void UpdateController(float DeltaTime);
 
+	// Get the location error of the last update
+	FVector GetLastLocError() const { return bLocStablePD ? StablePDLocError : PIDLoc.GetLastError(); };
+
+	// Get the rotation error of the last update (in the selected rotation error type, world rotation vector for stable PD)
+	FVector GetLastRotError() const { return bRotStablePD ? StablePDRotError : PIDRot.GetLastError(); };
+
 #if UMC_WITH_CHART
 	// Get the chart data
 	void GetDebugChartData(FVector& OutLocErr, FVector& OutLocPID, FVector& OutRotErr, FVector& OutRotPID);
@@ -92,9 +126,30 @@ private:
 	void SetRotDebugChartData(const FVector& InRotErr, const FVector& InRotPID);
 #endif // UMC_WITH_CHART
 
-	// Get the location delta (error)
+	// Get the rotation delta (error) in the selected type and frame
 	FVector GetRotationDelta(const FQuat& From, const FQuat& To);
 
+	// Get the rotation PID output in world frame
+	FVector GetRotationOutput(const FQuat& From, const FVector& InOutput);
+
+	// Accumulate the body rotation since the last update in the selected type and frame (rotation PID measurement)
+	FVector GetRotationMeasurement(const FQuat& SelfQuat);
+
+	// Refresh the cached mass and inertia if the controlled body changed, false if there is no body
+	bool UpdateBodyCache(UPrimitiveComponent* InComp);
+
+	// Get the force producing the acceleration on the cached body (with gravity compensation)
+	FVector GetComputedForce(const FVector& InAcceleration) const;
+
+	// Get the torque producing the angular acceleration on the cached body (with the gyroscopic term)
+	FVector GetComputedTorque(const FVector& InAngularAcceleration) const;
+
+	// Get the stable (implicit) PD force from the location error, P and D act as stiffness and damping
+	FVector GetStablePDForce(FBodyInstance* BI, const FVector& InError, float DeltaTime);
+
+	// Get the stable (implicit) PD torque from the world rotation vector error, P and D act as stiffness and damping
+	FVector GetStablePDTorque(FBodyInstance* BI, const FVector& InError, float DeltaTime);
+
 private:
 #if UMC_WITH_CHART
 	// Cached data for chart visualization
@@ -137,6 +192,68 @@ private:
 	// Rotation pid controller
 	FMCPIDController3D PIDRot;
 
+	// The stable PD controls only read the pid gains, their last errors are stored here
+	bool bLocStablePD;
+	bool bRotStablePD;
+	FVector StablePDLocError;
+	FVector StablePDRotError;
+
+	// Location spring controller
+	FMCSpringController3D SpringLoc;
+
+	// Rotation spring controller
+	FMCSpringController3D SpringRot;
+
+	// Rotation error type
+	EMC6DRotationErrorType RotErrorType;
+
+	// Frame of the rotation error and controller
+	EMC6DRotationFrame RotErrorFrame;
+
+	// Accumulated body rotation, its change is the error change without the target movement (derivative on measurement)
+	FVector RotMeasurement;
+
+	// Body rotation of the last update
+	FQuat PrevSelfQuat;
+	bool bHasPrevSelfQuat;
+
+	// Scale the force control outputs by the mass and inertia of the body
+	bool bComputedTorque;
+
+	// Add the gravity compensation to the computed force
+	bool bCompensateGravity;
+
+	// Body the mass data was cached from
+	FBodyInstance* CachedBodyInstance;
+
+	// Mass scale of the body when cached
+	float CachedMassScale;
+
+	// Mass override of the body when cached (negative if not overridden)
+	float CachedMassOverride;
+
+	// Number of shapes welded to the body when cached (welding changes the mass and inertia)
+	int32 CachedNumWeldedShapes;
+
+	// Gravity flag of the body and gravity of the world when cached
+	bool bCachedEnableGravity;
+	float CachedGravityZ;
+
+	// Body mass
+	float CachedMass;
+
+	// Principal moments of inertia
+	FVector CachedInertia;
+
+	// Rotation of the principal axes relative to the body
+	FQuat CachedMassSpaceLocalQuat;
+
+	// Gravity acceleration acting on the body (zero without gravity compensation)
+	FVector CachedGravity;
+
+	// Physics writes list of the world (shared by all the controllers, submitted before the physics step)
+	FMC6DPhysicsCommandList* Commands;
+
 	/* Update function bindings */
 	// Function pointer type for calling the correct update function
 	typedef void(FMC6DController::*UpdateFunctionPointerType)(float);
@@ -158,12 +275,16 @@ private:
 	void Loc_Update_Skel_Impulse(float DeltaTime);
 	void Loc_Update_Skel_Acceleration(float DeltaTime);
 	void Loc_Update_Skel_Force(float DeltaTime);
+	void Loc_Update_Skel_StablePD(float DeltaTime);
+	void Loc_Update_Skel_Spring(float DeltaTime);
 	// Rot
 	void Rot_Update_Skel_Position(float DeltaTime);
 	void Rot_Update_Skel_Velocity(float DeltaTime);
 	void Rot_Update_Skel_Impulse(float DeltaTime);
 	void Rot_Update_Skel_Acceleration(float DeltaTime);
 	void Rot_Update_Skel_Force(float DeltaTime);
+	void Rot_Update_Skel_StablePD(float DeltaTime);
+	void Rot_Update_Skel_Spring(float DeltaTime);
 
 	/* Skeletal updates with offset */
 	// Loc
@@ -172,12 +293,16 @@ private:
 	void Loc_Update_Skel_Impulse_Offset(float DeltaTime);
 	void Loc_Update_Skel_Acceleration_Offset(float DeltaTime);
 	void Loc_Update_Skel_Force_Offset(float DeltaTime);
+	void Loc_Update_Skel_StablePD_Offset(float DeltaTime);
+	void Loc_Update_Skel_Spring_Offset(float DeltaTime);
 	// Rot
 	void Rot_Update_Skel_Position_Offset(float DeltaTime);
 	void Rot_Update_Skel_Velocity_Offset(float DeltaTime);
 	void Rot_Update_Skel_Impulse_Offset(float DeltaTime);
 	void Rot_Update_Skel_Acceleration_Offset(float DeltaTime);
 	void Rot_Update_Skel_Force_Offset(float DeltaTime);
+	void Rot_Update_Skel_StablePD_Offset(float DeltaTime);
+	void Rot_Update_Skel_Spring_Offset(float DeltaTime);
 
 	/* Static mesh updates */
 	// Loc
@@ -186,12 +311,16 @@ private:
 	void Loc_Update_Static_Impulse(float DeltaTime);
 	void Loc_Update_Static_Acceleration (float DeltaTime);
 	void Loc_Update_Static_Force(float DeltaTime);
+	void Loc_Update_Static_StablePD(float DeltaTime);
+	void Loc_Update_Static_Spring(float DeltaTime);
 	// Rot
 	void Rot_Update_Static_Position(float DeltaTime);
 	void Rot_Update_Static_Velocity(float DeltaTime);
 	void Rot_Update_Static_Impulse(float DeltaTime);
 	void Rot_Update_Static_Acceleration(float DeltaTime);
 	void Rot_Update_Static_Force(float DeltaTime);
+	void Rot_Update_Static_StablePD(float DeltaTime);
+	void Rot_Update_Static_Spring(float DeltaTime);
 
 	/* Static mesh updates with offset */
 	// Loc
@@ -200,10 +329,14 @@ private:
 	void Loc_Update_Static_Impulse_Offset(float DeltaTime);
 	void Loc_Update_Static_Acceleration_Offset(float DeltaTime);
 	void Loc_Update_Static_Force_Offset(float DeltaTime);
+	void Loc_Update_Static_StablePD_Offset(float DeltaTime);
+	void Loc_Update_Static_Spring_Offset(float DeltaTime);
 	// Rot
 	void Rot_Update_Static_Position_Offset(float DeltaTime);
 	void Rot_Update_Static_Velocity_Offset(float DeltaTime);
 	void Rot_Update_Static_Impulse_Offset(float DeltaTime);
 	void Rot_Update_Static_Acceleration_Offset(float DeltaTime);
 	void Rot_Update_Static_Force_Offset(float DeltaTime);
+	void Rot_Update_Static_StablePD_Offset(float DeltaTime);
+	void Rot_Update_Static_Spring_Offset(float DeltaTime);
 };
@@ -0,0 +1,149 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "EngineMinimal.h"
+
+// Forward declarations
+class UPrimitiveComponent;
+class USkeletalMeshComponent;
+class UWorld;
+class FPhysScene;
+struct FBodyInstance;
+
+/**
+ * List of physics body writes (velocities, forces, torques, impulses),
+ * the commands of the same body are coalesced (velocities are overwritten, the rest is summed),
+ * and the whole list is applied under a single physics scene write lock;
+ * the controllers of a world record into its shared list (GetWorldList) which is submitted once per frame
+ * from the physics scene pre tick (game thread, right before the step);
+ * commands whose body was deleted since (physics state recreation) are skipped
+ */
+class UMC6DCONTROLLER_API FMC6DPhysicsCommandList
+{
+public:
+	// Teleport the body to the location (combined with a rotation teleport of the same body)
+	void SetBodyLocation(FBodyInstance* BI, const FVector& InLocation);
+
+	// Teleport the body to the rotation (combined with a location teleport of the same body)
+	void SetBodyRotation(FBodyInstance* BI, const FQuat& InRotation);
+
+	// Set the linear velocity of the body
+	void SetLinearVelocity(FBodyInstance* BI, const FVector& InVelocity);
+	void SetLinearVelocity(UPrimitiveComponent* InComp, const FVector& InVelocity);
+
+	// Set the linear velocity of every body of the skeletal mesh
+	void SetAllLinearVelocity(USkeletalMeshComponent* InComp, const FVector& InVelocity);
+
+	// Set the angular velocity (rad/s) of the body
+	void SetAngularVelocityInRadians(FBodyInstance* BI, const FVector& InAngVelocity);
+	void SetAngularVelocityInRadians(UPrimitiveComponent* InComp, const FVector& InAngVelocity);
+
+	// Add a force (or an acceleration) to the body
+	void AddForce(FBodyInstance* BI, const FVector& InForce, bool bAccelChange = false);
+	void AddForce(UPrimitiveComponent* InComp, const FVector& InForce, bool bAccelChange = false);
+
+	// Add a force (or an acceleration) to every body of the skeletal mesh
+	void AddForceToAllBodies(USkeletalMeshComponent* InComp, const FVector& InForce, bool bAccelChange = false);
+
+	// Add a torque (or an angular acceleration) in radians to the body
+	void AddTorqueInRadians(FBodyInstance* BI, const FVector& InTorque, bool bAccelChange = false);
+	void AddTorqueInRadians(UPrimitiveComponent* InComp, const FVector& InTorque, bool bAccelChange = false);
+
+	// Add an impulse (or a velocity change) to the body
+	void AddImpulse(FBodyInstance* BI, const FVector& InImpulse, bool bVelChange = false);
+	void AddImpulse(UPrimitiveComponent* InComp, const FVector& InImpulse, bool bVelChange = false);
+
+	// Add an impulse (or a velocity change) to every body of the skeletal mesh
+	void AddImpulseToAllBodies(USkeletalMeshComponent* InComp, const FVector& InImpulse, bool bVelChange = false);
+
+	// Add an angular impulse (or an angular velocity change) in radians to the body
+	void AddAngularImpulseInRadians(FBodyInstance* BI, const FVector& InImpulse, bool bVelChange = false);
+	void AddAngularImpulseInRadians(UPrimitiveComponent* InComp, const FVector& InImpulse, bool bVelChange = false);
+
+	// Shared list of the world physics scene, submitted before every physics step (game thread only, null without a physics scene)
+	static FMC6DPhysicsCommandList* GetWorldList(UWorld* InWorld);
+
+	// Apply the commands (one write lock per physics scene) and clear the list
+	void Submit();
+
+	// Clear the list without applying it (keeps the allocations)
+	void Reset();
+
+	// Number of bodies with pending commands
+	int32 Num() const { return Commands.Num(); };
+
+	// True if there are no pending commands
+	bool IsEmpty() const { return Commands.Num() == 0; };
+
+	// Number of writes recorded since the last submit (before coalescing)
+	int32 GetNumRecorded() const { return NumRecorded; };
+
+private:
+	// Pending writes of a body
+	enum ECommandFlags : uint16
+	{
+		HasLinearVelocity = 1 << 0,
+		HasAngularVelocity = 1 << 1,
+		HasForce = 1 << 2,
+		HasAcceleration = 1 << 3,
+		HasTorque = 1 << 4,
+		HasAngularAcceleration = 1 << 5,
+		HasImpulse = 1 << 6,
+		HasVelocityChange = 1 << 7,
+		HasAngularImpulse = 1 << 8,
+		HasAngularVelocityChange = 1 << 9,
+		HasLocation = 1 << 10,
+		HasRotation = 1 << 11,
+	};
+
+	// Coalesced writes of a body
+	struct FBodyCommand
+	{
+		FBodyInstance* BI;
+		TWeakObjectPtr<UPrimitiveComponent> OwnerComp;
+		int32 BodyIndex;
+		uint16 Flags;
+		FVector Location;
+		FQuat Rotation;
+		FVector LinearVelocity;
+		FVector AngularVelocity;
+		FVector Force;
+		FVector Acceleration;
+		FVector Torque;
+		FVector AngularAcceleration;
+		FVector Impulse;
+		FVector VelocityChange;
+		FVector AngularImpulse;
+		FVector AngularVelocityChange;
+	};
+
+	// Get the command of the body, add it if needed
+	FBodyCommand& FindOrAdd(FBodyInstance* BI);
+
+	// True if the body of the command was not deleted since it was recorded
+	static bool IsBodyAlive(const FBodyCommand& InCommand);
+
+	// Apply the writes of the body, the scene write lock must be held
+	static void Apply_AssumesLocked(FPhysScene* InScene, const FBodyCommand& InCommand);
+
+	// Submit the shared list of the scene before its step
+	static void OnPhysScenePreTick(FPhysScene* InScene, float DeltaTime);
+
+	// Remove the shared list of the terminated scene
+	static void OnPhysSceneTerm(FPhysScene* InScene);
+
+private:
+	// Pending commands
+	TArray<FBodyCommand> Commands;
+
+	// Index of the command of each body
+	TMap<FBodyInstance*, int32> CommandIndices;
+
+	// Recorded writes since the last submit
+	int32 NumRecorded = 0;
+
+	// Shared list of every physics scene
+	static TMap<FPhysScene*, TUniquePtr<FMC6DPhysicsCommandList>> SceneLists;
+};
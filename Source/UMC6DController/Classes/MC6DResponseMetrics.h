@@ -0,0 +1,110 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Response metrics of an axis group (location in cm, rotation in deg),
+* the step metrics are measured from the time the target stops moving
+*/
+struct UMC6DCONTROLLER_API FMC6DAxisMetrics
+{
+	// Time (s) for the error to go from 90% to 10% of the error when the target stopped (remaining time if never reached)
+	float RiseTime = 0.f;
+
+	// Largest distance past the target along the approach direction, relative to the error when the target stopped
+	float Overshoot = 0.f;
+
+	// Time (s) until the error stays in the settling band (remaining time if it never settles)
+	float SettlingTime = 0.f;
+
+	// Mean error at the end of the run
+	float SteadyStateError = 0.f;
+
+	// Root mean square and largest error over the whole run
+	float RMSError = 0.f;
+	float MaxError = 0.f;
+
+	// Integral of the squared controller output
+	float Effort = 0.f;
+};
+
+/**
+* Accumulates the tracking errors and controller outputs of a run (e.g. a trajectory replay) into the response metrics
+*/
+class UMC6DCONTROLLER_API FMC6DResponseMetrics
+{
+public:
+	// Start a new run, the target stops moving at the hold time
+	void Begin(float InHoldTime, float InDuration);
+
+	// Add the errors after the step (location in cm, rotation vector in deg) and the outputs that produced them
+	void Add(float InTime, float InDeltaTime, const FVector& InLocError, const FVector& InRotError,
+		const FVector& InLocOutput, const FVector& InRotOutput);
+
+	// Compute the metrics of the run
+	void End();
+
+	// True if any error was not finite or too large
+	bool HasDiverged() const { return bDiverged; };
+
+public:
+	// Location metrics (cm)
+	FMC6DAxisMetrics Loc;
+
+	// Rotation metrics (deg)
+	FMC6DAxisMetrics Rot;
+
+	// Settling band relative to the error when the target stopped
+	constexpr static float SettlingBand = 0.02f;
+
+	// Lower bounds of the settling band (cm, deg)
+	constexpr static float MinLocSettlingBand = 0.1f;
+	constexpr static float MinRotSettlingBand = 0.5f;
+
+	// Time window at the end of the run used for the steady state error (s)
+	constexpr static float SteadyStateWindow = 0.2f;
+
+	// Location error (cm) from which the run is considered unstable
+	constexpr static float DivergenceLimit = 10000.f;
+
+private:
+	// Running values of an axis group
+	struct FAccumulator
+	{
+		float SumSq = 0.f;
+		int32 Num = 0;
+		float SteadySum = 0.f;
+		int32 SteadyNum = 0;
+		bool bHolding = false;
+		FVector ApproachDir = FVector::ZeroVector;
+		float HoldError = 0.f;
+		float Band = 0.f;
+		float Time90 = -1.f;
+		float Time10 = -1.f;
+		float LastOutsideTime = 0.f;
+	};
+
+	// Add the sample to the axis group
+	void Add(FAccumulator& Acc, FMC6DAxisMetrics& Metrics, float InMinBand,
+		float InTime, float InDeltaTime, const FVector& InError, const FVector& InOutput);
+
+	// Compute the metrics of the axis group
+	void End(const FAccumulator& Acc, FMC6DAxisMetrics& Metrics) const;
+
+private:
+	// Time the target stops moving
+	float HoldTime = 0.f;
+
+	// Run duration
+	float Duration = 0.f;
+
+	// Accumulators
+	FAccumulator LocAcc;
+	FAccumulator RotAcc;
+
+	// Non finite or too large errors
+	bool bDiverged = false;
+};
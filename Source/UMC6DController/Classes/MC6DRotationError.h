@@ -0,0 +1,73 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Rotation error type
+*	QuatVector - vector part of the delta quaternion, sin(angle/2) * axis (saturates for large errors)
+*	LogMap - rotation vector of the delta quaternion, angle * axis (linear in the angle up to 180 degrees)
+*/
+UENUM()
+enum class EMC6DRotationErrorType : uint8
+{
+	QuatVector				UMETA(DisplayName = "Quaternion Vector"),
+	LogMap					UMETA(DisplayName = "Log Map (Rotation Vector)"),
+};
+
+/**
+* Frame in which the rotation error is expressed and the rotation PID operates
+*	World - world axes
+*	Body - axes of the controlled body (the output is rotated back to world before being applied)
+*/
+UENUM()
+enum class EMC6DRotationFrame : uint8
+{
+	World					UMETA(DisplayName = "World"),
+	Body					UMETA(DisplayName = "Body"),
+};
+
+/**
+* Rotation error helpers shared by the 6D controllers
+*/
+struct FMC6DRotationError
+{
+	// Vector part of the shortest arc delta quaternion
+	static FORCEINLINE FVector QuatVector(const FQuat& InDelta)
+	{
+		// Avoid taking the long path around the sphere
+		const float Sign = InDelta.W < 0.f ? -1.f : 1.f;
+		return FVector(InDelta.X, InDelta.Y, InDelta.Z) * Sign;
+	}
+
+	// Rotation vector (angle * axis) of the shortest arc delta quaternion
+	static FORCEINLINE FVector LogMap(const FQuat& InDelta)
+	{
+		const float Sign = InDelta.W < 0.f ? -1.f : 1.f;
+		const FVector V = FVector(InDelta.X, InDelta.Y, InDelta.Z) * Sign;
+		const float W = InDelta.W * Sign;
+		const float SinHalfAngle = V.Size();
+
+		// angle / sin(angle/2) = 2 * atan2(s, w) / s, approaches 2 / w for small angles (no division by zero)
+		const float Scale = SinHalfAngle > KINDA_SMALL_NUMBER
+			? 2.f * FMath::Atan2(SinHalfAngle, W) / SinHalfAngle
+			: 2.f / FMath::Max(W, KINDA_SMALL_NUMBER);
+		return V * Scale;
+	}
+
+	// Get the rotation error from the current to the target rotation in the selected type and frame
+	static FORCEINLINE FVector Get(const FQuat& From, const FQuat& To, EMC6DRotationErrorType InType, EMC6DRotationFrame InFrame)
+	{
+		const FQuat DeltaQuat = To * From.Inverse();
+		const FVector Error = InType == EMC6DRotationErrorType::LogMap ? LogMap(DeltaQuat) : QuatVector(DeltaQuat);
+		return InFrame == EMC6DRotationFrame::Body ? From.UnrotateVector(Error) : Error;
+	}
+
+	// Get the rotation output in world frame
+	static FORCEINLINE FVector ToWorld(const FQuat& From, const FVector& InOutput, EMC6DRotationFrame InFrame)
+	{
+		return InFrame == EMC6DRotationFrame::Body ? From.RotateVector(InOutput) : InOutput;
+	}
+};
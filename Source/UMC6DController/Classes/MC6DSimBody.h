@@ -0,0 +1,110 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MC6DControlType.h"
+
+/**
+* Static plane the simulated body collides with
+*/
+struct UMC6DCONTROLLER_API FMC6DSimPlane
+{
+	// Unit normal pointing away from the solid side
+	FVector Normal = FVector::UpVector;
+
+	// Signed distance of the plane from the origin along the normal
+	float Distance = 0.f;
+
+	// Ratio of the normal velocity kept after the impact
+	float Restitution = 0.f;
+
+	// Coulomb friction coefficient of the tangential velocity change
+	float Friction = 0.5f;
+
+	// Default constructor (floor at the origin)
+	FMC6DSimPlane() = default;
+
+	// Plane through the point
+	FMC6DSimPlane(const FVector& InNormal, const FVector& InPoint, float InRestitution = 0.f, float InFriction = 0.5f)
+		: Normal(InNormal.GetSafeNormal()), Restitution(InRestitution), Friction(InFriction)
+	{
+		Distance = FVector::DotProduct(Normal, InPoint);
+	}
+};
+
+/**
+* Single rigid body stand-in for running the 6D controllers without a physics scene,
+* semi-implicit Euler with the linear/angular damping of the physics engine and gravity,
+* optionally colliding as a sphere with static planes (only depends on the core math, no world nor physics scene)
+*/
+struct UMC6DCONTROLLER_API FMC6DSimBody
+{
+public:
+	// Default constructor (1 kg, unit inertia, no damping, no gravity, no planes)
+	FMC6DSimBody();
+
+	// Set the body properties, inertia are the principal moments (kg*cm^2) in the body frame
+	void Init(float InMass, const FVector& InInertia, float InLinearDamping = 0.01f, float InAngularDamping = 0.f,
+		const FVector& InGravity = FVector::ZeroVector);
+
+	// Teleport the body and reset its velocities
+	void SetPose(const FTransform& InPose);
+
+	// Get the body pose
+	FTransform GetPose() const { return FTransform(Rotation, Location); };
+
+	// Apply the location controller output as the given control type would (target used by position)
+	void ApplyLocOutput(EMC6DControlType InType, const FVector& InOutput, const FVector& InTarget);
+
+	// Apply the rotation controller output (world frame) as the given control type would (target used by position)
+	void ApplyRotOutput(EMC6DControlType InType, const FVector& InOutput, const FQuat& InTarget);
+
+	// Integrate the applied outputs over the step
+	void Step(float DeltaTime);
+
+	// Add a static plane to collide with, the body collides as a sphere of the contact radius
+	void AddPlane(const FMC6DSimPlane& InPlane) { Planes.Add(InPlane); };
+
+	// Remove all the planes
+	void ClearPlanes() { Planes.Empty(); bInContact = false; };
+
+	// True if the body touched a plane in the last step
+	bool IsInContact() const { return bInContact; };
+
+private:
+	// Convert a world torque to a world angular acceleration
+	FVector GetAngularAcceleration(const FVector& InTorque) const;
+
+	// Push the body out of the planes and remove the velocity into them
+	void ResolveContacts();
+
+public:
+	// State
+	FVector Location;
+	FQuat Rotation;
+	FVector LinearVelocity;
+	FVector AngularVelocity;
+
+	// Properties
+	float Mass;
+	FVector Inertia;
+	float LinearDamping;
+	float AngularDamping;
+	FVector Gravity;
+
+	// Radius of the contact sphere (cm)
+	float ContactRadius;
+
+private:
+	// Static planes
+	TArray<FMC6DSimPlane> Planes;
+
+	// Touched a plane in the last step
+	bool bInContact;
+
+	// Accelerations accumulated until the next step
+	FVector LinearAcceleration;
+	FVector AngularAcceleration;
+};
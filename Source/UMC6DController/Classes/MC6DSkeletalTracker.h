@@ -0,0 +1,168 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "EngineMinimal.h"
+#include "MCPIDControllerBatch3D.h"
+#include "MC6DControlType.h"
+#include "MC6DRotationError.h"
+#include "MC6DBoneGainsDataAsset.h"
+#include "MC6DPhysicsCommands.h"
+#include "MC6DSkeletalTracker.generated.h"
+
+// Forward declarations
+class USkeletalMeshComponent;
+class UPhysicsAsset;
+struct FBodyInstance;
+
+/**
+ * Moves every physics body of the skeletal mesh towards the same named bone of a target pose,
+ * each body has its own location and rotation PID, bodies sharing the same gains are updated as one batch
+ */
+USTRUCT(/*BlueprintType*/)
+struct FMC6DSkeletalTracker
+{
+	GENERATED_BODY()
+
+public:
+	// Default constructor
+	FMC6DSkeletalTracker();
+
+	// Init the tracked bodies, the gains come from the data asset (if set) or the default gains, return the number of tracked bodies
+	int32 Init(USkeletalMeshComponent* InSelfAsSkeletalMesh,
+		USkeletalMeshComponent* InTargetPose,
+		EMC6DControlType InLocControlType,
+		EMC6DControlType InRotControlType,
+		const FMC6DGains& InDefaultGains,
+		const UMC6DBoneGainsDataAsset* InBoneGains = nullptr);
+
+	// Remove the tracked bodies
+	void Clear();
+
+	// Set the rotation error type and the frame of the rotation controllers
+	void SetRotationError(EMC6DRotationErrorType InType, EMC6DRotationFrame InFrame);
+
+	// Set the time step range and non finite error handling of the PID batches
+	void SetPIDGuard(const FMCPIDGuard& InGuard);
+
+	// Sum of the guard counters of all the PID batches
+	FMCPIDGuardCounters GetGuardCounters() const;
+
+	// Compute the errors of all bodies, update the PID batches, and apply the outputs
+	void Update(float DeltaTime);
+
+	// Number of tracked bodies
+	int32 Num() const { return BodyIndices.Num(); }
+
+private:
+	// Bodies sharing the same gains
+	struct FGainGroup
+	{
+		// Tracked bodies (indices in the tracker arrays)
+		TArray<int32> Members;
+
+		// Location controllers
+		FMCPIDControllerBatch3D PIDLoc;
+
+		// Rotation controllers
+		FMCPIDControllerBatch3D PIDRot;
+
+		// Location errors / outputs, indexed as the members
+		TArray<FVector> LocErrors;
+		TArray<FVector> LocOutputs;
+
+		// Rotation errors / outputs, indexed as the members
+		TArray<FVector> RotErrors;
+		TArray<FVector> RotOutputs;
+	};
+
+	// Get the group index of the gains, add a new group if needed
+	int32 FindOrAddGroup(const FMC6DGains& InGains);
+
+	// True if the tracked body indices still match the bodies of the mesh (its physics state can be recreated)
+	bool HasValidBodies() const;
+
+	/* Output function bindings */
+	// Function pointer type for applying the output to a body
+	typedef void(FMC6DSkeletalTracker::*ApplyFunctionPointerType)(FBodyInstance*, const FVector&, const FTransform&);
+
+	// Function pointer for the location output
+	ApplyFunctionPointerType LocApplyFunctionPointer;
+
+	// Function pointer for the rotation output
+	ApplyFunctionPointerType RotApplyFunctionPointer;
+
+	// Bind the apply function of the control type
+	static ApplyFunctionPointerType GetLocApplyFunction(EMC6DControlType InControlType);
+	static ApplyFunctionPointerType GetRotApplyFunction(EMC6DControlType InControlType);
+
+	// Loc
+	void Loc_Apply_NONE(FBodyInstance* BI, const FVector& Out, const FTransform& Target) {};
+	void Loc_Apply_Position(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Loc_Apply_Velocity(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Loc_Apply_Acceleration(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Loc_Apply_Force(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Loc_Apply_Impulse(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+
+	// Rot
+	void Rot_Apply_NONE(FBodyInstance* BI, const FVector& Out, const FTransform& Target) {};
+	void Rot_Apply_Position(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Rot_Apply_Velocity(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Rot_Apply_Acceleration(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Rot_Apply_Force(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+	void Rot_Apply_Impulse(FBodyInstance* BI, const FVector& Out, const FTransform& Target);
+
+private:
+	// Skeletal mesh to move
+	USkeletalMeshComponent* SelfAsSkeletalMeshComp;
+
+	// Skeletal mesh with the target pose
+	USkeletalMeshComponent* TargetPoseComp;
+
+	// Body indices in the self skeletal mesh
+	TArray<int32> BodyIndices;
+
+	// Same named bone indices in the target pose
+	TArray<int32> TargetBoneIndices;
+
+	// Target bone transforms of the current update
+	TArray<FTransform> TargetTransforms;
+
+	// Body rotations of the current update (to express the body frame outputs in world)
+	TArray<FQuat> BodyRotations;
+
+	// Rotation error type
+	EMC6DRotationErrorType RotErrorType;
+
+	// Frame of the rotation errors and controllers
+	EMC6DRotationFrame RotErrorFrame;
+
+	// Time step range and non finite error handling of the PID batches
+	FMCPIDGuard Guard;
+
+	// Gain groups
+	TArray<FGainGroup> Groups;
+
+	// Gains of each group
+	TArray<FMC6DGains> GroupGains;
+
+	// Guard counters of the groups removed by a re-init
+	FMCPIDGuardCounters ReinitGuardCounters;
+
+	// Physics writes list of the world (shared by all the controllers, submitted before the physics step)
+	FMC6DPhysicsCommandList* Commands;
+
+	/* Init parameters, used to re-init on physics state changes */
+	// Number of bodies and physics asset of the mesh when initialized
+	int32 NumMeshBodies;
+	TWeakObjectPtr<UPhysicsAsset> MeshPhysicsAsset;
+
+	// Control types
+	EMC6DControlType InitLocControlType;
+	EMC6DControlType InitRotControlType;
+
+	// Gains
+	FMC6DGains InitDefaultGains;
+	TWeakObjectPtr<const UMC6DBoneGainsDataAsset> InitBoneGains;
+};
@@ -0,0 +1,54 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Target pose trajectory for replaying the 6D controllers offline,
+* keyframes are linearly (location) and spherically (rotation) interpolated
+*/
+struct UMC6DCONTROLLER_API FMC6DTrajectory
+{
+public:
+	// Name used in the logs
+	FString Name;
+
+	// Keyframe times (s), ascending
+	TArray<float> Times;
+
+	// Keyframe poses
+	TArray<FTransform> Poses;
+
+	// Add a keyframe (the time has to be larger than the last one)
+	void Add(float InTime, const FTransform& InPose);
+
+	// Get the interpolated pose at the given time (clamped to the trajectory duration)
+	FTransform Sample(float InTime) const;
+
+	// Duration of the trajectory (s)
+	float GetDuration() const { return Times.Num() > 0 ? Times.Last() : 0.f; };
+
+	// Time from which the target does not move anymore (duration if it never holds)
+	float GetHoldTime() const;
+
+	// True if there are no keyframes
+	bool IsEmpty() const { return Times.Num() == 0; };
+
+	// Step of the location (cm) and rotation (deg) at the given time, held for the duration
+	static FMC6DTrajectory MakeStep(const FVector& InLocStep, const FRotator& InRotStep, float InStepTime = 0.1f, float InDuration = 2.f);
+
+	// Constant speed move of the location (cm) and rotation (deg) over the ramp time, held for the duration
+	static FMC6DTrajectory MakeRamp(const FVector& InLocDelta, const FRotator& InRotDelta, float InStartTime = 0.1f, float InRampTime = 0.5f, float InDuration = 2.f);
+
+	// Sine along the location axis and around the rotation axis
+	static FMC6DTrajectory MakeSine(const FVector& InLocAmplitude, const FRotator& InRotAmplitude, float InFrequency, float InDuration, float InSampleRate = 120.f);
+
+	// Sine with a frequency increasing linearly from the start to the end frequency (chirp), ends held at the center
+	static FMC6DTrajectory MakeSineSweep(const FVector& InLocAmplitude, const FRotator& InRotAmplitude, float InStartFrequency, float InEndFrequency,
+		float InDuration, float InHoldDuration = 1.f, float InSampleRate = 120.f);
+
+	// Load a recorded trajectory from a csv file (time,x,y,z,qx,qy,qz,qw per line, '#' comments)
+	static bool LoadFromFile(const FString& InPath, FMC6DTrajectory& OutTrajectory);
+};
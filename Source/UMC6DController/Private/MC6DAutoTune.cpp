@@ -0,0 +1,127 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DAutoTune.h"
+
+// Start the measurement
+bool FMC6DAutoTune::Start(float InMaxOut)
+{
+	Amplitude = RelayRatio * InMaxOut;
+	Elapsed = 0.f;
+	UltimateGain = 0.f;
+	UltimatePeriod = 0.f;
+	for (FMC6DRelayAxis& Axis : Axes)
+	{
+		Axis = FMC6DRelayAxis();
+	}
+	State = Amplitude > 0.f && RelayBand > 0.f ? EMC6DAutoTuneState::Running : EMC6DAutoTuneState::Failed;
+	return State == EMC6DAutoTuneState::Running;
+}
+
+// Measure the oscillation of the error
+EMC6DAutoTuneState FMC6DAutoTune::Update(const FVector& InError, float InDeltaTime)
+{
+	if (State != EMC6DAutoTuneState::Running)
+	{
+		return State;
+	}
+	Elapsed += InDeltaTime;
+
+	bool bAllDone = true;
+	for (int32 AxisIdx = 0; AxisIdx < 3; ++AxisIdx)
+	{
+		FMC6DRelayAxis& Axis = Axes[AxisIdx];
+		if (Axis.NumHalfPeriods >= 2 * NumCycles)
+		{
+			continue;
+		}
+		bAllDone = false;
+
+		const float Error = InError[AxisIdx];
+		Axis.Peak = FMath::Max(Axis.Peak, FMath::Abs(Error));
+
+		// Crossing of the error band (hysteresis)
+		const int32 Side = Error > RelayBand ? 1 : (Error < -RelayBand ? -1 : Axis.Side);
+		if (Side != Axis.Side)
+		{
+			if (Axis.NumCrossings >= NumSkippedCrossings)
+			{
+				Axis.HalfPeriodSum += Elapsed - Axis.LastCrossingTime;
+				Axis.PeakSum += Axis.Peak;
+				Axis.NumHalfPeriods++;
+			}
+			Axis.Side = Side;
+			Axis.NumCrossings++;
+			Axis.LastCrossingTime = Elapsed;
+			Axis.Peak = 0.f;
+		}
+	}
+
+	if (bAllDone || Elapsed > Timeout)
+	{
+		State = ComputeResult() ? EMC6DAutoTuneState::Succeeded : EMC6DAutoTuneState::Failed;
+	}
+	return State;
+}
+
+// Get the PID values of the measurement
+bool FMC6DAutoTune::GetGains(float& OutP, float& OutI, float& OutD) const
+{
+	if (State != EMC6DAutoTuneState::Succeeded)
+	{
+		return false;
+	}
+
+	// Proportional gain, integral and derivative times
+	float Ti;
+	float Td;
+	if (Rule == EMC6DAutoTuneRule::ZieglerNichols)
+	{
+		OutP = 0.6f * UltimateGain;
+		Ti = 0.5f * UltimatePeriod;
+		Td = 0.125f * UltimatePeriod;
+	}
+	else
+	{
+		OutP = UltimateGain / 2.2f;
+		Ti = 2.2f * UltimatePeriod;
+		Td = UltimatePeriod / 6.3f;
+	}
+	OutI = OutP / Ti;
+	OutD = OutP * Td;
+	return true;
+}
+
+// Compute the ultimate gain and period from the measured axes
+bool FMC6DAutoTune::ComputeResult()
+{
+	// The axis group shares the PID values, use the most sensitive (lowest ultimate gain) fully measured axis
+	UltimateGain = BIG_NUMBER;
+	for (const FMC6DRelayAxis& Axis : Axes)
+	{
+		if (Axis.NumHalfPeriods < 2 * NumCycles || Axis.PeakSum <= 0.f)
+		{
+			continue;
+		}
+		// Describing function of the relay with hysteresis, the oscillation has to exceed the band
+		const float Peak = Axis.PeakSum / Axis.NumHalfPeriods;
+		if (Peak <= RelayBand)
+		{
+			continue;
+		}
+		const float Gain = 4.f * Amplitude / (PI * FMath::Sqrt(FMath::Square(Peak) - FMath::Square(RelayBand)));
+		if (Gain < UltimateGain)
+		{
+			UltimateGain = Gain;
+			UltimatePeriod = 2.f * Axis.HalfPeriodSum / Axis.NumHalfPeriods;
+		}
+	}
+
+	if (UltimateGain == BIG_NUMBER || UltimatePeriod <= 0.f)
+	{
+		UltimateGain = 0.f;
+		UltimatePeriod = 0.f;
+		return false;
+	}
+	return true;
+}
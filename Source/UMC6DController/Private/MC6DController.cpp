@@ -10,6 +10,20 @@ FMC6DController::FMC6DController()
 {
 	bOverwriteTargetLocation = false;
 	bApplyToAllChildBodies = false;
+	RotErrorType = EMC6DRotationErrorType::QuatVector;
+	RotErrorFrame = EMC6DRotationFrame::World;
+	RotMeasurement = FVector::ZeroVector;
+	PrevSelfQuat = FQuat::Identity;
+	bHasPrevSelfQuat = false;
+	bComputedTorque = false;
+	bCompensateGravity = false;
+	CachedBodyInstance = nullptr;
+	bLocStablePD = false;
+	bRotStablePD = false;
+	StablePDLocError = FVector::ZeroVector;
+	StablePDRotError = FVector::ZeroVector;
+	TargetSceneComp = nullptr;
+	Commands = nullptr;
 	LocUpdateFunctionPointer = &FMC6DController::Loc_Update_NONE;
 	RotUpdateFunctionPointer = &FMC6DController::Rot_Update_NONE;
 }
@@ -31,6 +45,10 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	// Init pid controllers
 	PIDLoc.Init(PLoc, ILoc, DLoc, MaxLoc);
 	PIDRot.Init(PRot, IRot, DRot, MaxRot);
+	bLocStablePD = LocControlType == EMC6DControlType::StablePD;
+	bRotStablePD = RotControlType == EMC6DControlType::StablePD;
+	StablePDLocError = FVector::ZeroVector;
+	StablePDRotError = FVector::ZeroVector;
 
 	// Bind update function depending on the control type
 	switch (LocControlType)
@@ -50,6 +68,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Skel_Impulse;
 		break;
+	case EMC6DControlType::StablePD:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Skel_StablePD;
+		break;
+	case EMC6DControlType::Spring:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Skel_Spring;
+		break;
 	default:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_NONE;
 		break;
@@ -73,6 +97,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Skel_Impulse;
 		break;
+	case EMC6DControlType::StablePD:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Skel_StablePD;
+		break;
+	case EMC6DControlType::Spring:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Skel_Spring;
+		break;
 	default:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_NONE;
 		break;
@@ -100,6 +130,10 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	// Init pid controllers
 	PIDLoc.Init(PLoc, ILoc, DLoc, MaxLoc);
 	PIDRot.Init(PRot, IRot, DRot, MaxRot);
+	bLocStablePD = LocControlType == EMC6DControlType::StablePD;
+	bRotStablePD = RotControlType == EMC6DControlType::StablePD;
+	StablePDLocError = FVector::ZeroVector;
+	StablePDRotError = FVector::ZeroVector;
 
 	// Bind update function depending on the control type
 	switch (LocControlType)
@@ -119,6 +153,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Skel_Impulse_Offset;
 		break;
+	case EMC6DControlType::StablePD:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Skel_StablePD_Offset;
+		break;
+	case EMC6DControlType::Spring:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Skel_Spring_Offset;
+		break;
 	default:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_NONE;
 		break;
@@ -141,6 +181,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Skel_Impulse_Offset;
 		break;
+	case EMC6DControlType::StablePD:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Skel_StablePD_Offset;
+		break;
+	case EMC6DControlType::Spring:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Skel_Spring_Offset;
+		break;
 	default:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_NONE;
 		break;
@@ -162,6 +208,10 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	// Init pid controllers
 	PIDLoc.Init(PLoc, ILoc, DLoc, MaxLoc);
 	PIDRot.Init(PRot, IRot, DRot, MaxRot);
+	bLocStablePD = LocControlType == EMC6DControlType::StablePD;
+	bRotStablePD = RotControlType == EMC6DControlType::StablePD;
+	StablePDLocError = FVector::ZeroVector;
+	StablePDRotError = FVector::ZeroVector;
 
 	// Bind update function depending on the control type
 	switch (LocControlType)
@@ -181,6 +231,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Static_Impulse;
 		break;
+	case EMC6DControlType::StablePD:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Static_StablePD;
+		break;
+	case EMC6DControlType::Spring:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Static_Spring;
+		break;
 	default:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_NONE;
 		break;
@@ -203,6 +259,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Static_Impulse;
 		break;
+	case EMC6DControlType::StablePD:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Static_StablePD;
+		break;
+	case EMC6DControlType::Spring:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Static_Spring;
+		break;
 	default:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_NONE;
 		break;
@@ -228,6 +290,10 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	// Init pid controllers
 	PIDLoc.Init(PLoc, ILoc, DLoc, MaxLoc);
 	PIDRot.Init(PRot, IRot, DRot, MaxRot);
+	bLocStablePD = LocControlType == EMC6DControlType::StablePD;
+	bRotStablePD = RotControlType == EMC6DControlType::StablePD;
+	StablePDLocError = FVector::ZeroVector;
+	StablePDRotError = FVector::ZeroVector;
 
 	// Bind update function depending on the control type
 	switch (LocControlType)
@@ -247,6 +313,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Static_Impulse_Offset;
 		break;
+	case EMC6DControlType::StablePD:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Static_StablePD_Offset;
+		break;
+	case EMC6DControlType::Spring:
+		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_Static_Spring_Offset;
+		break;
 	default:
 		LocUpdateFunctionPointer = &FMC6DController::Loc_Update_NONE;
 		break;
@@ -269,6 +341,12 @@ void FMC6DController::Init(USceneComponent* InTarget,
 	case EMC6DControlType::Impulse:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Static_Impulse_Offset;
 		break;
+	case EMC6DControlType::StablePD:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Static_StablePD_Offset;
+		break;
+	case EMC6DControlType::Spring:
+		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_Static_Spring_Offset;
+		break;
 	default:
 		RotUpdateFunctionPointer = &FMC6DController::Rot_Update_NONE;
 		break;
@@ -308,9 +386,80 @@ void FMC6DController::ResetRot(float P, float I, float D, float Max, bool bClear
 	PIDRot.Init(P, I, D, Max, bClearErrors);
 }
 
-// Call the update function pointer
+// Replace the location pid controller with a relay (auto tune), until the next ResetLoc
+void FMC6DController::ResetLocAsRelay(float Amplitude, float Band)
+{
+	PIDLoc.InitAsRelay(Amplitude, Band);
+}
+
+// Replace the rotation pid controller with a relay (auto tune), until the next ResetRot
+void FMC6DController::ResetRotAsRelay(float Amplitude, float Band)
+{
+	PIDRot.InitAsRelay(Amplitude, Band);
+}
+
+// Set the rotation error type and the frame of the rotation controller
+void FMC6DController::SetRotationError(EMC6DRotationErrorType InType, EMC6DRotationFrame InFrame, bool bClearErrors /* = true*/)
+{
+	RotErrorType = InType;
+	RotErrorFrame = InFrame;
+
+	// The accumulated errors are not comparable between types and frames
+	if (bClearErrors)
+	{
+		PIDRot.Init();
+	}
+}
+
+// Scale the force control outputs by the body mass and inertia
+void FMC6DController::SetComputedTorque(bool bEnable, bool bInCompensateGravity)
+{
+	bComputedTorque = bEnable;
+	bCompensateGravity = bInCompensateGravity;
+	CachedBodyInstance = nullptr;
+}
+
+// Set the spring controllers parameters (Spring control type)
+void FMC6DController::SetSprings(const FMCSpringController3D& InLocSpring, const FMCSpringController3D& InRotSpring)
+{
+	SpringLoc = InLocSpring;
+	SpringLoc.Init();
+	SpringRot = InRotSpring;
+	SpringRot.Init();
+}
+
+// Set the anti-windup, derivative filtering and slew limiting of the pid controllers
+void FMC6DController::SetPIDSettings(const FMCPIDSettings& InLocSettings, const FMCPIDSettings& InRotSettings, bool bClearErrors /* = true*/)
+{
+	PIDLoc.Settings = InLocSettings;
+	PIDLoc.Init(bClearErrors);
+	PIDRot.Settings = InRotSettings;
+	PIDRot.Init(bClearErrors);
+}
+
+// Set the time step range and non finite error handling of the pid controllers
+void FMC6DController::SetPIDGuard(const FMCPIDGuard& InGuard)
+{
+	PIDLoc.Guard = InGuard;
+	PIDRot.Guard = InGuard;
+}
+
+// Sum of the guard counters of the pid controllers
+FMCPIDGuardCounters FMC6DController::GetGuardCounters() const
+{
+	FMCPIDGuardCounters Counters = PIDLoc.GetGuardCounters();
+	Counters += PIDRot.GetGuardCounters();
+	return Counters;
+}
+
+// Call the update function pointer, the physics writes are recorded into the world list (one scene write lock per frame)
 void FMC6DController::UpdateController(float DeltaTime)
 {
+	Commands = FMC6DPhysicsCommandList::GetWorldList(TargetSceneComp ? TargetSceneComp->GetWorld() : nullptr);
+	if (!Commands)
+	{
+		return;
+	}
 	(this->*LocUpdateFunctionPointer)(DeltaTime);
 	(this->*RotUpdateFunctionPointer)(DeltaTime);
 }
@@ -340,23 +489,119 @@ void FMC6DController::SetRotDebugChartData(const FVector& InRotErr, const FVecto
 }
 #endif // UMC_WITH_CHART
 
-// Get the location delta (error)
+// Get the rotation delta (error) in the selected type and frame
 FORCEINLINE FVector FMC6DController::GetRotationDelta(const FQuat& From, const FQuat& To)
 {
-	// TODO test internal versions as well using FQuat/FRotator SLerp / Lerp
-	// Get the delta between the quaternions
-	FQuat DeltaQuat = To * From.Inverse();
+	return FMC6DRotationError::Get(From, To, RotErrorType, RotErrorFrame);
+}
+
+// Get the rotation PID output in world frame
+FORCEINLINE FVector FMC6DController::GetRotationOutput(const FQuat& From, const FVector& InOutput)
+{
+	return FMC6DRotationError::ToWorld(From, InOutput, RotErrorFrame);
+}
 
-	// Avoid taking the long path around the sphere
-	// // See void FQuat::EnforceShortestArcWith(const FQuat& OtherQuat)
-	//	const float CosTheta = ToQuat | FromQuat;
-	//	if (CosTheta < 0)
-	if (DeltaQuat.W < 0.f)
+// Accumulate the body rotation since the last update in the selected type and frame (rotation PID measurement)
+FORCEINLINE FVector FMC6DController::GetRotationMeasurement(const FQuat& SelfQuat)
+{
+	// With a fixed target the error decreases by the rotation of the body (exact for small errors)
+	if (bHasPrevSelfQuat)
 	{
-		DeltaQuat *= -1.f;
+		RotMeasurement += GetRotationDelta(PrevSelfQuat, SelfQuat);
 	}
-	// The W part of the vector is always ~1.f, not relevant for applying the rotation
-	return FVector(DeltaQuat.X, DeltaQuat.Y, DeltaQuat.Z);
+	PrevSelfQuat = SelfQuat;
+	bHasPrevSelfQuat = true;
+	return RotMeasurement;
+}
+
+// Refresh the cached mass and inertia if the controlled body changed, false if there is no body
+bool FMC6DController::UpdateBodyCache(UPrimitiveComponent* InComp)
+{
+	FBodyInstance* BI = InComp->GetBodyInstance();
+	if (!BI)
+	{
+		return false;
+	}
+
+	// The mass and gravity settings and the welded bodies (e.g. grasp fixation) can change at runtime, they are part of the cache key
+	const float MassOverride = BI->bOverrideMass ? BI->GetMassOverride() : -1.f;
+	const int32 NumWeldedShapes = BI->ShapeToBodiesMap.IsValid() ? BI->ShapeToBodiesMap->Num() : 0;
+	const bool bEnableGravity = BI->bEnableGravity;
+	const float GravityZ = InComp->GetWorld() ? InComp->GetWorld()->GetGravityZ() : 0.f;
+	if (BI != CachedBodyInstance
+		|| BI->MassScale != CachedMassScale
+		|| MassOverride != CachedMassOverride
+		|| NumWeldedShapes != CachedNumWeldedShapes
+		|| bEnableGravity != bCachedEnableGravity
+		|| GravityZ != CachedGravityZ)
+	{
+		CachedBodyInstance = BI;
+		CachedMassScale = BI->MassScale;
+		CachedMassOverride = MassOverride;
+		CachedNumWeldedShapes = NumWeldedShapes;
+		bCachedEnableGravity = bEnableGravity;
+		CachedGravityZ = GravityZ;
+		CachedMass = BI->GetBodyMass();
+		CachedInertia = BI->GetBodyInertiaTensor();
+		CachedMassSpaceLocalQuat = BI->GetMassSpaceLocal().GetRotation();
+		CachedGravity = bCompensateGravity && bEnableGravity
+			? FVector(0.f, 0.f, GravityZ)
+			: FVector(0.f);
+	}
+	return true;
+}
+
+// Get the force producing the acceleration on the cached body (with gravity compensation)
+FVector FMC6DController::GetComputedForce(const FVector& InAcceleration) const
+{
+	return CachedMass * (InAcceleration - CachedGravity);
+}
+
+// Get the torque producing the angular acceleration on the cached body (with the gyroscopic term)
+FVector FMC6DController::GetComputedTorque(const FVector& InAngularAcceleration) const
+{
+	// The inertia tensor is diagonal in the principal axes (mass space) of the body
+	const FQuat MassSpaceQuat = CachedBodyInstance->GetUnrealWorldTransform().GetRotation() * CachedMassSpaceLocalQuat;
+	const FVector AngAcc = MassSpaceQuat.UnrotateVector(InAngularAcceleration);
+	const FVector AngVel = MassSpaceQuat.UnrotateVector(CachedBodyInstance->GetUnrealWorldAngularVelocityInRadians());
+	const FVector Torque = CachedInertia * AngAcc + (AngVel ^ (CachedInertia * AngVel));
+	return MassSpaceQuat.RotateVector(Torque);
+}
+
+// Get the stable (implicit) PD force from the location error, P and D act as stiffness and damping
+FVector FMC6DController::GetStablePDForce(FBodyInstance* BI, const FVector& InError, float DeltaTime)
+{
+	StablePDLocError = InError;
+
+	// The force is computed on the predicted next step state: F = P(e - dt*v) - D(v + dt*a), with a = F/m
+	const float Mass = BI->GetBodyMass();
+	const float Denom = Mass + PIDLoc.D * DeltaTime;
+	if (Denom <= KINDA_SMALL_NUMBER)
+	{
+		return FVector(0.f);
+	}
+	const FVector Vel = BI->GetUnrealWorldVelocity();
+	const FVector Force = (PIDLoc.P * (InError - DeltaTime * Vel) - PIDLoc.D * Vel) * (Mass / Denom);
+	return Force.BoundToCube(PIDLoc.MaxOutAbs);
+}
+
+// Get the stable (implicit) PD torque from the world rotation vector error, P and D act as stiffness and damping
+FVector FMC6DController::GetStablePDTorque(FBodyInstance* BI, const FVector& InError, float DeltaTime)
+{
+	StablePDRotError = InError;
+
+	// The inertia tensor is diagonal in the principal axes (mass space) of the body
+	const FQuat MassSpaceQuat = BI->GetMassSpaceToWorldSpace().GetRotation();
+	const FVector Inertia = BI->GetBodyInertiaTensor();
+	const FVector Denom = Inertia + FVector(PIDRot.D * DeltaTime);
+	if (Denom.GetMin() <= KINDA_SMALL_NUMBER)
+	{
+		return FVector(0.f);
+	}
+	const FVector Error = MassSpaceQuat.UnrotateVector(InError);
+	const FVector AngVel = MassSpaceQuat.UnrotateVector(BI->GetUnrealWorldAngularVelocityInRadians());
+	const FVector Torque = (PIDRot.P * (Error - DeltaTime * AngVel) - PIDRot.D * AngVel) * Inertia / Denom;
+	return MassSpaceQuat.RotateVector(Torque).BoundToCube(PIDRot.MaxOutAbs);
 }
 
 // Default update function
@@ -386,15 +631,16 @@ void FMC6DController::Loc_Update_Skel_Velocity(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
-	const FVector DeltaLoc = TargetLoc - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->SetAllPhysicsLinearVelocity(OutLoc);
+		Commands->SetAllLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->SetPhysicsLinearVelocity(OutLoc);
+		Commands->SetLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
 	}
 
 #if UMC_WITH_CHART
@@ -407,16 +653,17 @@ void FMC6DController::Loc_Update_Skel_Impulse(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
-	const FVector DeltaLoc = TargetLoc - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsSkeletalMeshComp->AddImpulse(OutLoc);
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	Commands->AddImpulse(SelfAsSkeletalMeshComp, OutLoc);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->AddImpulseToAllBodiesBelow(OutLoc);
+		Commands->AddImpulseToAllBodies(SelfAsSkeletalMeshComp, OutLoc);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->AddImpulse(OutLoc);
+		Commands->AddImpulse(SelfAsSkeletalMeshComp, OutLoc);
 	}
 
 #if UMC_WITH_CHART
@@ -429,15 +676,16 @@ void FMC6DController::Loc_Update_Skel_Acceleration(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
-	const FVector DeltaLoc = TargetLoc - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->AddForceToAllBodiesBelow(OutLoc, NAME_None, true);
+		Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc, true);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->AddForce(OutLoc, NAME_None, true); // Acceleration based (mass will have no effect)
+		Commands->AddForce(SelfAsSkeletalMeshComp, OutLoc, true); // Acceleration based (mass will have no effect)
 	}
 
 #if UMC_WITH_CHART
@@ -450,15 +698,77 @@ void FMC6DController::Loc_Update_Skel_Force(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	if (bComputedTorque && UpdateBodyCache(SelfAsSkeletalMeshComp))
+	{
+		// The output is the commanded acceleration
+		if (bApplyToAllChildBodies)
+		{
+			Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc - CachedGravity, true);
+		}
+		else
+		{
+			Commands->AddForce(SelfAsSkeletalMeshComp, GetComputedForce(OutLoc));
+		}
+	}
+	else if (bApplyToAllChildBodies)
+	{
+		Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc);
+	}
+	else
+	{
+		Commands->AddForce(SelfAsSkeletalMeshComp, OutLoc);
+	}
+
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Loc_Update_Skel_StablePD(float DeltaTime)
+{
+	const FVector TargetLoc = bOverwriteTargetLocation
+		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
+		: TargetSceneComp->GetComponentLocation();
+	FBodyInstance* BI = SelfAsSkeletalMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
 	const FVector DeltaLoc = TargetLoc - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
+	const FVector OutLoc = GetStablePDForce(BI, DeltaLoc, DeltaTime);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->AddForceToAllBodiesBelow(OutLoc);
+		// Same acceleration on every body as on the root body
+		Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc / FMath::Max(BI->GetBodyMass(), KINDA_SMALL_NUMBER), true);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->AddForce(OutLoc);
+		Commands->AddForce(SelfAsSkeletalMeshComp, OutLoc);
+	}
+
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Loc_Update_Skel_Spring(float DeltaTime)
+{
+	const FVector TargetLoc = bOverwriteTargetLocation
+		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
+		: TargetSceneComp->GetComponentLocation();
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = SpringLoc.Update(DeltaLoc, DeltaTime);
+	if (bApplyToAllChildBodies)
+	{
+		Commands->SetAllLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
+	}
+	else
+	{
+		Commands->SetLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
 	}
 
 #if UMC_WITH_CHART
@@ -475,9 +785,10 @@ void FMC6DController::Rot_Update_Skel_Position(float DeltaTime)
 
 void FMC6DController::Rot_Update_Skel_Velocity(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->SetPhysicsAngularVelocityInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->SetAngularVelocityInRadians(SelfAsSkeletalMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -486,9 +797,10 @@ void FMC6DController::Rot_Update_Skel_Velocity(float DeltaTime)
 
 void FMC6DController::Rot_Update_Skel_Impulse(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->AddAngularImpulseInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddAngularImpulseInRadians(SelfAsSkeletalMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -497,9 +809,10 @@ void FMC6DController::Rot_Update_Skel_Impulse(float DeltaTime)
 
 void FMC6DController::Rot_Update_Skel_Acceleration(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->AddTorqueInRadians(OutRot, NAME_None, true); // Acceleration based (mass will have no effect)
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, OutRot, true); // Acceleration based (mass will have no effect)
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -508,9 +821,47 @@ void FMC6DController::Rot_Update_Skel_Acceleration(float DeltaTime)
 
 void FMC6DController::Rot_Update_Skel_Force(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->AddTorqueInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	if (bComputedTorque && UpdateBodyCache(SelfAsSkeletalMeshComp))
+	{
+		// The output is the commanded angular acceleration
+		Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, GetComputedTorque(OutRot));
+	}
+	else
+	{
+		Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, OutRot);
+	}
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Skel_StablePD(float DeltaTime)
+{
+	FBodyInstance* BI = SelfAsSkeletalMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, TargetSceneComp->GetComponentQuat(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = GetStablePDTorque(BI, DeltaRotAsVector, DeltaTime);
+	Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, OutRot);
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Skel_Spring(float DeltaTime)
+{
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, TargetSceneComp->GetComponentQuat(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = SpringRot.Update(DeltaRotAsVector, DeltaTime);
+	Commands->SetAngularVelocityInRadians(SelfAsSkeletalMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -552,15 +903,16 @@ void FMC6DController::Loc_Update_Skel_Velocity_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->SetAllPhysicsLinearVelocity(OutLoc);
+		Commands->SetAllLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->SetPhysicsLinearVelocity(OutLoc);
+		Commands->SetLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
 	}
 
 #if UMC_WITH_CHART
@@ -582,15 +934,16 @@ void FMC6DController::Loc_Update_Skel_Impulse_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->AddImpulseToAllBodiesBelow(OutLoc);
+		Commands->AddImpulseToAllBodies(SelfAsSkeletalMeshComp, OutLoc);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->AddImpulse(OutLoc);
+		Commands->AddImpulse(SelfAsSkeletalMeshComp, OutLoc);
 	}
 
 
@@ -613,15 +966,16 @@ void FMC6DController::Loc_Update_Skel_Acceleration_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->AddForceToAllBodiesBelow(OutLoc, NAME_None, true);
+		Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc, true);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->AddForce(OutLoc, NAME_None, true); // Acceleration based (mass will have no effect)
+		Commands->AddForce(SelfAsSkeletalMeshComp, OutLoc, true); // Acceleration based (mass will have no effect)
 	}
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -642,15 +996,95 @@ void FMC6DController::Loc_Update_Skel_Force_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	if (bComputedTorque && UpdateBodyCache(SelfAsSkeletalMeshComp))
+	{
+		// The output is the commanded acceleration
+		if (bApplyToAllChildBodies)
+		{
+			Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc - CachedGravity, true);
+		}
+		else
+		{
+			Commands->AddForce(SelfAsSkeletalMeshComp, GetComputedForce(OutLoc));
+		}
+	}
+	else if (bApplyToAllChildBodies)
+	{
+		Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc);
+	}
+	else
+	{
+		Commands->AddForce(SelfAsSkeletalMeshComp, OutLoc);
+	}
+
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Loc_Update_Skel_StablePD_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	if (bOverwriteTargetLocation)
+	{
+		FTransform BoneTransform(FQuat::Identity, OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName));
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &BoneTransform);
+	}
+	else
+	{
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+	}
+
+	FBodyInstance* BI = SelfAsSkeletalMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
 	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsSkeletalMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
+	const FVector OutLoc = GetStablePDForce(BI, DeltaLoc, DeltaTime);
 	if (bApplyToAllChildBodies)
 	{
-		SelfAsSkeletalMeshComp->AddForceToAllBodiesBelow(OutLoc);
+		// Same acceleration on every body as on the root body
+		Commands->AddForceToAllBodies(SelfAsSkeletalMeshComp, OutLoc / FMath::Max(BI->GetBodyMass(), KINDA_SMALL_NUMBER), true);
 	}
 	else
 	{
-		SelfAsSkeletalMeshComp->AddForce(OutLoc);
+		Commands->AddForce(SelfAsSkeletalMeshComp, OutLoc);
+	}
+
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Loc_Update_Skel_Spring_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	if (bOverwriteTargetLocation)
+	{
+		FTransform BoneTransform(FQuat::Identity, OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName));
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &BoneTransform);
+	}
+	else
+	{
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+	}
+
+	const FVector SelfLoc = SelfAsSkeletalMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = SpringLoc.Update(DeltaLoc, DeltaTime);
+	if (bApplyToAllChildBodies)
+	{
+		Commands->SetAllLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
+	}
+	else
+	{
+		Commands->SetLinearVelocity(SelfAsSkeletalMeshComp, OutLoc);
 	}
 
 #if UMC_WITH_CHART
@@ -675,9 +1109,10 @@ void FMC6DController::Rot_Update_Skel_Velocity_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsSkeletalMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->SetPhysicsAngularVelocityInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->SetAngularVelocityInRadians(SelfAsSkeletalMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -690,9 +1125,10 @@ void FMC6DController::Rot_Update_Skel_Impulse_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsSkeletalMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->AddAngularImpulseInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddAngularImpulseInRadians(SelfAsSkeletalMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -705,9 +1141,10 @@ void FMC6DController::Rot_Update_Skel_Acceleration_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsSkeletalMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->AddTorqueInRadians(OutRot, NAME_None, true); // Acceleration based (mass will have no effect)
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, OutRot, true); // Acceleration based (mass will have no effect)
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -720,9 +1157,55 @@ void FMC6DController::Rot_Update_Skel_Force_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsSkeletalMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsSkeletalMeshComp->AddTorqueInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	if (bComputedTorque && UpdateBodyCache(SelfAsSkeletalMeshComp))
+	{
+		// The output is the commanded angular acceleration
+		Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, GetComputedTorque(OutRot));
+	}
+	else
+	{
+		Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, OutRot);
+	}
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Skel_StablePD_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+
+	FBodyInstance* BI = SelfAsSkeletalMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, CurrentTargetOffset.GetRotation(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = GetStablePDTorque(BI, DeltaRotAsVector, DeltaTime);
+	Commands->AddTorqueInRadians(SelfAsSkeletalMeshComp, OutRot);
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Skel_Spring_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+
+	const FQuat SelfQuat = SelfAsSkeletalMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, CurrentTargetOffset.GetRotation(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = SpringRot.Update(DeltaRotAsVector, DeltaTime);
+	Commands->SetAngularVelocityInRadians(SelfAsSkeletalMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -745,9 +1228,10 @@ void FMC6DController::Loc_Update_Static_Velocity(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
-	const FVector DeltaLoc = TargetLoc - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->SetPhysicsLinearVelocity(OutLoc);
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	Commands->SetLinearVelocity(SelfAsStaticMeshComp, OutLoc);
 	
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -759,9 +1243,10 @@ void FMC6DController::Loc_Update_Static_Impulse(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
-	const FVector DeltaLoc = TargetLoc - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddImpulse(OutLoc);
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	Commands->AddImpulse(SelfAsStaticMeshComp, OutLoc);
 
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -773,9 +1258,10 @@ void FMC6DController::Loc_Update_Static_Acceleration(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
-	const FVector DeltaLoc = TargetLoc - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddForce(OutLoc, NAME_None, true); // Acceleration based (mass will have no effect)
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	Commands->AddForce(SelfAsStaticMeshComp, OutLoc, true); // Acceleration based (mass will have no effect)
 
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -787,15 +1273,58 @@ void FMC6DController::Loc_Update_Static_Force(float DeltaTime)
 	const FVector TargetLoc = bOverwriteTargetLocation
 		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
 		: TargetSceneComp->GetComponentLocation();
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	if (bComputedTorque && UpdateBodyCache(SelfAsStaticMeshComp))
+	{
+		// The output is the commanded acceleration
+		Commands->AddForce(SelfAsStaticMeshComp, GetComputedForce(OutLoc));
+	}
+	else
+	{
+		Commands->AddForce(SelfAsStaticMeshComp, OutLoc);
+	}
+
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Loc_Update_Static_StablePD(float DeltaTime)
+{
+	const FVector TargetLoc = bOverwriteTargetLocation
+		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
+		: TargetSceneComp->GetComponentLocation();
+	FBodyInstance* BI = SelfAsStaticMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
 	const FVector DeltaLoc = TargetLoc - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddForce(OutLoc);
+	const FVector OutLoc = GetStablePDForce(BI, DeltaLoc, DeltaTime);
+	Commands->AddForce(SelfAsStaticMeshComp, OutLoc);
 
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
 #endif // UMC_WITH_CHART
 }
 
+void FMC6DController::Loc_Update_Static_Spring(float DeltaTime)
+{
+	const FVector TargetLoc = bOverwriteTargetLocation
+		? OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName)
+		: TargetSceneComp->GetComponentLocation();
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = TargetLoc - SelfLoc;
+	const FVector OutLoc = SpringLoc.Update(DeltaLoc, DeltaTime);
+	Commands->SetLinearVelocity(SelfAsStaticMeshComp, OutLoc);
+	
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
 // Rot
 void FMC6DController::Rot_Update_Static_Position(float DeltaTime)
 {
@@ -805,9 +1334,10 @@ void FMC6DController::Rot_Update_Static_Position(float DeltaTime)
 
 void FMC6DController::Rot_Update_Static_Velocity(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->SetPhysicsAngularVelocityInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->SetAngularVelocityInRadians(SelfAsStaticMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -816,9 +1346,10 @@ void FMC6DController::Rot_Update_Static_Velocity(float DeltaTime)
 
 void FMC6DController::Rot_Update_Static_Impulse(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddAngularImpulseInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddAngularImpulseInRadians(SelfAsStaticMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -827,9 +1358,10 @@ void FMC6DController::Rot_Update_Static_Impulse(float DeltaTime)
 
 void FMC6DController::Rot_Update_Static_Acceleration(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddTorqueInRadians(OutRot, NAME_None, true); // Acceleration based (mass will have no effect)
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddTorqueInRadians(SelfAsStaticMeshComp, OutRot, true); // Acceleration based (mass will have no effect)
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -838,9 +1370,47 @@ void FMC6DController::Rot_Update_Static_Acceleration(float DeltaTime)
 
 void FMC6DController::Rot_Update_Static_Force(float DeltaTime)
 {
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), TargetSceneComp->GetComponentQuat());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddTorqueInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, TargetSceneComp->GetComponentQuat());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	if (bComputedTorque && UpdateBodyCache(SelfAsStaticMeshComp))
+	{
+		// The output is the commanded angular acceleration
+		Commands->AddTorqueInRadians(SelfAsStaticMeshComp, GetComputedTorque(OutRot));
+	}
+	else
+	{
+		Commands->AddTorqueInRadians(SelfAsStaticMeshComp, OutRot);
+	}
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Static_StablePD(float DeltaTime)
+{
+	FBodyInstance* BI = SelfAsStaticMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, TargetSceneComp->GetComponentQuat(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = GetStablePDTorque(BI, DeltaRotAsVector, DeltaTime);
+	Commands->AddTorqueInRadians(SelfAsStaticMeshComp, OutRot);
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Static_Spring(float DeltaTime)
+{
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, TargetSceneComp->GetComponentQuat(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = SpringRot.Update(DeltaRotAsVector, DeltaTime);
+	Commands->SetAngularVelocityInRadians(SelfAsStaticMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -884,9 +1454,10 @@ void FMC6DController::Loc_Update_Static_Velocity_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->SetPhysicsLinearVelocity(OutLoc);
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	Commands->SetLinearVelocity(SelfAsStaticMeshComp, OutLoc);
 
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -907,9 +1478,10 @@ void FMC6DController::Loc_Update_Static_Impulse_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddImpulse(OutLoc);
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	Commands->AddImpulse(SelfAsStaticMeshComp, OutLoc);
 
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -930,9 +1502,10 @@ void FMC6DController::Loc_Update_Static_Acceleration_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddForce(OutLoc, NAME_None, true); // Acceleration based (mass will have no effect)
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	Commands->AddForce(SelfAsStaticMeshComp, OutLoc, true); // Acceleration based (mass will have no effect)
 
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -953,9 +1526,70 @@ void FMC6DController::Loc_Update_Static_Force_Offset(float DeltaTime)
 		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 	}
 
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = PIDLoc.Update(DeltaLoc, SelfLoc, DeltaTime);
+	if (bComputedTorque && UpdateBodyCache(SelfAsStaticMeshComp))
+	{
+		// The output is the commanded acceleration
+		Commands->AddForce(SelfAsStaticMeshComp, GetComputedForce(OutLoc));
+	}
+	else
+	{
+		Commands->AddForce(SelfAsStaticMeshComp, OutLoc);
+	}
+
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Loc_Update_Static_StablePD_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	if (bOverwriteTargetLocation)
+	{
+		FTransform BoneTransform(FQuat::Identity, OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName));
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &BoneTransform);
+	}
+	else
+	{
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+	}
+
+	FBodyInstance* BI = SelfAsStaticMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
 	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddForce(OutLoc); 
+	const FVector OutLoc = GetStablePDForce(BI, DeltaLoc, DeltaTime);
+	Commands->AddForce(SelfAsStaticMeshComp, OutLoc);
+
+#if UMC_WITH_CHART
+	SetLocDebugChartData(DeltaLoc, OutLoc);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Loc_Update_Static_Spring_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	if (bOverwriteTargetLocation)
+	{
+		FTransform BoneTransform(FQuat::Identity, OverwriteTargetSkMC->GetBoneLocation(OverwriteTargetBoneName));
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &BoneTransform);
+	}
+	else
+	{
+		FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+	}
+
+	const FVector SelfLoc = SelfAsStaticMeshComp->GetComponentLocation();
+	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfLoc;
+	const FVector OutLoc = SpringLoc.Update(DeltaLoc, DeltaTime);
+	Commands->SetLinearVelocity(SelfAsStaticMeshComp, OutLoc);
 
 #if UMC_WITH_CHART
 	SetLocDebugChartData(DeltaLoc, OutLoc);
@@ -980,9 +1614,10 @@ void FMC6DController::Rot_Update_Static_Velocity_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->SetPhysicsAngularVelocityInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->SetAngularVelocityInRadians(SelfAsStaticMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -995,9 +1630,10 @@ void FMC6DController::Rot_Update_Static_Impulse_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddAngularImpulseInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddAngularImpulseInRadians(SelfAsStaticMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -1010,9 +1646,10 @@ void FMC6DController::Rot_Update_Static_Acceleration_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddTorqueInRadians(OutRot, NAME_None, true); // Acceleration based (mass will have no effect)
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	Commands->AddTorqueInRadians(SelfAsStaticMeshComp, OutRot, true); // Acceleration based (mass will have no effect)
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
@@ -1025,9 +1662,55 @@ void FMC6DController::Rot_Update_Static_Force_Offset(float DeltaTime)
 	FTransform CurrentTargetOffset;
 	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
 
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddTorqueInRadians(OutRot);
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = GetRotationDelta(SelfQuat, CurrentTargetOffset.GetRotation());
+	const FVector OutRot = GetRotationOutput(SelfQuat, PIDRot.Update(DeltaRotAsVector, GetRotationMeasurement(SelfQuat), DeltaTime));
+	if (bComputedTorque && UpdateBodyCache(SelfAsStaticMeshComp))
+	{
+		// The output is the commanded angular acceleration
+		Commands->AddTorqueInRadians(SelfAsStaticMeshComp, GetComputedTorque(OutRot));
+	}
+	else
+	{
+		Commands->AddTorqueInRadians(SelfAsStaticMeshComp, OutRot);
+	}
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Static_StablePD_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+
+	FBodyInstance* BI = SelfAsStaticMeshComp->GetBodyInstance();
+	if (!BI)
+	{
+		return;
+	}
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, CurrentTargetOffset.GetRotation(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = GetStablePDTorque(BI, DeltaRotAsVector, DeltaTime);
+	Commands->AddTorqueInRadians(SelfAsStaticMeshComp, OutRot);
+
+#if UMC_WITH_CHART
+	SetRotDebugChartData(DeltaRotAsVector, OutRot);
+#endif // UMC_WITH_CHART
+}
+
+void FMC6DController::Rot_Update_Static_Spring_Offset(float DeltaTime)
+{
+	/* Offset target calculation */
+	FTransform CurrentTargetOffset;
+	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
+
+	const FQuat SelfQuat = SelfAsStaticMeshComp->GetComponentQuat();
+	const FVector DeltaRotAsVector = FMC6DRotationError::Get(SelfQuat, CurrentTargetOffset.GetRotation(), EMC6DRotationErrorType::LogMap, EMC6DRotationFrame::World);
+	const FVector OutRot = SpringRot.Update(DeltaRotAsVector, DeltaTime);
+	Commands->SetAngularVelocityInRadians(SelfAsStaticMeshComp, OutRot);
 
 #if UMC_WITH_CHART
 	SetRotDebugChartData(DeltaRotAsVector, OutRot);
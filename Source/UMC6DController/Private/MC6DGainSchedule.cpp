@@ -0,0 +1,54 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DGainSchedule.h"
+
+// Sample the curves into the lookup table, return false if the schedule is disabled or invalid
+bool FMC6DGainSchedule::Bake()
+{
+	Table.Empty();
+	InvStep = 0.f;
+
+	if (!bEnabled)
+	{
+		return false;
+	}
+
+	if (InputMax <= InputMin || NumSamples < 2)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d invalid schedule range [%f, %f] or number of samples %d, the gains will not be scheduled.."),
+			*FString(__FUNCTION__), __LINE__, InputMin, InputMax, NumSamples);
+		return false;
+	}
+
+	const float Step = (InputMax - InputMin) / (NumSamples - 1);
+	InvStep = 1.f / Step;
+	Table.Reserve(NumSamples);
+	for (int32 Idx = 0; Idx < NumSamples; ++Idx)
+	{
+		const float Time = InputMin + Idx * Step;
+		Table.Emplace(SampleCurve(PScale, Time), SampleCurve(IScale, Time),
+			SampleCurve(DScale, Time), SampleCurve(MaxScale, Time));
+	}
+	return true;
+}
+
+// Get the (P, I, D, Max) multipliers of the input value
+FVector4 FMC6DGainSchedule::Evaluate(float InValue) const
+{
+	const float Pos = FMath::Clamp((InValue - InputMin) * InvStep, 0.f, float(Table.Num() - 1));
+	const int32 Idx = FMath::Min(FMath::FloorToInt(Pos), Table.Num() - 2);
+	const float Alpha = Pos - Idx;
+	return Table[Idx] + (Table[Idx + 1] - Table[Idx]) * Alpha;
+}
+
+// Sample a curve, 1 if it has no keys
+float FMC6DGainSchedule::SampleCurve(const FRuntimeFloatCurve& InCurve, float InTime)
+{
+	const FRichCurve* Curve = InCurve.GetRichCurveConst();
+	if (Curve && Curve->GetNumKeys() > 0)
+	{
+		return FMath::Max(Curve->Eval(InTime), 0.f);
+	}
+	return 1.f;
+}
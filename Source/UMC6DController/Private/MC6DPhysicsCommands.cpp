@@ -0,0 +1,395 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DPhysicsCommands.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "Physics/PhysicsInterfaceCore.h"
+#include "PhysicsPublic.h"
+#include "Engine/World.h"
+
+// Shared list of every physics scene
+TMap<FPhysScene*, TUniquePtr<FMC6DPhysicsCommandList>> FMC6DPhysicsCommandList::SceneLists;
+
+// Teleport the body to the location (combined with a rotation teleport of the same body)
+void FMC6DPhysicsCommandList::SetBodyLocation(FBodyInstance* BI, const FVector& InLocation)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		Command.Location = InLocation;
+		Command.Flags |= HasLocation;
+	}
+}
+
+// Teleport the body to the rotation (combined with a location teleport of the same body)
+void FMC6DPhysicsCommandList::SetBodyRotation(FBodyInstance* BI, const FQuat& InRotation)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		Command.Rotation = InRotation;
+		Command.Flags |= HasRotation;
+	}
+}
+
+// Set the linear velocity of the body
+void FMC6DPhysicsCommandList::SetLinearVelocity(FBodyInstance* BI, const FVector& InVelocity)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		Command.LinearVelocity = InVelocity;
+		Command.Flags |= HasLinearVelocity;
+	}
+}
+
+// Set the linear velocity of the component body
+void FMC6DPhysicsCommandList::SetLinearVelocity(UPrimitiveComponent* InComp, const FVector& InVelocity)
+{
+	SetLinearVelocity(InComp->GetBodyInstance(), InVelocity);
+}
+
+// Set the linear velocity of every body of the skeletal mesh
+void FMC6DPhysicsCommandList::SetAllLinearVelocity(USkeletalMeshComponent* InComp, const FVector& InVelocity)
+{
+	for (FBodyInstance* BI : InComp->Bodies)
+	{
+		SetLinearVelocity(BI, InVelocity);
+	}
+}
+
+// Set the angular velocity (rad/s) of the body
+void FMC6DPhysicsCommandList::SetAngularVelocityInRadians(FBodyInstance* BI, const FVector& InAngVelocity)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		Command.AngularVelocity = InAngVelocity;
+		Command.Flags |= HasAngularVelocity;
+	}
+}
+
+// Set the angular velocity (rad/s) of the component body
+void FMC6DPhysicsCommandList::SetAngularVelocityInRadians(UPrimitiveComponent* InComp, const FVector& InAngVelocity)
+{
+	SetAngularVelocityInRadians(InComp->GetBodyInstance(), InAngVelocity);
+}
+
+// Add a force (or an acceleration) to the body
+void FMC6DPhysicsCommandList::AddForce(FBodyInstance* BI, const FVector& InForce, bool bAccelChange)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		if (bAccelChange)
+		{
+			Command.Acceleration += InForce;
+			Command.Flags |= HasAcceleration;
+		}
+		else
+		{
+			Command.Force += InForce;
+			Command.Flags |= HasForce;
+		}
+	}
+}
+
+// Add a force (or an acceleration) to the component body
+void FMC6DPhysicsCommandList::AddForce(UPrimitiveComponent* InComp, const FVector& InForce, bool bAccelChange)
+{
+	AddForce(InComp->GetBodyInstance(), InForce, bAccelChange);
+}
+
+// Add a force (or an acceleration) to every body of the skeletal mesh
+void FMC6DPhysicsCommandList::AddForceToAllBodies(USkeletalMeshComponent* InComp, const FVector& InForce, bool bAccelChange)
+{
+	for (FBodyInstance* BI : InComp->Bodies)
+	{
+		AddForce(BI, InForce, bAccelChange);
+	}
+}
+
+// Add a torque (or an angular acceleration) in radians to the body
+void FMC6DPhysicsCommandList::AddTorqueInRadians(FBodyInstance* BI, const FVector& InTorque, bool bAccelChange)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		if (bAccelChange)
+		{
+			Command.AngularAcceleration += InTorque;
+			Command.Flags |= HasAngularAcceleration;
+		}
+		else
+		{
+			Command.Torque += InTorque;
+			Command.Flags |= HasTorque;
+		}
+	}
+}
+
+// Add a torque (or an angular acceleration) in radians to the component body
+void FMC6DPhysicsCommandList::AddTorqueInRadians(UPrimitiveComponent* InComp, const FVector& InTorque, bool bAccelChange)
+{
+	AddTorqueInRadians(InComp->GetBodyInstance(), InTorque, bAccelChange);
+}
+
+// Add an impulse (or a velocity change) to the body
+void FMC6DPhysicsCommandList::AddImpulse(FBodyInstance* BI, const FVector& InImpulse, bool bVelChange)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		if (bVelChange)
+		{
+			Command.VelocityChange += InImpulse;
+			Command.Flags |= HasVelocityChange;
+		}
+		else
+		{
+			Command.Impulse += InImpulse;
+			Command.Flags |= HasImpulse;
+		}
+	}
+}
+
+// Add an impulse (or a velocity change) to the component body
+void FMC6DPhysicsCommandList::AddImpulse(UPrimitiveComponent* InComp, const FVector& InImpulse, bool bVelChange)
+{
+	AddImpulse(InComp->GetBodyInstance(), InImpulse, bVelChange);
+}
+
+// Add an impulse (or a velocity change) to every body of the skeletal mesh
+void FMC6DPhysicsCommandList::AddImpulseToAllBodies(USkeletalMeshComponent* InComp, const FVector& InImpulse, bool bVelChange)
+{
+	for (FBodyInstance* BI : InComp->Bodies)
+	{
+		AddImpulse(BI, InImpulse, bVelChange);
+	}
+}
+
+// Add an angular impulse (or an angular velocity change) in radians to the body
+void FMC6DPhysicsCommandList::AddAngularImpulseInRadians(FBodyInstance* BI, const FVector& InImpulse, bool bVelChange)
+{
+	if (BI)
+	{
+		FBodyCommand& Command = FindOrAdd(BI);
+		if (bVelChange)
+		{
+			Command.AngularVelocityChange += InImpulse;
+			Command.Flags |= HasAngularVelocityChange;
+		}
+		else
+		{
+			Command.AngularImpulse += InImpulse;
+			Command.Flags |= HasAngularImpulse;
+		}
+	}
+}
+
+// Add an angular impulse (or an angular velocity change) in radians to the component body
+void FMC6DPhysicsCommandList::AddAngularImpulseInRadians(UPrimitiveComponent* InComp, const FVector& InImpulse, bool bVelChange)
+{
+	AddAngularImpulseInRadians(InComp->GetBodyInstance(), InImpulse, bVelChange);
+}
+
+// Shared list of the world physics scene, submitted before every physics step (game thread only, null without a physics scene)
+FMC6DPhysicsCommandList* FMC6DPhysicsCommandList::GetWorldList(UWorld* InWorld)
+{
+	check(IsInGameThread());
+	FPhysScene* Scene = InWorld ? InWorld->GetPhysicsScene() : nullptr;
+	if (!Scene)
+	{
+		return nullptr;
+	}
+
+	if (TUniquePtr<FMC6DPhysicsCommandList>* List = SceneLists.Find(Scene))
+	{
+		return List->Get();
+	}
+
+	// Remove the lists together with their scenes
+	static FDelegateHandle SceneTermHandle;
+	if (!SceneTermHandle.IsValid())
+	{
+		SceneTermHandle = FPhysicsDelegates::OnPhysSceneTerm.AddStatic(&FMC6DPhysicsCommandList::OnPhysSceneTerm);
+	}
+	Scene->OnPhysScenePreTick.AddStatic(&FMC6DPhysicsCommandList::OnPhysScenePreTick);
+	return SceneLists.Add(Scene, MakeUnique<FMC6DPhysicsCommandList>()).Get();
+}
+
+// Submit the shared list of the scene before its step
+void FMC6DPhysicsCommandList::OnPhysScenePreTick(FPhysScene* InScene, float /*DeltaTime*/)
+{
+	if (TUniquePtr<FMC6DPhysicsCommandList>* List = SceneLists.Find(InScene))
+	{
+		(*List)->Submit();
+	}
+}
+
+// Remove the shared list of the terminated scene
+void FMC6DPhysicsCommandList::OnPhysSceneTerm(FPhysScene* InScene)
+{
+	SceneLists.Remove(InScene);
+}
+
+// Apply the commands (one write lock per physics scene) and clear the list
+void FMC6DPhysicsCommandList::Submit()
+{
+	if (Commands.Num() == 0)
+	{
+		NumRecorded = 0;
+		return;
+	}
+
+	TArray<FPhysScene*, TInlineAllocator<64>> CommandScenes;
+	TArray<FPhysScene*, TInlineAllocator<2>> Scenes;
+	CommandScenes.SetNumUninitialized(Commands.Num());
+	for (int32 Idx = 0; Idx < Commands.Num(); ++Idx)
+	{
+		// The body could have been deleted by a physics state recreation since it was recorded
+		FBodyInstance* BI = Commands[Idx].BI;
+		CommandScenes[Idx] = IsBodyAlive(Commands[Idx]) && BI->IsValidBodyInstance() ? BI->GetPhysicsScene() : nullptr;
+		if (CommandScenes[Idx])
+		{
+			Scenes.AddUnique(CommandScenes[Idx]);
+		}
+	}
+
+	// Usually a single scene, the writes below do not lock again
+	for (FPhysScene* Scene : Scenes)
+	{
+		FPhysicsCommand::ExecuteWrite(Scene, [&]()
+		{
+			for (int32 Idx = 0; Idx < Commands.Num(); ++Idx)
+			{
+				if (CommandScenes[Idx] == Scene)
+				{
+					Apply_AssumesLocked(Scene, Commands[Idx]);
+				}
+			}
+		});
+	}
+
+	Reset();
+}
+
+// Clear the list without applying it (keeps the allocations)
+void FMC6DPhysicsCommandList::Reset()
+{
+	Commands.Reset();
+	CommandIndices.Reset();
+	NumRecorded = 0;
+}
+
+// Get the command of the body, add it if needed
+FMC6DPhysicsCommandList::FBodyCommand& FMC6DPhysicsCommandList::FindOrAdd(FBodyInstance* BI)
+{
+	NumRecorded++;
+
+	// The location and rotation writes of a body usually follow each other
+	if (Commands.Num() > 0 && Commands.Last().BI == BI)
+	{
+		return Commands.Last();
+	}
+	if (const int32* CommandIdx = CommandIndices.Find(BI))
+	{
+		return Commands[*CommandIdx];
+	}
+
+	CommandIndices.Add(BI, Commands.Num());
+	FBodyCommand& Command = Commands.AddZeroed_GetRef();
+	Command.BI = BI;
+	Command.OwnerComp = BI->OwnerComponent;
+	Command.BodyIndex = BI->InstanceBodyIndex;
+	return Command;
+}
+
+// True if the body of the command was not deleted since it was recorded
+bool FMC6DPhysicsCommandList::IsBodyAlive(const FBodyCommand& InCommand)
+{
+	UPrimitiveComponent* OwnerComp = InCommand.OwnerComp.Get();
+	if (!OwnerComp)
+	{
+		return false;
+	}
+
+	// The skeletal bodies are reallocated on every physics state recreation
+	if (USkeletalMeshComponent* SkelComp = Cast<USkeletalMeshComponent>(OwnerComp))
+	{
+		return SkelComp->Bodies.IsValidIndex(InCommand.BodyIndex) && SkelComp->Bodies[InCommand.BodyIndex] == InCommand.BI;
+	}
+	return OwnerComp->GetBodyInstance() == InCommand.BI;
+}
+
+// Apply the writes of the body, the teleport and velocities are set before the forces and impulses are added (the scene write lock must be held)
+void FMC6DPhysicsCommandList::Apply_AssumesLocked(FPhysScene* InScene, const FBodyCommand& InCommand)
+{
+	FBodyInstance* BI = InCommand.BI;
+	const FPhysicsActorHandle& Actor = BI->ActorHandle;
+	if (!FPhysicsInterface::IsRigidBody(Actor) || FPhysicsInterface::IsKinematic_AssumesLocked(Actor))
+	{
+		return;
+	}
+
+	const uint16 Flags = InCommand.Flags;
+	if (Flags & (HasLocation | HasRotation))
+	{
+		// A single teleport for the location and the rotation
+		FTransform Pose = FPhysicsInterface::GetGlobalPose_AssumesLocked(Actor);
+		if (Flags & HasLocation)
+		{
+			Pose.SetLocation(InCommand.Location);
+		}
+		if (Flags & HasRotation)
+		{
+			Pose.SetRotation(InCommand.Rotation);
+		}
+		FPhysicsInterface::SetGlobalPose_AssumesLocked(Actor, Pose);
+	}
+	if (Flags & HasLinearVelocity)
+	{
+		FPhysicsInterface::SetLinearVelocity_AssumesLocked(Actor, InCommand.LinearVelocity);
+	}
+	if (Flags & HasAngularVelocity)
+	{
+		FPhysicsInterface::SetAngularVelocity_AssumesLocked(Actor, InCommand.AngularVelocity);
+	}
+
+	// Forces and torques go through the scene to keep the substepping
+	if (Flags & HasForce)
+	{
+		InScene->AddForce_AssumesLocked(BI, InCommand.Force, true, false);
+	}
+	if (Flags & HasAcceleration)
+	{
+		InScene->AddForce_AssumesLocked(BI, InCommand.Acceleration, true, true);
+	}
+	if (Flags & HasTorque)
+	{
+		InScene->AddTorque_AssumesLocked(BI, InCommand.Torque, true, false);
+	}
+	if (Flags & HasAngularAcceleration)
+	{
+		InScene->AddTorque_AssumesLocked(BI, InCommand.AngularAcceleration, true, true);
+	}
+
+	if (Flags & HasImpulse)
+	{
+		FPhysicsInterface::AddImpulse_AssumesLocked(Actor, InCommand.Impulse);
+	}
+	if (Flags & HasVelocityChange)
+	{
+		FPhysicsInterface::AddVelocity_AssumesLocked(Actor, InCommand.VelocityChange);
+	}
+	if (Flags & HasAngularImpulse)
+	{
+		FPhysicsInterface::AddAngularImpulseInRadians_AssumesLocked(Actor, InCommand.AngularImpulse);
+	}
+	if (Flags & HasAngularVelocityChange)
+	{
+		FPhysicsInterface::AddAngularVelocityInRadians_AssumesLocked(Actor, InCommand.AngularVelocityChange);
+	}
+}
@@ -0,0 +1,115 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DResponseMetrics.h"
+
+// Start a new run
+void FMC6DResponseMetrics::Begin(float InHoldTime, float InDuration)
+{
+	HoldTime = InHoldTime;
+	Duration = InDuration;
+	LocAcc = FAccumulator();
+	RotAcc = FAccumulator();
+	Loc = FMC6DAxisMetrics();
+	Rot = FMC6DAxisMetrics();
+	bDiverged = false;
+}
+
+// Add the errors after the step and the outputs that produced them
+void FMC6DResponseMetrics::Add(float InTime, float InDeltaTime, const FVector& InLocError, const FVector& InRotError,
+	const FVector& InLocOutput, const FVector& InRotOutput)
+{
+	if (bDiverged)
+	{
+		return;
+	}
+	if (InLocError.ContainsNaN() || InRotError.ContainsNaN() || InLocError.SizeSquared() > FMath::Square(DivergenceLimit))
+	{
+		bDiverged = true;
+		return;
+	}
+	Add(LocAcc, Loc, MinLocSettlingBand, InTime, InDeltaTime, InLocError, InLocOutput);
+	Add(RotAcc, Rot, MinRotSettlingBand, InTime, InDeltaTime, InRotError, InRotOutput);
+}
+
+// Compute the metrics of the run
+void FMC6DResponseMetrics::End()
+{
+	End(LocAcc, Loc);
+	End(RotAcc, Rot);
+}
+
+// Add the sample to the axis group
+void FMC6DResponseMetrics::Add(FAccumulator& Acc, FMC6DAxisMetrics& Metrics, float InMinBand,
+	float InTime, float InDeltaTime, const FVector& InError, const FVector& InOutput)
+{
+	const float Error = InError.Size();
+	Acc.SumSq += Error * Error;
+	Acc.Num++;
+	Metrics.MaxError = FMath::Max(Metrics.MaxError, Error);
+	Metrics.Effort += InOutput.SizeSquared() * InDeltaTime;
+
+	if (InTime >= Duration - SteadyStateWindow)
+	{
+		Acc.SteadySum += Error;
+		Acc.SteadyNum++;
+	}
+
+	if (InTime < HoldTime)
+	{
+		return;
+	}
+
+	// The step metrics are relative to the error when the target stops moving
+	if (!Acc.bHolding)
+	{
+		Acc.bHolding = true;
+		Acc.ApproachDir = InError.GetSafeNormal();
+		Acc.HoldError = Error;
+		Acc.Band = FMath::Max(SettlingBand * Error, InMinBand);
+		Acc.LastOutsideTime = InTime;
+		return;
+	}
+
+	if (Acc.Time90 < 0.f && Error <= 0.9f * Acc.HoldError)
+	{
+		Acc.Time90 = InTime;
+	}
+	if (Acc.Time10 < 0.f && Error <= 0.1f * Acc.HoldError)
+	{
+		Acc.Time10 = InTime;
+	}
+	if (!Acc.ApproachDir.IsZero() && Acc.HoldError > InMinBand)
+	{
+		// Past the target along the approach direction
+		const float Past = -FVector::DotProduct(InError, Acc.ApproachDir);
+		Metrics.Overshoot = FMath::Max(Metrics.Overshoot, Past / Acc.HoldError);
+	}
+	if (Error > Acc.Band)
+	{
+		Acc.LastOutsideTime = InTime;
+	}
+}
+
+// Compute the metrics of the axis group
+void FMC6DResponseMetrics::End(const FAccumulator& Acc, FMC6DAxisMetrics& Metrics) const
+{
+	Metrics.RMSError = Acc.Num > 0 ? FMath::Sqrt(Acc.SumSq / Acc.Num) : 0.f;
+	Metrics.SteadyStateError = Acc.SteadyNum > 0 ? Acc.SteadySum / Acc.SteadyNum : 0.f;
+	if (!Acc.bHolding)
+	{
+		return;
+	}
+
+	const float Remaining = Duration - HoldTime;
+	if (Acc.HoldError <= Acc.Band)
+	{
+		// Already at the target when it stopped
+		Metrics.RiseTime = 0.f;
+	}
+	else
+	{
+		Metrics.RiseTime = Acc.Time10 >= 0.f ? Acc.Time10 - FMath::Max(Acc.Time90, HoldTime) : Remaining;
+	}
+	Metrics.SettlingTime = Acc.LastOutsideTime - HoldTime;
+}
@@ -0,0 +1,155 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DSimBody.h"
+
+// Default constructor
+FMC6DSimBody::FMC6DSimBody()
+{
+	Init(1.f, FVector(1.f), 0.f, 0.f);
+	SetPose(FTransform::Identity);
+	ContactRadius = 5.f;
+}
+
+// Set the body properties
+void FMC6DSimBody::Init(float InMass, const FVector& InInertia, float InLinearDamping, float InAngularDamping, const FVector& InGravity)
+{
+	Mass = FMath::Max(InMass, KINDA_SMALL_NUMBER);
+	Inertia = InInertia.ComponentMax(FVector(KINDA_SMALL_NUMBER));
+	LinearDamping = InLinearDamping;
+	AngularDamping = InAngularDamping;
+	Gravity = InGravity;
+}
+
+// Teleport the body and reset its velocities
+void FMC6DSimBody::SetPose(const FTransform& InPose)
+{
+	Location = InPose.GetLocation();
+	Rotation = InPose.GetRotation();
+	LinearVelocity = FVector::ZeroVector;
+	AngularVelocity = FVector::ZeroVector;
+	LinearAcceleration = FVector::ZeroVector;
+	AngularAcceleration = FVector::ZeroVector;
+	bInContact = false;
+}
+
+// Apply the location controller output as the given control type would
+void FMC6DSimBody::ApplyLocOutput(EMC6DControlType InType, const FVector& InOutput, const FVector& InTarget)
+{
+	switch (InType)
+	{
+	case EMC6DControlType::Position:
+		Location = InTarget;
+		break;
+	case EMC6DControlType::Velocity:
+	case EMC6DControlType::Spring:
+		LinearVelocity = InOutput;
+		break;
+	case EMC6DControlType::Acceleration:
+		LinearAcceleration += InOutput;
+		break;
+	case EMC6DControlType::Force:
+	case EMC6DControlType::StablePD:
+		LinearAcceleration += InOutput / Mass;
+		break;
+	case EMC6DControlType::Impulse:
+		LinearVelocity += InOutput / Mass;
+		break;
+	default:
+		break;
+	}
+}
+
+// Apply the rotation controller output as the given control type would
+void FMC6DSimBody::ApplyRotOutput(EMC6DControlType InType, const FVector& InOutput, const FQuat& InTarget)
+{
+	switch (InType)
+	{
+	case EMC6DControlType::Position:
+		Rotation = InTarget;
+		break;
+	case EMC6DControlType::Velocity:
+	case EMC6DControlType::Spring:
+		AngularVelocity = InOutput;
+		break;
+	case EMC6DControlType::Acceleration:
+		AngularAcceleration += InOutput;
+		break;
+	case EMC6DControlType::Force:
+	case EMC6DControlType::StablePD:
+		AngularAcceleration += GetAngularAcceleration(InOutput);
+		break;
+	case EMC6DControlType::Impulse:
+		AngularVelocity += GetAngularAcceleration(InOutput);
+		break;
+	default:
+		break;
+	}
+}
+
+// Integrate the applied outputs over the step
+void FMC6DSimBody::Step(float DeltaTime)
+{
+	if (DeltaTime <= 0.f)
+	{
+		return;
+	}
+
+	// Velocities first (semi-implicit), damping as in the physics engine
+	LinearVelocity += (LinearAcceleration + Gravity) * DeltaTime;
+	LinearVelocity *= FMath::Max(0.f, 1.f - LinearDamping * DeltaTime);
+	AngularVelocity += AngularAcceleration * DeltaTime;
+	AngularVelocity *= FMath::Max(0.f, 1.f - AngularDamping * DeltaTime);
+
+	// Positions
+	Location += LinearVelocity * DeltaTime;
+	const FQuat Spin(AngularVelocity.X, AngularVelocity.Y, AngularVelocity.Z, 0.f);
+	Rotation = Rotation + (Spin * Rotation) * (0.5f * DeltaTime);
+	Rotation.Normalize();
+
+	LinearAcceleration = FVector::ZeroVector;
+	AngularAcceleration = FVector::ZeroVector;
+
+	if (Planes.Num() > 0)
+	{
+		ResolveContacts();
+	}
+}
+
+// Convert a world torque to a world angular acceleration
+FVector FMC6DSimBody::GetAngularAcceleration(const FVector& InTorque) const
+{
+	return Rotation.RotateVector(Rotation.UnrotateVector(InTorque) / Inertia);
+}
+
+// Push the body out of the planes and remove the velocity into them
+void FMC6DSimBody::ResolveContacts()
+{
+	bInContact = false;
+	for (const FMC6DSimPlane& Plane : Planes)
+	{
+		const float Penetration = ContactRadius - (FVector::DotProduct(Plane.Normal, Location) - Plane.Distance);
+		if (Penetration <= 0.f)
+		{
+			continue;
+		}
+		bInContact = true;
+		Location += Plane.Normal * Penetration;
+
+		const float NormalSpeed = FVector::DotProduct(LinearVelocity, Plane.Normal);
+		if (NormalSpeed >= 0.f)
+		{
+			continue;
+		}
+
+		// Normal impulse (with restitution), the friction impulse is bounded by it
+		const float NormalChange = -(1.f + Plane.Restitution) * NormalSpeed;
+		LinearVelocity += Plane.Normal * NormalChange;
+		const FVector Tangential = LinearVelocity - Plane.Normal * FVector::DotProduct(LinearVelocity, Plane.Normal);
+		const float TangentialSpeed = Tangential.Size();
+		if (TangentialSpeed > KINDA_SMALL_NUMBER)
+		{
+			LinearVelocity -= Tangential * (FMath::Min(TangentialSpeed, Plane.Friction * NormalChange) / TangentialSpeed);
+		}
+	}
+}
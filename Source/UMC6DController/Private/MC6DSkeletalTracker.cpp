@@ -0,0 +1,358 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DSkeletalTracker.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+
+// Default constructor
+FMC6DSkeletalTracker::FMC6DSkeletalTracker()
+{
+	SelfAsSkeletalMeshComp = nullptr;
+	TargetPoseComp = nullptr;
+	Commands = nullptr;
+	RotErrorType = EMC6DRotationErrorType::QuatVector;
+	RotErrorFrame = EMC6DRotationFrame::World;
+	LocApplyFunctionPointer = &FMC6DSkeletalTracker::Loc_Apply_NONE;
+	RotApplyFunctionPointer = &FMC6DSkeletalTracker::Rot_Apply_NONE;
+	NumMeshBodies = 0;
+	InitLocControlType = EMC6DControlType::NONE;
+	InitRotControlType = EMC6DControlType::NONE;
+}
+
+// Init the tracked bodies, the gains come from the data asset (if set) or the default gains, return the number of tracked bodies
+int32 FMC6DSkeletalTracker::Init(USkeletalMeshComponent* InSelfAsSkeletalMesh,
+	USkeletalMeshComponent* InTargetPose,
+	EMC6DControlType InLocControlType,
+	EMC6DControlType InRotControlType,
+	const FMC6DGains& InDefaultGains,
+	const UMC6DBoneGainsDataAsset* InBoneGains)
+{
+	Clear();
+	if (InSelfAsSkeletalMesh == nullptr || InTargetPose == nullptr)
+	{
+		return 0;
+	}
+	SelfAsSkeletalMeshComp = InSelfAsSkeletalMesh;
+	TargetPoseComp = InTargetPose;
+	NumMeshBodies = SelfAsSkeletalMeshComp->Bodies.Num();
+	MeshPhysicsAsset = SelfAsSkeletalMeshComp->GetPhysicsAsset();
+	InitLocControlType = InLocControlType;
+	InitRotControlType = InRotControlType;
+	InitDefaultGains = InDefaultGains;
+	InitBoneGains = InBoneGains;
+
+	// Match the physics bodies with the target pose bones
+	for (int32 BodyIdx = 0; BodyIdx < SelfAsSkeletalMeshComp->Bodies.Num(); ++BodyIdx)
+	{
+		const FBodyInstance* BI = SelfAsSkeletalMeshComp->Bodies[BodyIdx];
+		if (BI == nullptr || BI->BodySetup == nullptr)
+		{
+			continue;
+		}
+
+		const FName BoneName = BI->BodySetup->BoneName;
+		const int32 TargetBoneIdx = TargetPoseComp->GetBoneIndex(BoneName);
+		if (TargetBoneIdx == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d The target pose has no bone named %s, the body is not tracked.."),
+				*FString(__FUNCTION__), __LINE__, *BoneName.ToString());
+			continue;
+		}
+
+		const FMC6DBoneGains* BoneEntry = InBoneGains ? InBoneGains->FindBone(BoneName) : nullptr;
+		if (BoneEntry && BoneEntry->bIgnore)
+		{
+			continue;
+		}
+		const FMC6DGains& Gains = BoneEntry ? BoneEntry->Gains : (InBoneGains ? InBoneGains->DefaultGains : InDefaultGains);
+
+		const int32 TrackedIdx = BodyIndices.Add(BodyIdx);
+		TargetBoneIndices.Add(TargetBoneIdx);
+		const int32 GroupIdx = FindOrAddGroup(Gains);
+		Groups[GroupIdx].Members.Add(TrackedIdx);
+	}
+	TargetTransforms.SetNum(BodyIndices.Num());
+	BodyRotations.SetNum(BodyIndices.Num());
+
+	// Size the batches once
+	for (int32 GroupIdx = 0; GroupIdx < Groups.Num(); ++GroupIdx)
+	{
+		FGainGroup& Group = Groups[GroupIdx];
+		const FMC6DGains& Gains = GroupGains[GroupIdx];
+		const int32 NumMembers = Group.Members.Num();
+		Group.PIDLoc.Init(Gains.PLoc, Gains.ILoc, Gains.DLoc, Gains.MaxLoc, NumMembers);
+		Group.PIDRot.Init(Gains.PRot, Gains.IRot, Gains.DRot, Gains.MaxRot, NumMembers);
+		Group.LocErrors.SetNumZeroed(NumMembers);
+		Group.RotErrors.SetNumZeroed(NumMembers);
+		Group.LocOutputs.SetNumZeroed(NumMembers);
+		Group.RotOutputs.SetNumZeroed(NumMembers);
+	}
+
+	LocApplyFunctionPointer = GetLocApplyFunction(InLocControlType);
+	RotApplyFunctionPointer = GetRotApplyFunction(InRotControlType);
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Tracking %d bodies of %s with %d gain groups.."),
+		*FString(__FUNCTION__), __LINE__, BodyIndices.Num(), *SelfAsSkeletalMeshComp->GetName(), Groups.Num());
+	return BodyIndices.Num();
+}
+
+// Remove the tracked bodies
+void FMC6DSkeletalTracker::Clear()
+{
+	SelfAsSkeletalMeshComp = nullptr;
+	BodyIndices.Reset();
+	TargetBoneIndices.Reset();
+	TargetTransforms.Reset();
+	BodyRotations.Reset();
+	Groups.Reset();
+	GroupGains.Reset();
+	ReinitGuardCounters = FMCPIDGuardCounters();
+	LocApplyFunctionPointer = &FMC6DSkeletalTracker::Loc_Apply_NONE;
+	RotApplyFunctionPointer = &FMC6DSkeletalTracker::Rot_Apply_NONE;
+}
+
+// Set the rotation error type and the frame of the rotation controllers
+void FMC6DSkeletalTracker::SetRotationError(EMC6DRotationErrorType InType, EMC6DRotationFrame InFrame)
+{
+	RotErrorType = InType;
+	RotErrorFrame = InFrame;
+}
+
+// Set the time step range and non finite error handling of the PID batches
+void FMC6DSkeletalTracker::SetPIDGuard(const FMCPIDGuard& InGuard)
+{
+	Guard = InGuard;
+	for (FGainGroup& Group : Groups)
+	{
+		Group.PIDLoc.Guard = Guard;
+		Group.PIDRot.Guard = Guard;
+	}
+}
+
+// Sum of the guard counters of all the PID batches
+FMCPIDGuardCounters FMC6DSkeletalTracker::GetGuardCounters() const
+{
+	FMCPIDGuardCounters Counters = ReinitGuardCounters;
+	for (const FGainGroup& Group : Groups)
+	{
+		Counters += Group.PIDLoc.GetGuardCounters();
+		Counters += Group.PIDRot.GetGuardCounters();
+	}
+	return Counters;
+}
+
+// Compute the errors of all bodies, update the PID batches, and apply the outputs
+void FMC6DSkeletalTracker::Update(float DeltaTime)
+{
+	if (SelfAsSkeletalMeshComp == nullptr)
+	{
+		return;
+	}
+
+	// No physics state (being recreated), keep the tracking until the bodies are back
+	if (SelfAsSkeletalMeshComp->Bodies.Num() == 0)
+	{
+		return;
+	}
+
+	// The mesh physics state was recreated (mesh swap, ragdoll re-init), match the bodies again
+	if (!HasValidBodies())
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d The bodies of %s changed, re-initializing the tracking.."),
+			*FString(__FUNCTION__), __LINE__, *SelfAsSkeletalMeshComp->GetName());
+		const FMCPIDGuardCounters PrevGuardCounters = GetGuardCounters();
+		Init(SelfAsSkeletalMeshComp, TargetPoseComp, InitLocControlType, InitRotControlType, InitDefaultGains, InitBoneGains.Get());
+		ReinitGuardCounters = PrevGuardCounters;
+	}
+	if (BodyIndices.Num() == 0)
+	{
+		return;
+	}
+
+	Commands = FMC6DPhysicsCommandList::GetWorldList(SelfAsSkeletalMeshComp->GetWorld());
+	if (!Commands)
+	{
+		return;
+	}
+
+	// Read the target pose and compute the errors
+	const TArray<FBodyInstance*>& Bodies = SelfAsSkeletalMeshComp->Bodies;
+	for (int32 Idx = 0; Idx < BodyIndices.Num(); ++Idx)
+	{
+		TargetTransforms[Idx] = TargetPoseComp->GetBoneTransform(TargetBoneIndices[Idx]);
+	}
+	for (FGainGroup& Group : Groups)
+	{
+		for (int32 MemberIdx = 0; MemberIdx < Group.Members.Num(); ++MemberIdx)
+		{
+			const int32 Idx = Group.Members[MemberIdx];
+			const FTransform BodyTransform = Bodies[BodyIndices[Idx]]->GetUnrealWorldTransform();
+			BodyRotations[Idx] = BodyTransform.GetRotation();
+			Group.LocErrors[MemberIdx] = TargetTransforms[Idx].GetLocation() - BodyTransform.GetLocation();
+			Group.RotErrors[MemberIdx] = FMC6DRotationError::Get(BodyRotations[Idx], TargetTransforms[Idx].GetRotation(), RotErrorType, RotErrorFrame);
+		}
+
+		// One loop per batch
+		Group.PIDLoc.Update(Group.LocErrors, DeltaTime, Group.LocOutputs);
+		Group.PIDRot.Update(Group.RotErrors, DeltaTime, Group.RotOutputs);
+	}
+
+	// Record the outputs, the world list applies them under a single physics scene write lock
+	for (const FGainGroup& Group : Groups)
+	{
+		for (int32 MemberIdx = 0; MemberIdx < Group.Members.Num(); ++MemberIdx)
+		{
+			const int32 Idx = Group.Members[MemberIdx];
+			FBodyInstance* BI = Bodies[BodyIndices[Idx]];
+			(this->*LocApplyFunctionPointer)(BI, Group.LocOutputs[MemberIdx], TargetTransforms[Idx]);
+			(this->*RotApplyFunctionPointer)(BI,
+				FMC6DRotationError::ToWorld(BodyRotations[Idx], Group.RotOutputs[MemberIdx], RotErrorFrame), TargetTransforms[Idx]);
+		}
+	}
+}
+
+// True if the tracked body indices still match the bodies of the mesh (its physics state can be recreated)
+bool FMC6DSkeletalTracker::HasValidBodies() const
+{
+	const TArray<FBodyInstance*>& Bodies = SelfAsSkeletalMeshComp->Bodies;
+	if (Bodies.Num() != NumMeshBodies || SelfAsSkeletalMeshComp->GetPhysicsAsset() != MeshPhysicsAsset.Get())
+	{
+		return false;
+	}
+	for (const int32 BodyIdx : BodyIndices)
+	{
+		if (!Bodies.IsValidIndex(BodyIdx) || Bodies[BodyIdx] == nullptr)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Get the group index of the gains, add a new group if needed
+int32 FMC6DSkeletalTracker::FindOrAddGroup(const FMC6DGains& InGains)
+{
+	const int32 GroupIdx = GroupGains.IndexOfByKey(InGains);
+	if (GroupIdx != INDEX_NONE)
+	{
+		return GroupIdx;
+	}
+	GroupGains.Add(InGains);
+	const int32 NewGroupIdx = Groups.AddDefaulted();
+	Groups[NewGroupIdx].PIDLoc.Guard = Guard;
+	Groups[NewGroupIdx].PIDRot.Guard = Guard;
+	return NewGroupIdx;
+}
+
+// Bind the apply function of the control type
+FMC6DSkeletalTracker::ApplyFunctionPointerType FMC6DSkeletalTracker::GetLocApplyFunction(EMC6DControlType InControlType)
+{
+	switch (InControlType)
+	{
+	case EMC6DControlType::Position:
+		return &FMC6DSkeletalTracker::Loc_Apply_Position;
+	case EMC6DControlType::Velocity:
+		return &FMC6DSkeletalTracker::Loc_Apply_Velocity;
+	case EMC6DControlType::Acceleration:
+		return &FMC6DSkeletalTracker::Loc_Apply_Acceleration;
+	case EMC6DControlType::Force:
+		return &FMC6DSkeletalTracker::Loc_Apply_Force;
+	case EMC6DControlType::Impulse:
+		return &FMC6DSkeletalTracker::Loc_Apply_Impulse;
+	case EMC6DControlType::StablePD:
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d the stable PD is not supported by the skeletal tracking, using force control.."),
+			*FString(__FUNCTION__), __LINE__);
+		return &FMC6DSkeletalTracker::Loc_Apply_Force;
+	case EMC6DControlType::Spring:
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d the spring is not supported by the skeletal tracking, using velocity control.."),
+			*FString(__FUNCTION__), __LINE__);
+		return &FMC6DSkeletalTracker::Loc_Apply_Velocity;
+	default:
+		return &FMC6DSkeletalTracker::Loc_Apply_NONE;
+	}
+}
+
+FMC6DSkeletalTracker::ApplyFunctionPointerType FMC6DSkeletalTracker::GetRotApplyFunction(EMC6DControlType InControlType)
+{
+	switch (InControlType)
+	{
+	case EMC6DControlType::Position:
+		return &FMC6DSkeletalTracker::Rot_Apply_Position;
+	case EMC6DControlType::Velocity:
+		return &FMC6DSkeletalTracker::Rot_Apply_Velocity;
+	case EMC6DControlType::Acceleration:
+		return &FMC6DSkeletalTracker::Rot_Apply_Acceleration;
+	case EMC6DControlType::Force:
+		return &FMC6DSkeletalTracker::Rot_Apply_Force;
+	case EMC6DControlType::Impulse:
+		return &FMC6DSkeletalTracker::Rot_Apply_Impulse;
+	case EMC6DControlType::StablePD:
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d the stable PD is not supported by the skeletal tracking, using force control.."),
+			*FString(__FUNCTION__), __LINE__);
+		return &FMC6DSkeletalTracker::Rot_Apply_Force;
+	case EMC6DControlType::Spring:
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d the spring is not supported by the skeletal tracking, using velocity control.."),
+			*FString(__FUNCTION__), __LINE__);
+		return &FMC6DSkeletalTracker::Rot_Apply_Velocity;
+	default:
+		return &FMC6DSkeletalTracker::Rot_Apply_NONE;
+	}
+}
+
+/* Output functions */
+// Loc
+void FMC6DSkeletalTracker::Loc_Apply_Position(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	// Combined with the rotation teleport when applied
+	Commands->SetBodyLocation(BI, Target.GetLocation());
+}
+
+void FMC6DSkeletalTracker::Loc_Apply_Velocity(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->SetLinearVelocity(BI, Out);
+}
+
+void FMC6DSkeletalTracker::Loc_Apply_Acceleration(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->AddForce(BI, Out, true); // Acceleration based (mass will have no effect)
+}
+
+void FMC6DSkeletalTracker::Loc_Apply_Force(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->AddForce(BI, Out);
+}
+
+void FMC6DSkeletalTracker::Loc_Apply_Impulse(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->AddImpulse(BI, Out);
+}
+
+// Rot
+void FMC6DSkeletalTracker::Rot_Apply_Position(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	// Combined with the location teleport when applied
+	Commands->SetBodyRotation(BI, Target.GetRotation());
+}
+
+void FMC6DSkeletalTracker::Rot_Apply_Velocity(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->SetAngularVelocityInRadians(BI, Out);
+}
+
+void FMC6DSkeletalTracker::Rot_Apply_Acceleration(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->AddTorqueInRadians(BI, Out, true); // Acceleration based (mass will have no effect)
+}
+
+void FMC6DSkeletalTracker::Rot_Apply_Force(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->AddTorqueInRadians(BI, Out);
+}
+
+void FMC6DSkeletalTracker::Rot_Apply_Impulse(FBodyInstance* BI, const FVector& Out, const FTransform& Target)
+{
+	Commands->AddAngularImpulseInRadians(BI, Out);
+}
@@ -35,6 +35,7 @@ UMC6DTarget::UMC6DTarget()
 	// Default values
 	bUseSkeletalMesh = true;
 	bApplyToAllSkeletalBodies = false;
+	bTrackSkeletalPose = false;
 
 	// PID values (acc)
 	LocControlType = EMC6DControlType::Acceleration;
@@ -48,6 +49,20 @@ UMC6DTarget::UMC6DTarget()
 	IRot = DEF_IRot_Vel;
 	DRot = DEF_DRot_Vel;
 	MaxRot = DEF_MaxRot_Vel;
+	RotErrorType = EMC6DRotationErrorType::QuatVector;
+	RotErrorFrame = EMC6DRotationFrame::World;
+	bComputedTorque = false;
+	bCompensateGravity = true;
+	GainsPreset = nullptr;
+
+	ScheduleInput = 0.f;
+	LocScale = FVector4(1.f, 1.f, 1.f, 1.f);
+	RotScale = FVector4(1.f, 1.f, 1.f, 1.f);
+
+	// The rotation error is unitless (quaternion vector or radians)
+	RotAutoTune.RelayBand = 0.005f;
+	bIsAutoTuning = false;
+	AutoTuneStage = EMC6DMovementTypeSelection::Loc;
 }
 
 // Called when the game starts
@@ -120,6 +135,13 @@ void UMC6DTarget::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyC
 			DLoc = DEF_DLoc_Acc;
 			MaxLoc = DEF_MaxLoc_Acc;
 		}
+		else if (LocControlType == EMC6DControlType::StablePD)
+		{
+			PLoc = DEF_PLoc_SPD;
+			ILoc = DEF_ILoc_SPD;
+			DLoc = DEF_DLoc_SPD;
+			MaxLoc = DEF_MaxLoc_SPD;
+		}
 	}
 	else if (PropertyName == GET_MEMBER_NAME_CHECKED(UMC6DTarget, RotControlType))
 	{
@@ -137,6 +159,13 @@ void UMC6DTarget::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyC
 			DRot = DEF_DRot_Acc;
 			MaxRot = DEF_MaxRot_Acc;
 		}
+		else if (RotControlType == EMC6DControlType::StablePD)
+		{
+			PRot = DEF_PRot_SPD;
+			IRot = DEF_IRot_SPD;
+			DRot = DEF_DRot_SPD;
+			MaxRot = DEF_MaxRot_SPD;
+		}
 	}
 	else if (PropertyName == GET_MEMBER_NAME_CHECKED(UMC6DTarget, bUpdateLocationButtonHack))
 	{
@@ -174,7 +203,23 @@ void UMC6DTarget::TickComponent(float DeltaTime, ELevelTick TickType, FActorComp
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	// Apply target location to the referenced mesh
-	Controller.UpdateController(DeltaTime);
+	if (SkeletalTracker.Num() > 0)
+	{
+		SkeletalTracker.Update(DeltaTime);
+	}
+	else
+	{
+		if (bIsAutoTuning)
+		{
+			Controller.UpdateController(DeltaTime);
+			UpdateAutoTune(DeltaTime);
+		}
+		else
+		{
+			UpdateGainSchedules(DeltaTime);
+			Controller.UpdateController(DeltaTime);
+		}
+	}
 
 #if UMC_WITH_CHART
 	Controller.GetDebugChartData(ChartData.LocErr, ChartData.LocPID, ChartData.RotErr, ChartData.RotPID);
@@ -184,13 +229,60 @@ void UMC6DTarget::TickComponent(float DeltaTime, ELevelTick TickType, FActorComp
 // Reset the location PID
 void  UMC6DTarget::ResetLocationPID(bool bClearErrors /* = true*/)
 {
-	Controller.ResetLoc(PLoc, ILoc, DLoc, MaxLoc, bClearErrors);
+	Controller.ResetLoc(PLoc * LocScale.X, ILoc * LocScale.Y, DLoc * LocScale.Z, MaxLoc * LocScale.W, bClearErrors);
 }
 
 // Reset the location PID
 void  UMC6DTarget::ResetRotationPID(bool bClearErrors /* = true*/)
 {
-	Controller.ResetRot(PRot, IRot, DRot, MaxRot, bClearErrors);
+	Controller.ResetRot(PRot * RotScale.X, IRot * RotScale.Y, DRot * RotScale.Z, MaxRot * RotScale.W, bClearErrors);
+}
+
+// Oscillate the hand around the current target and re-tune the enabled PID groups
+bool UMC6DTarget::StartAutoTune()
+{
+	if (!bIsStarted || bIsAutoTuning)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not running or already tuning.."),
+			*FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+	if (SkeletalTracker.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s the auto tune is not supported with skeletal pose tracking.."),
+			*FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+
+	if (LocAutoTune.bEnabled && StartAutoTuneStage(EMC6DMovementTypeSelection::Loc))
+	{
+		return true;
+	}
+	if (RotAutoTune.bEnabled && StartAutoTuneStage(EMC6DMovementTypeSelection::Rot))
+	{
+		return true;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d %s no PID group can be tuned (enable the auto tune, PID driven control types only).."),
+		*FString(__FUNCTION__), __LINE__, *GetName());
+	return false;
+}
+
+// Stop the auto tune and restore the previous PID values
+void UMC6DTarget::CancelAutoTune()
+{
+	if (!bIsAutoTuning)
+	{
+		return;
+	}
+	bIsAutoTuning = false;
+	if (AutoTuneStage == EMC6DMovementTypeSelection::Loc)
+	{
+		ResetLocationPID(true);
+	}
+	else
+	{
+		ResetRotationPID(true);
+	}
 }
 
 // Check references
@@ -216,6 +308,18 @@ void UMC6DTarget::Init()
 		}
 	}
 
+	if (GainsPreset)
+	{
+		ApplyGainsPreset();
+	}
+
+	// Precompute the gain schedule lookup tables
+	LocGainSchedule.Bake();
+	RotGainSchedule.Bake();
+	LocScale = FVector4(1.f, 1.f, 1.f, 1.f);
+	RotScale = FVector4(1.f, 1.f, 1.f, 1.f);
+	PrevTargetTransform = GetComponentTransform();
+
 	// Check if owner has a valid static/skeletal mesh
 	if (bUseSkeletalMesh && SkeletalMeshActor)
 	{
@@ -226,6 +330,41 @@ void UMC6DTarget::Init()
 			//SkelMeshComp->SetSimulatePhysics(true);
 			//SkelMeshComp->SetEnableGravity(false);
 
+			// Track the target pose with a controller per body
+			if (bTrackSkeletalPose)
+			{
+				FMC6DGains DefaultGains;
+				DefaultGains.PLoc = PLoc;
+				DefaultGains.ILoc = ILoc;
+				DefaultGains.DLoc = DLoc;
+				DefaultGains.MaxLoc = MaxLoc;
+				DefaultGains.PRot = PRot;
+				DefaultGains.IRot = IRot;
+				DefaultGains.DRot = DRot;
+				DefaultGains.MaxRot = MaxRot;
+
+				USkeletalMeshComponent* TargetPoseComp = TargetPoseActor ? TargetPoseActor->GetSkeletalMeshComponent() : nullptr;
+				SkeletalTracker.SetRotationError(RotErrorType, RotErrorFrame);
+				SkeletalTracker.SetPIDGuard(PIDGuard);
+				if (SkeletalTracker.Init(SkelMeshComp, TargetPoseComp, LocControlType, RotControlType, DefaultGains, BoneGains) == 0)
+				{
+					UE_LOG(LogTemp, Error, TEXT("%s::%d %s could not track any body of the target pose, aborting.."),
+						*FString(__FUNCTION__), __LINE__, *GetName());
+					return;
+				}
+
+				if (LocGainSchedule.bEnabled || RotGainSchedule.bEnabled)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("%s::%d %s the gain schedules are not applied to the skeletal tracking, use the bone gains instead.."),
+						*FString(__FUNCTION__), __LINE__, *GetName());
+				}
+
+				bIsInit = true;
+				UE_LOG(LogTemp, Warning, TEXT("%s::%d %s succesfully initialized (skeletal tracking).."),
+					*FString(__FUNCTION__), __LINE__, *GetName());
+				return;
+			}
+
 			// Initialize update callbacks with/without offset
 			if (UMC6DOffset* OffsetComp = Cast<UMC6DOffset>(SkeletalMeshActor->GetComponentByClass(UMC6DOffset::StaticClass())))
 			{
@@ -238,6 +377,11 @@ void UMC6DTarget::Init()
 				Controller.Init(this, SkelMeshComp, bApplyToAllSkeletalBodies, LocControlType,
 					PLoc, ILoc, DLoc, MaxLoc, RotControlType, PRot, IRot, DRot, MaxRot);
 			}
+			Controller.SetRotationError(RotErrorType, RotErrorFrame);
+			Controller.SetPIDSettings(LocPIDSettings, RotPIDSettings);
+			Controller.SetComputedTorque(bComputedTorque, bCompensateGravity);
+			Controller.SetSprings(LocSpring, RotSpring);
+			Controller.SetPIDGuard(PIDGuard);
 
 			// Let the controler know that the location should be overwritten
 			if (bOverwriteTargetLocation)
@@ -281,6 +425,11 @@ void UMC6DTarget::Init()
 				Controller.Init(this, StaticMeshComp, LocControlType,
 					PLoc, ILoc, DLoc, MaxLoc, RotControlType, PRot, IRot, DRot, MaxRot);
 			}
+			Controller.SetRotationError(RotErrorType, RotErrorFrame);
+			Controller.SetPIDSettings(LocPIDSettings, RotPIDSettings);
+			Controller.SetComputedTorque(bComputedTorque, bCompensateGravity);
+			Controller.SetSprings(LocSpring, RotSpring);
+			Controller.SetPIDGuard(PIDGuard);
 
 			// Let the controler know that the location should be overwritten
 			if (bOverwriteTargetLocation)
@@ -436,6 +585,14 @@ void UMC6DTarget::Finish(bool bForced)
 
 	SetComponentTickEnabled(false);
 
+	// Report the abnormal frames the controllers had to guard against
+	const FMCPIDGuardCounters GuardCounters = SkeletalTracker.Num() > 0 ? SkeletalTracker.GetGuardCounters() : Controller.GetGuardCounters();
+	if (GuardCounters.Total() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s PID guards fired: NonFiniteErrors=%u; SmallDeltaTimes=%u; ClampedDeltaTimes=%u.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), GuardCounters.NonFiniteErrors, GuardCounters.SmallDeltaTimes, GuardCounters.ClampedDeltaTimes);
+	}
+
 	bIsStarted = false;
 	bIsInit = false;
 	bIsFinished = true;
@@ -443,11 +600,228 @@ void UMC6DTarget::Finish(bool bForced)
 		*FString(__FUNCTION__), __LINE__, *GetName());
 }
 
+// Overwrite the PID values with the default gains of the preset, if it was tuned for the same control types
+void UMC6DTarget::ApplyGainsPreset()
+{
+	if (GainsPreset->LocControlType != EMC6DControlType::NONE && GainsPreset->LocControlType != LocControlType)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s the location gains of %s were tuned for another control type, ignoring them.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *GainsPreset->GetName());
+	}
+	else
+	{
+		PLoc = GainsPreset->DefaultGains.PLoc;
+		ILoc = GainsPreset->DefaultGains.ILoc;
+		DLoc = GainsPreset->DefaultGains.DLoc;
+		MaxLoc = GainsPreset->DefaultGains.MaxLoc;
+	}
+
+	if (GainsPreset->RotControlType != EMC6DControlType::NONE && GainsPreset->RotControlType != RotControlType)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s the rotation gains of %s were tuned for another control type, ignoring them.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *GainsPreset->GetName());
+	}
+	else
+	{
+		PRot = GainsPreset->DefaultGains.PRot;
+		IRot = GainsPreset->DefaultGains.IRot;
+		DRot = GainsPreset->DefaultGains.DRot;
+		MaxRot = GainsPreset->DefaultGains.MaxRot;
+	}
+}
+
+// Scale the PID values with the gain schedules
+void UMC6DTarget::UpdateGainSchedules(float DeltaTime)
+{
+	if (!LocGainSchedule.IsActive() && !RotGainSchedule.IsActive())
+	{
+		return;
+	}
+
+	// Speed of the target since the previous update
+	const FTransform TargetTransform = GetComponentTransform();
+	const float InvDeltaTime = DeltaTime > KINDA_SMALL_NUMBER ? 1.f / DeltaTime : 0.f;
+	const float LinearSpeed = FVector::Dist(TargetTransform.GetLocation(), PrevTargetTransform.GetLocation()) * InvDeltaTime;
+	const float AngularSpeed = TargetTransform.GetRotation().AngularDistance(PrevTargetTransform.GetRotation()) * InvDeltaTime;
+	PrevTargetTransform = TargetTransform;
+
+	// Apply the new values only if the multipliers changed (keeps the errors)
+	if (LocGainSchedule.IsActive())
+	{
+		const FVector4 NewScale = LocGainSchedule.Evaluate(
+			GetScheduleInput(LocGainSchedule, Controller.GetLastLocError(), LinearSpeed));
+		if (!NewScale.Equals(LocScale, GainScheduleTolerance))
+		{
+			LocScale = NewScale;
+			ResetLocationPID(false);
+		}
+	}
+
+	if (RotGainSchedule.IsActive())
+	{
+		const FVector4 NewScale = RotGainSchedule.Evaluate(
+			GetScheduleInput(RotGainSchedule, Controller.GetLastRotError(), AngularSpeed));
+		if (!NewScale.Equals(RotScale, GainScheduleTolerance))
+		{
+			RotScale = NewScale;
+			ResetRotationPID(false);
+		}
+	}
+}
+
+// Get the input value of the schedule
+float UMC6DTarget::GetScheduleInput(const FMC6DGainSchedule& InSchedule, const FVector& InError, float InTargetSpeed) const
+{
+	switch (InSchedule.Input)
+	{
+	case EMC6DScheduleInput::ErrorMagnitude:
+		return InError.Size();
+	case EMC6DScheduleInput::TargetSpeed:
+		return InTargetSpeed;
+	case EMC6DScheduleInput::External:
+		return ScheduleInput;
+	default:
+		return 0.f;
+	}
+}
+
+// Replace the PID of the stage with the relay
+bool UMC6DTarget::StartAutoTuneStage(EMC6DMovementTypeSelection InStage)
+{
+	if (InStage == EMC6DMovementTypeSelection::Loc)
+	{
+		if (!SupportsAutoTune(LocControlType) || !LocAutoTune.Start(MaxLoc * LocScale.W))
+		{
+			return false;
+		}
+		Controller.ResetLocAsRelay(LocAutoTune.GetRelayAmplitude(), LocAutoTune.RelayBand);
+	}
+	else
+	{
+		if (!SupportsAutoTune(RotControlType) || !RotAutoTune.Start(MaxRot * RotScale.W))
+		{
+			return false;
+		}
+		Controller.ResetRotAsRelay(RotAutoTune.GetRelayAmplitude(), RotAutoTune.RelayBand);
+	}
+	bIsAutoTuning = true;
+	AutoTuneStage = InStage;
+	return true;
+}
+
+// Measure the relay oscillation, apply the PID values and move to the next stage when done
+void UMC6DTarget::UpdateAutoTune(float DeltaTime)
+{
+	const bool bLoc = AutoTuneStage == EMC6DMovementTypeSelection::Loc;
+	FMC6DAutoTune& AutoTune = bLoc ? LocAutoTune : RotAutoTune;
+	const EMC6DAutoTuneState State = AutoTune.Update(bLoc ? Controller.GetLastLocError() : Controller.GetLastRotError(), DeltaTime);
+	if (State == EMC6DAutoTuneState::Running)
+	{
+		return;
+	}
+
+	if (State == EMC6DAutoTuneState::Succeeded)
+	{
+		float& P = bLoc ? PLoc : PRot;
+		float& I = bLoc ? ILoc : IRot;
+		float& D = bLoc ? DLoc : DRot;
+		AutoTune.GetGains(P, I, D);
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %s %s auto tune: Ku=%f Tu=%fs -> P=%f I=%f D=%f.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), bLoc ? TEXT("location") : TEXT("rotation"),
+			AutoTune.GetUltimateGain(), AutoTune.GetUltimatePeriod(), P, I, D);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s %s auto tune did not measure an oscillation in %fs, keeping the previous values.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), bLoc ? TEXT("location") : TEXT("rotation"), AutoTune.Timeout);
+	}
+
+	// Apply the (new or previous) values, continue with the rotation
+	bIsAutoTuning = false;
+	if (bLoc)
+	{
+		ResetLocationPID(true);
+		if (RotAutoTune.bEnabled)
+		{
+			StartAutoTuneStage(EMC6DMovementTypeSelection::Rot);
+		}
+	}
+	else
+	{
+		ResetRotationPID(true);
+	}
+}
+
+// True if the control type is driven by the PID values
+bool UMC6DTarget::SupportsAutoTune(EMC6DControlType InControlType)
+{
+	return InControlType == EMC6DControlType::Velocity
+		|| InControlType == EMC6DControlType::Acceleration
+		|| InControlType == EMC6DControlType::Force
+		|| InControlType == EMC6DControlType::Impulse;
+}
+
+// Get the default PID values of the control types
+FMC6DGains UMC6DTarget::GetDefaultGains(EMC6DControlType InLocControlType, EMC6DControlType InRotControlType)
+{
+	FMC6DGains Gains;
+	if (InLocControlType == EMC6DControlType::Velocity)
+	{
+		Gains.PLoc = DEF_PLoc_Vel;
+		Gains.ILoc = DEF_ILoc_Vel;
+		Gains.DLoc = DEF_DLoc_Vel;
+		Gains.MaxLoc = DEF_MaxLoc_Vel;
+	}
+	else if (InLocControlType == EMC6DControlType::StablePD)
+	{
+		Gains.PLoc = DEF_PLoc_SPD;
+		Gains.ILoc = DEF_ILoc_SPD;
+		Gains.DLoc = DEF_DLoc_SPD;
+		Gains.MaxLoc = DEF_MaxLoc_SPD;
+	}
+	else
+	{
+		Gains.PLoc = DEF_PLoc_Acc;
+		Gains.ILoc = DEF_ILoc_Acc;
+		Gains.DLoc = DEF_DLoc_Acc;
+		Gains.MaxLoc = DEF_MaxLoc_Acc;
+	}
+
+	if (InRotControlType == EMC6DControlType::Velocity)
+	{
+		Gains.PRot = DEF_PRot_Vel;
+		Gains.IRot = DEF_IRot_Vel;
+		Gains.DRot = DEF_DRot_Vel;
+		Gains.MaxRot = DEF_MaxRot_Vel;
+	}
+	else if (InRotControlType == EMC6DControlType::StablePD)
+	{
+		Gains.PRot = DEF_PRot_SPD;
+		Gains.IRot = DEF_IRot_SPD;
+		Gains.DRot = DEF_DRot_SPD;
+		Gains.MaxRot = DEF_MaxRot_SPD;
+	}
+	else
+	{
+		Gains.PRot = DEF_PRot_Acc;
+		Gains.IRot = DEF_IRot_Acc;
+		Gains.DRot = DEF_DRot_Acc;
+		Gains.MaxRot = DEF_MaxRot_Acc;
+	}
+	return Gains;
+}
+
 // Initial teleport the hands to the motion controller location, 
 // has to be called after a delay since at begin play the controller is not tracked yet
 void UMC6DTarget::TeleportToInitialPose()
 {
 	UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs"), *FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds());
+	if (SkeletalTracker.Num() > 0)
+	{
+		// The bodies follow the target pose, not the motion controller
+		return;
+	}
+
 	if (bUseSkeletalMesh && SkeletalMeshActor)
 	{
 		if (USkeletalMeshComponent* SkelMeshComp = SkeletalMeshActor->GetSkeletalMeshComponent())
@@ -0,0 +1,167 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DTrajectory.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Add a keyframe
+void FMC6DTrajectory::Add(float InTime, const FTransform& InPose)
+{
+	if (Times.Num() > 0 && InTime <= Times.Last())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s keyframe time %f is not after %f, skipping.."),
+			*FString(__FUNCTION__), __LINE__, *Name, InTime, Times.Last());
+		return;
+	}
+	Times.Add(InTime);
+	Poses.Add(InPose);
+}
+
+// Get the interpolated pose at the given time
+FTransform FMC6DTrajectory::Sample(float InTime) const
+{
+	if (Times.Num() == 0)
+	{
+		return FTransform::Identity;
+	}
+	if (InTime <= Times[0])
+	{
+		return Poses[0];
+	}
+	if (InTime >= Times.Last())
+	{
+		return Poses.Last();
+	}
+
+	// First keyframe after the time
+	const int32 Next = Algo::UpperBound(Times, InTime);
+	const int32 Prev = Next - 1;
+	const float Alpha = (InTime - Times[Prev]) / (Times[Next] - Times[Prev]);
+	return FTransform(
+		FQuat::Slerp(Poses[Prev].GetRotation(), Poses[Next].GetRotation(), Alpha),
+		FMath::Lerp(Poses[Prev].GetLocation(), Poses[Next].GetLocation(), Alpha));
+}
+
+// Time from which the target does not move anymore
+float FMC6DTrajectory::GetHoldTime() const
+{
+	if (Times.Num() == 0)
+	{
+		return 0.f;
+	}
+	for (int32 Idx = Poses.Num() - 2; Idx >= 0; --Idx)
+	{
+		if (!Poses[Idx].Equals(Poses.Last(), KINDA_SMALL_NUMBER))
+		{
+			return Times[Idx + 1];
+		}
+	}
+	return Times[0];
+}
+
+// Step of the location and rotation at the given time
+FMC6DTrajectory FMC6DTrajectory::MakeStep(const FVector& InLocStep, const FRotator& InRotStep, float InStepTime, float InDuration)
+{
+	FMC6DTrajectory Trajectory;
+	Trajectory.Name = TEXT("Step");
+	const FTransform Stepped(InRotStep.Quaternion(), InLocStep);
+	Trajectory.Add(0.f, FTransform::Identity);
+	Trajectory.Add(InStepTime, FTransform::Identity);
+	Trajectory.Add(InStepTime + KINDA_SMALL_NUMBER, Stepped);
+	Trajectory.Add(FMath::Max(InDuration, InStepTime + 2.f * KINDA_SMALL_NUMBER), Stepped);
+	return Trajectory;
+}
+
+// Constant speed move of the location and rotation over the ramp time
+FMC6DTrajectory FMC6DTrajectory::MakeRamp(const FVector& InLocDelta, const FRotator& InRotDelta, float InStartTime, float InRampTime, float InDuration)
+{
+	FMC6DTrajectory Trajectory;
+	Trajectory.Name = TEXT("Ramp");
+	const FTransform Moved(InRotDelta.Quaternion(), InLocDelta);
+	const float EndTime = InStartTime + FMath::Max(InRampTime, KINDA_SMALL_NUMBER);
+	Trajectory.Add(0.f, FTransform::Identity);
+	Trajectory.Add(InStartTime, FTransform::Identity);
+	Trajectory.Add(EndTime, Moved);
+	Trajectory.Add(FMath::Max(InDuration, EndTime + KINDA_SMALL_NUMBER), Moved);
+	return Trajectory;
+}
+
+// Sine along the location axis and around the rotation axis
+FMC6DTrajectory FMC6DTrajectory::MakeSine(const FVector& InLocAmplitude, const FRotator& InRotAmplitude, float InFrequency, float InDuration, float InSampleRate)
+{
+	FMC6DTrajectory Trajectory;
+	Trajectory.Name = TEXT("Sine");
+	const int32 NumSamples = FMath::Max(FMath::CeilToInt(InDuration * InSampleRate), 1) + 1;
+	const FQuat RotAmplitude = InRotAmplitude.Quaternion();
+	for (int32 Idx = 0; Idx < NumSamples; ++Idx)
+	{
+		const float Time = Idx / InSampleRate;
+		const float Value = FMath::Sin(2.f * PI * InFrequency * Time);
+		Trajectory.Add(Time, FTransform(FQuat::Slerp(FQuat::Identity, RotAmplitude, Value), InLocAmplitude * Value));
+	}
+	return Trajectory;
+}
+
+// Sine with a linearly increasing frequency, ends held at the center
+FMC6DTrajectory FMC6DTrajectory::MakeSineSweep(const FVector& InLocAmplitude, const FRotator& InRotAmplitude, float InStartFrequency, float InEndFrequency,
+	float InDuration, float InHoldDuration, float InSampleRate)
+{
+	FMC6DTrajectory Trajectory;
+	Trajectory.Name = TEXT("SineSweep");
+	const int32 NumSamples = FMath::Max(FMath::CeilToInt(InDuration * InSampleRate), 1) + 1;
+	const FQuat RotAmplitude = InRotAmplitude.Quaternion();
+	const float Rate = (InEndFrequency - InStartFrequency) / FMath::Max(InDuration, KINDA_SMALL_NUMBER);
+	for (int32 Idx = 0; Idx < NumSamples; ++Idx)
+	{
+		// Phase is the integral of the frequency
+		const float Time = Idx / InSampleRate;
+		const float Phase = 2.f * PI * (InStartFrequency * Time + 0.5f * Rate * Time * Time);
+		const float Value = FMath::Sin(Phase);
+		Trajectory.Add(Time, FTransform(FQuat::Slerp(FQuat::Identity, RotAmplitude, Value), InLocAmplitude * Value));
+	}
+
+	// Return to the center and hold (step response at the end of the sweep)
+	if (InHoldDuration > 0.f)
+	{
+		const float EndTime = Trajectory.GetDuration();
+		Trajectory.Add(EndTime + 1.f / InSampleRate, FTransform::Identity);
+		Trajectory.Add(EndTime + 1.f / InSampleRate + InHoldDuration, FTransform::Identity);
+	}
+	return Trajectory;
+}
+
+// Load a recorded trajectory from a csv file
+bool FMC6DTrajectory::LoadFromFile(const FString& InPath, FMC6DTrajectory& OutTrajectory)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *InPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read %s.."), *FString(__FUNCTION__), __LINE__, *InPath);
+		return false;
+	}
+
+	OutTrajectory = FMC6DTrajectory();
+	OutTrajectory.Name = FPaths::GetBaseFilename(InPath);
+	TArray<FString> Values;
+	for (const FString& Line : Lines)
+	{
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+		Line.ParseIntoArray(Values, TEXT(","));
+		if (Values.Num() < 8)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d %s: skipping malformed line '%s'.."),
+				*FString(__FUNCTION__), __LINE__, *OutTrajectory.Name, *Line);
+			continue;
+		}
+		const FVector Location(FCString::Atof(*Values[1]), FCString::Atof(*Values[2]), FCString::Atof(*Values[3]));
+		const FQuat Rotation = FQuat(FCString::Atof(*Values[4]), FCString::Atof(*Values[5]),
+			FCString::Atof(*Values[6]), FCString::Atof(*Values[7])).GetNormalized();
+		OutTrajectory.Add(FCString::Atof(*Values[0]), FTransform(Rotation, Location));
+	}
+	return !OutTrajectory.IsEmpty();
+}
@@ -0,0 +1,135 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MC6DAutoTune.generated.h"
+
+/**
+* Tuning rule from the ultimate gain and period
+*	ZieglerNichols - fast, aggressive response (noticeable overshoot)
+*	TyreusLuyben - less overshoot and more robust to model changes
+*/
+UENUM()
+enum class EMC6DAutoTuneRule : uint8
+{
+	ZieglerNichols			UMETA(DisplayName = "Ziegler-Nichols"),
+	TyreusLuyben			UMETA(DisplayName = "Tyreus-Luyben"),
+};
+
+/**
+* Auto tune progress
+*/
+enum class EMC6DAutoTuneState : uint8
+{
+	Idle,
+	Running,
+	Succeeded,
+	Failed,
+};
+
+/**
+* Relay oscillation measurement of a single axis
+*/
+struct FMC6DRelayAxis
+{
+	// Side of the error band (-1, 0 before the first crossing, 1)
+	int32 Side = 0;
+
+	// Number of band crossings
+	int32 NumCrossings = 0;
+
+	// Time of the last crossing
+	float LastCrossingTime = 0.f;
+
+	// Largest error magnitude since the last crossing
+	float Peak = 0.f;
+
+	// Sums of the measured half periods and peaks
+	float HalfPeriodSum = 0.f;
+	float PeakSum = 0.f;
+	int32 NumHalfPeriods = 0;
+};
+
+/**
+* Relay feedback auto tune of an axis group (location or rotation):
+* the PID is replaced by a +/-amplitude relay with hysteresis (switched when the error leaves the band),
+* the resulting limit cycle gives the ultimate gain and period from which the PID values are derived;
+* a settled hand is kicked in the direction of the error to start the cycle,
+* with the Velocity control type the plant is an integrator, the cycle then only comes from the band
+* and the frame delay (no true ultimate point), the values are a rough estimate
+*/
+USTRUCT()
+struct UMC6DCONTROLLER_API FMC6DAutoTune
+{
+	GENERATED_BODY()
+
+public:
+	// Tune this axis group when the auto tune is started
+	UPROPERTY(EditAnywhere, Category = "Auto Tune")
+	bool bEnabled = false;
+
+	// Rule used to derive the PID values
+	UPROPERTY(EditAnywhere, Category = "Auto Tune", meta = (editcondition = "bEnabled"))
+	EMC6DAutoTuneRule Rule = EMC6DAutoTuneRule::TyreusLuyben;
+
+	// Relay amplitude relative to the Max PID value
+	UPROPERTY(EditAnywhere, Category = "Auto Tune", meta = (editcondition = "bEnabled", ClampMin = 0.01, ClampMax = 1))
+	float RelayRatio = 0.2f;
+
+	// Error band of the relay switching, avoids chattering from noise (cm for location, rotation error units otherwise)
+	UPROPERTY(EditAnywhere, Category = "Auto Tune", meta = (editcondition = "bEnabled", ClampMin = 0))
+	float RelayBand = 0.1f;
+
+	// Number of measured oscillation periods
+	UPROPERTY(EditAnywhere, Category = "Auto Tune", meta = (editcondition = "bEnabled", ClampMin = 1, ClampMax = 20))
+	int32 NumCycles = 4;
+
+	// Abort if the oscillation is not measured in this time (s)
+	UPROPERTY(EditAnywhere, Category = "Auto Tune", meta = (editcondition = "bEnabled", ClampMin = 0.1))
+	float Timeout = 5.f;
+
+	// Start the measurement, the relay amplitude is relative to the current Max PID value
+	bool Start(float InMaxOut);
+
+	// Output amplitude of the relay (+/-), switched on the RelayBand crossings
+	float GetRelayAmplitude() const { return Amplitude; };
+
+	// Measure the oscillation of the error
+	EMC6DAutoTuneState Update(const FVector& InError, float InDeltaTime);
+
+	// Get the PID values of the measurement, false if it did not succeed
+	bool GetGains(float& OutP, float& OutI, float& OutD) const;
+
+	// Measurement state
+	EMC6DAutoTuneState GetState() const { return State; };
+
+	// Measured ultimate gain and period (s)
+	float GetUltimateGain() const { return UltimateGain; };
+	float GetUltimatePeriod() const { return UltimatePeriod; };
+
+private:
+	// Compute the ultimate gain and period from the measured axes
+	bool ComputeResult();
+
+private:
+	// Progress
+	EMC6DAutoTuneState State = EMC6DAutoTuneState::Idle;
+
+	// Output amplitude of the relay
+	float Amplitude = 0.f;
+
+	// Time since start
+	float Elapsed = 0.f;
+
+	// Per axis measurements
+	FMC6DRelayAxis Axes[3];
+
+	// Result
+	float UltimateGain = 0.f;
+	float UltimatePeriod = 0.f;
+
+	// Band crossings ignored at start (transient towards the limit cycle)
+	constexpr static int32 NumSkippedCrossings = 3;
+};
@@ -0,0 +1,104 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "MC6DControlType.h"
+#include "MC6DBoneGainsDataAsset.generated.h"
+
+/**
+* Location and rotation PID gains
+*/
+USTRUCT()
+struct UMC6DCONTROLLER_API FMC6DGains
+{
+	GENERATED_BODY()
+
+	// Location PID controller values
+	UPROPERTY(EditAnywhere, Category = "Location", meta = (ClampMin = 0))
+	float PLoc = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Location", meta = (ClampMin = 0))
+	float ILoc = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Location", meta = (ClampMin = 0))
+	float DLoc = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Location", meta = (ClampMin = 0))
+	float MaxLoc = 0.f;
+
+	// Rotation PID controller values
+	UPROPERTY(EditAnywhere, Category = "Rotation", meta = (ClampMin = 0))
+	float PRot = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Rotation", meta = (ClampMin = 0))
+	float IRot = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Rotation", meta = (ClampMin = 0))
+	float DRot = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Rotation", meta = (ClampMin = 0))
+	float MaxRot = 0.f;
+
+	// True if all the gains are the same
+	bool operator==(const FMC6DGains& Other) const
+	{
+		return PLoc == Other.PLoc && ILoc == Other.ILoc && DLoc == Other.DLoc && MaxLoc == Other.MaxLoc
+			&& PRot == Other.PRot && IRot == Other.IRot && DRot == Other.DRot && MaxRot == Other.MaxRot;
+	}
+};
+
+/**
+* Gains of a bone
+*/
+USTRUCT()
+struct UMC6DCONTROLLER_API FMC6DBoneGains
+{
+	GENERATED_BODY()
+
+	// Name of the bone (physics body)
+	UPROPERTY(EditAnywhere, Category = "Bone")
+	FName BoneName;
+
+	// Do not track this bone
+	UPROPERTY(EditAnywhere, Category = "Bone")
+	bool bIgnore = false;
+
+	// Gains of the bone
+	UPROPERTY(EditAnywhere, Category = "Bone", meta = (editcondition = "!bIgnore"))
+	FMC6DGains Gains;
+};
+
+/**
+ * Per bone PID gains for the skeletal pose tracking
+ */
+UCLASS()
+class UMC6DCONTROLLER_API UMC6DBoneGainsDataAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Get the bone entry, nullptr if the bone uses the default gains
+	const FMC6DBoneGains* FindBone(FName InBoneName) const
+	{
+		return BoneGains.FindByPredicate([InBoneName](const FMC6DBoneGains& Entry) { return Entry.BoneName == InBoneName; });
+	}
+
+public:
+	// Gains of the bones without an entry
+	UPROPERTY(EditAnywhere, Category = "Bone Gains")
+	FMC6DGains DefaultGains;
+
+	// Control types the default gains were tuned for (NONE if not tuned, e.g. hand written gains)
+	UPROPERTY(EditAnywhere, Category = "Bone Gains")
+	EMC6DControlType LocControlType = EMC6DControlType::NONE;
+
+	UPROPERTY(EditAnywhere, Category = "Bone Gains")
+	EMC6DControlType RotControlType = EMC6DControlType::NONE;
+
+	// Bones with their own gains (e.g. lighter finger bodies)
+	UPROPERTY(EditAnywhere, Category = "Bone Gains")
+	TArray<FMC6DBoneGains> BoneGains;
+};
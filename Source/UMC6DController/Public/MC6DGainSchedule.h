@@ -0,0 +1,82 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
+#include "MC6DGainSchedule.generated.h"
+
+/**
+* Value the gains are scheduled on
+*/
+UENUM()
+enum class EMC6DScheduleInput : uint8
+{
+	ErrorMagnitude			UMETA(DisplayName = "Error Magnitude"),
+	TargetSpeed				UMETA(DisplayName = "Target Speed"),
+	External				UMETA(DisplayName = "External"),
+};
+
+/**
+* Gain multipliers as a function of the schedule input,
+* the curves are baked into a lookup table so the evaluation does not touch the curves nor allocate
+*/
+USTRUCT()
+struct UMC6DCONTROLLER_API FMC6DGainSchedule
+{
+	GENERATED_BODY()
+
+public:
+	// Scale the gains with the curves below
+	UPROPERTY(EditAnywhere, Category = "Schedule")
+	bool bEnabled = false;
+
+	// Value the gains are scheduled on (error in cm or rotation error, target speed in cm/s or rad/s, external value e.g. the grasped mass)
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled"))
+	EMC6DScheduleInput Input = EMC6DScheduleInput::ErrorMagnitude;
+
+	// Input range of the lookup table, values outside are clamped
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled"))
+	float InputMin = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled"))
+	float InputMax = 10.f;
+
+	// Number of lookup table samples
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled", ClampMin = 2, ClampMax = 1024))
+	int32 NumSamples = 64;
+
+	// Multipliers of the P, I, D and Max values (an empty curve keeps the value unchanged)
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled"))
+	FRuntimeFloatCurve PScale;
+
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled"))
+	FRuntimeFloatCurve IScale;
+
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled"))
+	FRuntimeFloatCurve DScale;
+
+	UPROPERTY(EditAnywhere, Category = "Schedule", meta = (editcondition = "bEnabled"))
+	FRuntimeFloatCurve MaxScale;
+
+	// Sample the curves into the lookup table, return false if the schedule is disabled or invalid
+	bool Bake();
+
+	// True if the lookup table is ready
+	bool IsActive() const { return Table.Num() > 1; };
+
+	// Get the (P, I, D, Max) multipliers of the input value
+	FVector4 Evaluate(float InValue) const;
+
+private:
+	// Sample a curve, 1 if it has no keys
+	static float SampleCurve(const FRuntimeFloatCurve& InCurve, float InTime);
+
+private:
+	// Baked (P, I, D, Max) multipliers, uniformly spaced over the input range
+	TArray<FVector4> Table;
+
+	// Samples per input unit
+	float InvStep = 0.f;
+};
@@ -7,7 +7,10 @@
 #include "Engine/StaticMeshActor.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "MC6DController.h"
+#include "MC6DSkeletalTracker.h"
 #include "MC6DControlType.h"
+#include "MC6DGainSchedule.h"
+#include "MC6DAutoTune.h"
 #include "MC6DTarget.generated.h"
 
 /**
@@ -99,6 +102,22 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void ResetRotationPID(bool bClearErrors = true);
 
+	// Set the value of the external gain schedules (e.g. the mass of the grasped object)
+	UFUNCTION(BlueprintCallable)
+	void SetScheduleInput(float InValue) { ScheduleInput = InValue; };
+
+	// Oscillate the hand around the current target and re-tune the enabled PID groups (location first, then rotation)
+	UFUNCTION(BlueprintCallable)
+	bool StartAutoTune();
+
+	// Stop the auto tune and restore the previous PID values
+	UFUNCTION(BlueprintCallable)
+	void CancelAutoTune();
+
+	// True while the auto tune oscillates the hand
+	UFUNCTION(BlueprintCallable)
+	bool IsAutoTuning() const { return bIsAutoTuning; };
+
 // #if UMC_WITH_CHART // UPROPERTY must not be inside preprocessor blocks, except for WITH_EDITORONLY_DATA
 //#if WITH_EDITORONLY_DATA // Blueprint exposed struct members cannot be editor only
 public:
@@ -131,11 +150,32 @@ public:
 	// Get finished state
 	bool IsFinished() const { return bIsFinished; };
 
+	// Get the default PID values of the control types
+	static FMC6DGains GetDefaultGains(EMC6DControlType InLocControlType, EMC6DControlType InRotControlType);
+
 private:
 	// Initial teleport the hands to the motion controller location, 
 	// has to be called after a delay since at begin play the controller is not tracked yet
 	void TeleportToInitialPose();
 
+	// Overwrite the PID values with the default gains of the preset, if it was tuned for the same control types
+	void ApplyGainsPreset();
+
+	// Scale the PID values with the gain schedules
+	void UpdateGainSchedules(float DeltaTime);
+
+	// Get the input value of the schedule
+	float GetScheduleInput(const FMC6DGainSchedule& InSchedule, const FVector& InError, float InTargetSpeed) const;
+
+	// Replace the PID of the stage with the relay, return false if the stage cannot be tuned
+	bool StartAutoTuneStage(EMC6DMovementTypeSelection InStage);
+
+	// Measure the relay oscillation, apply the PID values and move to the next stage when done
+	void UpdateAutoTune(float DeltaTime);
+
+	// True if the control type is driven by the PID values
+	static bool SupportsAutoTune(EMC6DControlType InControlType);
+
 public:
 	// Control type location 
 	UPROPERTY(EditAnywhere, Category = "Movement Control|Location")
@@ -154,6 +194,22 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Movement Control|Location", meta = (ClampMin = 0))
 	float MaxLoc;
 
+	// Location spring parameters (Spring control type)
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Location")
+	FMCSpringController3D LocSpring;
+
+	// Location PID anti-windup, derivative filtering and output slew limiting
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Location")
+	FMCPIDSettings LocPIDSettings;
+
+	// Location PID values multipliers (e.g. aggressive in free motion, soft near contact)
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Location")
+	FMC6DGainSchedule LocGainSchedule;
+
+	// Location relay auto tune (e.g. after changing the hand mesh or physics material)
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Location")
+	FMC6DAutoTune LocAutoTune;
+
 	// Control type (location and rotation)
 	UPROPERTY(EditAnywhere, Category = "Movement Control|Rotation")
 	EMC6DControlType RotControlType;
@@ -171,6 +227,46 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Movement Control|Rotation", meta = (ClampMin = 0))
 	float MaxRot;
 
+	// Rotation spring parameters (Spring control type)
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Rotation")
+	FMCSpringController3D RotSpring;
+
+	// Rotation PID anti-windup, derivative filtering and output slew limiting
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Rotation")
+	FMCPIDSettings RotPIDSettings;
+
+	// Rotation PID values multipliers
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Rotation")
+	FMC6DGainSchedule RotGainSchedule;
+
+	// Rotation relay auto tune
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Rotation")
+	FMC6DAutoTune RotAutoTune;
+
+	// Rotation error, the log map stays proportional to the angle for large errors
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Rotation")
+	EMC6DRotationErrorType RotErrorType;
+
+	// Frame in which the rotation PID operates
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Rotation")
+	EMC6DRotationFrame RotErrorFrame;
+
+	// Force control: the PID values command accelerations which are scaled by the body mass and inertia (gains transfer across rigs)
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Force")
+	bool bComputedTorque;
+
+	// Compensate the gravity acting on the body in the computed force
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Force", meta = (editcondition = "bComputedTorque"))
+	bool bCompensateGravity;
+
+	// Time step range of the PID updates (paused, zero length or hitching frames) and non finite error handling
+	UPROPERTY(EditAnywhere, Category = "Movement Control")
+	FMCPIDGuard PIDGuard;
+
+	// Tuned PID values (e.g. from the MC6DTune commandlet), applied at init instead of the values above
+	UPROPERTY(EditAnywhere, Category = "Movement Control")
+	UMC6DBoneGainsDataAsset* GainsPreset;
+
 private:
 	// True when all references are set and it is connected to the server
 	uint8 bIgnore : 1;
@@ -200,6 +296,18 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Movement Control", meta = (editcondition = "bUseSkeletalMesh"))
 	ASkeletalMeshActor* SkeletalMeshActor;
 
+	// Move every body of the skeletal mesh towards the same named bone of the target pose (instead of following this component)
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Skeletal Tracking", meta = (editcondition = "bUseSkeletalMesh"))
+	bool bTrackSkeletalPose;
+
+	// Skeletal mesh actor providing the target pose (e.g. the fully tracked body)
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Skeletal Tracking", meta = (editcondition = "bTrackSkeletalPose"))
+	ASkeletalMeshActor* TargetPoseActor;
+
+	// Per bone gains, if not set every bone uses the location and rotation values of this component
+	UPROPERTY(EditAnywhere, Category = "Movement Control|Skeletal Tracking", meta = (editcondition = "bTrackSkeletalPose"))
+	UMC6DBoneGainsDataAsset* BoneGains;
+
 	// Static mesh actor to control
 	UPROPERTY(EditAnywhere, Category = "Movement Control", meta = (editcondition = "!bUseSkeletalMesh"))
 	AStaticMeshActor* StaticMeshActor;
@@ -223,6 +331,25 @@ private:
 	// Update callback function binding
 	FMC6DController Controller;
 
+	// Per body controllers of the skeletal tracking
+	FMC6DSkeletalTracker SkeletalTracker;
+
+	// Value of the external gain schedules
+	float ScheduleInput;
+
+	// Currently applied (P, I, D, Max) multipliers
+	FVector4 LocScale;
+	FVector4 RotScale;
+
+	// Target pose of the previous update (target speed schedules)
+	FTransform PrevTargetTransform;
+
+	// True while the relay replaces one of the PIDs
+	bool bIsAutoTuning;
+
+	// Axis group currently tuned
+	EMC6DMovementTypeSelection AutoTuneStage;
+
 	/* Constants */
 	// Loc
 	constexpr static float DEF_PLoc_Vel = 20.f;
@@ -235,6 +362,11 @@ private:
 	constexpr static float DEF_DLoc_Acc = 50.f;
 	constexpr static float DEF_MaxLoc_Acc = 10000.f;
 
+	constexpr static float DEF_PLoc_SPD = 5000.f;
+	constexpr static float DEF_ILoc_SPD = 0.f;
+	constexpr static float DEF_DLoc_SPD = 150.f;
+	constexpr static float DEF_MaxLoc_SPD = 1000000.f;
+
 	// Rot
 	constexpr static float DEF_PRot_Vel = 250.f;
 	constexpr static float DEF_IRot_Vel = 0.f;
@@ -245,4 +377,12 @@ private:
 	constexpr static float DEF_IRot_Acc = 100.f;
 	constexpr static float DEF_DRot_Acc = 50.f;
 	constexpr static float DEF_MaxRot_Acc = 10000.f;
+
+	constexpr static float DEF_PRot_SPD = 20000.f;
+	constexpr static float DEF_IRot_SPD = 0.f;
+	constexpr static float DEF_DRot_SPD = 1000.f;
+	constexpr static float DEF_MaxRot_SPD = 10000000.f;
+
+	// Minimal change of the gain multipliers to re-apply the PID values
+	constexpr static float GainScheduleTolerance = 0.01f;
 };
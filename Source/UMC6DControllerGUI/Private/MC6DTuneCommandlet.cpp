@@ -0,0 +1,831 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MC6DTuneCommandlet.h"
+#include "MC6DTarget.h"
+#include "MC6DSimBody.h"
+#include "MCPIDController3D.h"
+#include "AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+// Default constructor
+UMC6DTuneCommandlet::UMC6DTuneCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	LocControlType = EMC6DControlType::Acceleration;
+	RotControlType = EMC6DControlType::Velocity;
+	RotErrorType = EMC6DRotationErrorType::QuatVector;
+	Mass = 1.f;
+	Inertia = FVector(100.f);
+	LinearDamping = 0.01f;
+	AngularDamping = 0.f;
+	Gravity = 0.f;
+	bUseFloor = false;
+	FloorHeight = 0.f;
+	ContactRadius = 5.f;
+	DeltaTime = 1.f / 90.f;
+	Generations = 40;
+	Population = 16;
+	Seed = 0;
+	OvershootWeight = 10.f;
+	SettlingWeight = 1.f;
+	EffortWeight = 0.01f;
+	PackagePath = TEXT("/UPhysicsBasedMC/Presets");
+	Tolerance = 0.05f;
+	bAllLocControlTypes = false;
+	bAllRotControlTypes = false;
+}
+
+// Supported control types of the benchmark
+static const EMC6DControlType BenchmarkControlTypes[] = {
+	EMC6DControlType::Velocity, EMC6DControlType::Acceleration, EMC6DControlType::Force, EMC6DControlType::Impulse };
+
+// Metrics of an axis group as json
+static TSharedRef<FJsonObject> MetricsToJson(const FMC6DAxisMetrics& InMetrics)
+{
+	TSharedRef<FJsonObject> JsonMetrics = MakeShared<FJsonObject>();
+	JsonMetrics->SetNumberField(TEXT("RiseTime"), InMetrics.RiseTime);
+	JsonMetrics->SetNumberField(TEXT("Overshoot"), InMetrics.Overshoot);
+	JsonMetrics->SetNumberField(TEXT("SettlingTime"), InMetrics.SettlingTime);
+	JsonMetrics->SetNumberField(TEXT("SteadyStateError"), InMetrics.SteadyStateError);
+	JsonMetrics->SetNumberField(TEXT("RMSError"), InMetrics.RMSError);
+	JsonMetrics->SetNumberField(TEXT("MaxError"), InMetrics.MaxError);
+	JsonMetrics->SetNumberField(TEXT("Effort"), InMetrics.Effort);
+	return JsonMetrics;
+}
+
+// Gains as json
+static TSharedRef<FJsonObject> GainsToJson(const FMC6DGains& InGains)
+{
+	TSharedRef<FJsonObject> JsonGains = MakeShared<FJsonObject>();
+	JsonGains->SetNumberField(TEXT("PLoc"), InGains.PLoc);
+	JsonGains->SetNumberField(TEXT("ILoc"), InGains.ILoc);
+	JsonGains->SetNumberField(TEXT("DLoc"), InGains.DLoc);
+	JsonGains->SetNumberField(TEXT("MaxLoc"), InGains.MaxLoc);
+	JsonGains->SetNumberField(TEXT("PRot"), InGains.PRot);
+	JsonGains->SetNumberField(TEXT("IRot"), InGains.IRot);
+	JsonGains->SetNumberField(TEXT("DRot"), InGains.DRot);
+	JsonGains->SetNumberField(TEXT("MaxRot"), InGains.MaxRot);
+	return JsonGains;
+}
+
+// Run of a control type pair on a trajectory as json
+static TSharedPtr<FJsonValue> RunToJson(const FString& InLocType, const FString& InRotType, const FString& InTrajectory,
+	const FMC6DGains& InGains, const FMC6DResponseMetrics& InMetrics)
+{
+	TSharedRef<FJsonObject> JsonRun = MakeShared<FJsonObject>();
+	JsonRun->SetStringField(TEXT("Name"), FString::Printf(TEXT("%s/%s/%s"), *InLocType, *InRotType, *InTrajectory));
+	JsonRun->SetStringField(TEXT("LocControlType"), InLocType);
+	JsonRun->SetStringField(TEXT("RotControlType"), InRotType);
+	JsonRun->SetStringField(TEXT("Trajectory"), InTrajectory);
+	JsonRun->SetObjectField(TEXT("Gains"), GainsToJson(InGains));
+	JsonRun->SetBoolField(TEXT("Diverged"), InMetrics.HasDiverged());
+	JsonRun->SetObjectField(TEXT("Location"), MetricsToJson(InMetrics.Loc));
+	JsonRun->SetObjectField(TEXT("Rotation"), MetricsToJson(InMetrics.Rot));
+	return MakeShared<FJsonValueObject>(JsonRun);
+}
+
+// Commandlet entry point
+int32 UMC6DTuneCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	const FString Mode = ParamVals.FindRef(TEXT("mode"));
+	const bool bBenchmark = Mode.Equals(TEXT("benchmark"), ESearchCase::IgnoreCase);
+	const bool bThroughput = Mode.Equals(TEXT("throughput"), ESearchCase::IgnoreCase);
+	const FString LocTypeParam = ParamVals.FindRef(TEXT("loctype"));
+	const FString RotTypeParam = ParamVals.FindRef(TEXT("rottype"));
+	bAllLocControlTypes = bBenchmark && (LocTypeParam.IsEmpty() || LocTypeParam.Equals(TEXT("all"), ESearchCase::IgnoreCase));
+	bAllRotControlTypes = bBenchmark && (RotTypeParam.IsEmpty() || RotTypeParam.Equals(TEXT("all"), ESearchCase::IgnoreCase));
+	LocControlType = bAllLocControlTypes ? LocControlType : ParseControlType(LocTypeParam, LocControlType);
+	RotControlType = bAllRotControlTypes ? RotControlType : ParseControlType(RotTypeParam, RotControlType);
+	if (LocControlType == EMC6DControlType::NONE || RotControlType == EMC6DControlType::NONE)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Unsupported control type, use -loctype/-rottype=<Velocity|Acceleration|Force|Impulse>.."),
+			*FString(__func__), __LINE__);
+		return 1;
+	}
+	if (ParamVals.FindRef(TEXT("roterror")).Equals(TEXT("log"), ESearchCase::IgnoreCase))
+	{
+		RotErrorType = EMC6DRotationErrorType::LogMap;
+	}
+
+	// Numeric parameters keep their default if not given
+	auto ParseFloat = [&ParamVals](const TCHAR* InKey, float& OutValue)
+	{
+		if (const FString* Value = ParamVals.Find(InKey))
+		{
+			OutValue = FCString::Atof(**Value);
+		}
+	};
+	auto ParseInt = [&ParamVals](const TCHAR* InKey, int32& OutValue)
+	{
+		if (const FString* Value = ParamVals.Find(InKey))
+		{
+			OutValue = FCString::Atoi(**Value);
+		}
+	};
+	float InertiaValue = Inertia.X;
+	ParseFloat(TEXT("mass"), Mass);
+	ParseFloat(TEXT("inertia"), InertiaValue);
+	ParseFloat(TEXT("lindamping"), LinearDamping);
+	ParseFloat(TEXT("angdamping"), AngularDamping);
+	ParseFloat(TEXT("gravity"), Gravity);
+	ParseFloat(TEXT("radius"), ContactRadius);
+	bUseFloor = ParamVals.Contains(TEXT("floor"));
+	ParseFloat(TEXT("floor"), FloorHeight);
+	int32 NumSteps = 1000000;
+	ParseInt(TEXT("steps"), NumSteps);
+	ParseFloat(TEXT("dt"), DeltaTime);
+	ParseInt(TEXT("generations"), Generations);
+	ParseInt(TEXT("population"), Population);
+	ParseInt(TEXT("seed"), Seed);
+	ParseFloat(TEXT("overshoot"), OvershootWeight);
+	ParseFloat(TEXT("settling"), SettlingWeight);
+	ParseFloat(TEXT("effort"), EffortWeight);
+	ParseFloat(TEXT("tolerance"), Tolerance);
+	Inertia = FVector(InertiaValue);
+	Population = FMath::Max(Population, 4);
+
+	if (DeltaTime <= 0.f || Mass <= 0.f || InertiaValue <= 0.f)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d The time step, mass and inertia have to be positive.."), *FString(__func__), __LINE__);
+		return 1;
+	}
+
+	const FString TrajectoryList = ParamVals.Contains(TEXT("trajectories")) ? ParamVals[TEXT("trajectories")] : TEXT("step,sine");
+	if (!LoadTrajectories(TrajectoryList))
+	{
+		return 1;
+	}
+
+	if (const FString* InPackagePath = ParamVals.Find(TEXT("path")))
+	{
+		PackagePath = *InPackagePath;
+	}
+	AssetName = ParamVals.Contains(TEXT("name")) ? ParamVals[TEXT("name")]
+		: FString::Printf(TEXT("MC6DGains_%s_%s"), *GetControlTypeName(LocControlType), *GetControlTypeName(RotControlType));
+	GainsPath = ParamVals.FindRef(TEXT("gains"));
+	BaselinePath = ParamVals.FindRef(TEXT("baseline"));
+	OutputPath = ParamVals.FindRef(TEXT("output"));
+	if (bBenchmark && OutputPath.IsEmpty())
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("MC6DBenchmark.json");
+	}
+
+	// Make sure the registry knows about the existing assets when running headless
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(FName("AssetRegistry"));
+	AssetRegistryModule.Get().SearchAllAssets(true);
+
+	bool bSuccess = false;
+	if (bThroughput)
+	{
+		bSuccess = Throughput(NumSteps);
+	}
+	else if (bBenchmark)
+	{
+		bSuccess = Benchmark();
+	}
+	else
+	{
+		bSuccess = Tune(!Switches.Contains(TEXT("nosave")));
+	}
+	return bSuccess ? 0 : 1;
+}
+
+// Tune the gains of the control types and write them as a data asset
+bool UMC6DTuneCommandlet::Tune(bool bSave)
+{
+	const FString LocTypeName = GetControlTypeName(LocControlType);
+	const FString RotTypeName = GetControlTypeName(RotControlType);
+
+	// Start from the default values of the control types
+	InitialGains = UMC6DTarget::GetDefaultGains(LocControlType, RotControlType);
+	const float InitialScore = Evaluate(InitialGains);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FMC6DGains BestGains = Search();
+	TArray<FMC6DResponseMetrics> BestMetrics;
+	const float BestScore = Evaluate(BestGains, &BestMetrics);
+
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Tuned %s/%s on %d trajectories in %.2fs; Score=%.4f->%.4f.."),
+		*FString(__func__), __LINE__, *LocTypeName, *RotTypeName, Trajectories.Num(), FPlatformTime::Seconds() - StartTime,
+		InitialScore, BestScore);
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Loc P=%f I=%f D=%f Max=%f; Rot P=%f I=%f D=%f Max=%f"),
+		*FString(__func__), __LINE__, BestGains.PLoc, BestGains.ILoc, BestGains.DLoc, BestGains.MaxLoc,
+		BestGains.PRot, BestGains.IRot, BestGains.DRot, BestGains.MaxRot);
+
+	TArray<TSharedPtr<FJsonValue>> Runs;
+	for (int32 Idx = 0; Idx < Trajectories.Num(); ++Idx)
+	{
+		Runs.Add(RunToJson(LocTypeName, RotTypeName, Trajectories[Idx].Name, BestGains, BestMetrics[Idx]));
+	}
+	if (!OutputPath.IsEmpty() && !WriteJson(Runs))
+	{
+		return false;
+	}
+	return !bSave || WriteDataAsset(BestGains);
+}
+
+// Replay the trajectories with every control type pair and write the response metrics
+bool UMC6DTuneCommandlet::Benchmark()
+{
+	// Benchmarked gains, the control type defaults if not given
+	const UMC6DBoneGainsDataAsset* GainsAsset = nullptr;
+	if (!GainsPath.IsEmpty())
+	{
+		GainsAsset = LoadObject<UMC6DBoneGainsDataAsset>(nullptr, *GainsPath);
+		if (!GainsAsset)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not load the gains %s.."), *FString(__func__), __LINE__, *GainsPath);
+			return false;
+		}
+
+		// The gains are only meaningful for the control type pair they were tuned for
+		if (GainsAsset->LocControlType != EMC6DControlType::NONE && GainsAsset->RotControlType != EMC6DControlType::NONE)
+		{
+			LocControlType = GainsAsset->LocControlType;
+			RotControlType = GainsAsset->RotControlType;
+			bAllLocControlTypes = false;
+			bAllRotControlTypes = false;
+		}
+		else if (bAllLocControlTypes || bAllRotControlTypes)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d The gains %s have no tuned control types, give a single pair with -loctype and -rottype.."),
+				*FString(__func__), __LINE__, *GainsPath);
+			return false;
+		}
+	}
+
+	// Control type pairs
+	TArray<TPair<EMC6DControlType, EMC6DControlType>> Pairs;
+	for (EMC6DControlType LocType : BenchmarkControlTypes)
+	{
+		if (!bAllLocControlTypes && LocType != LocControlType)
+		{
+			continue;
+		}
+		for (EMC6DControlType RotType : BenchmarkControlTypes)
+		{
+			if (bAllRotControlTypes || RotType == RotControlType)
+			{
+				Pairs.Add(TPair<EMC6DControlType, EMC6DControlType>(LocType, RotType));
+			}
+		}
+	}
+
+	// Every run is independent, replay them in parallel
+	const int32 NumTrajectories = Trajectories.Num();
+	const int32 NumRuns = Pairs.Num() * NumTrajectories;
+	TArray<FMC6DGains> Gains;
+	Gains.SetNum(NumRuns);
+	TArray<FMC6DResponseMetrics> Metrics;
+	Metrics.SetNum(NumRuns);
+	const double StartTime = FPlatformTime::Seconds();
+	ParallelFor(NumRuns, [&](int32 Idx)
+	{
+		const TPair<EMC6DControlType, EMC6DControlType>& Pair = Pairs[Idx / NumTrajectories];
+		Gains[Idx] = GainsAsset ? GainsAsset->DefaultGains : UMC6DTarget::GetDefaultGains(Pair.Key, Pair.Value);
+		Simulate(Pair.Key, Pair.Value, Gains[Idx], Trajectories[Idx % NumTrajectories], Metrics[Idx]);
+	});
+
+	TArray<TSharedPtr<FJsonValue>> Runs;
+	for (int32 Idx = 0; Idx < NumRuns; ++Idx)
+	{
+		const TPair<EMC6DControlType, EMC6DControlType>& Pair = Pairs[Idx / NumTrajectories];
+		const FString LocTypeName = GetControlTypeName(Pair.Key);
+		const FString RotTypeName = GetControlTypeName(Pair.Value);
+		const FString& TrajectoryName = Trajectories[Idx % NumTrajectories].Name;
+		const FMC6DResponseMetrics& Run = Metrics[Idx];
+		UE_LOG(LogTemp, Display, TEXT("%s::%d %s/%s/%s%s Loc: Rise=%.3fs Overshoot=%.3f Settling=%.3fs SSE=%.3fcm RMS=%.3fcm; Rot: Rise=%.3fs Overshoot=%.3f Settling=%.3fs SSE=%.3fdeg RMS=%.3fdeg"),
+			*FString(__func__), __LINE__, *LocTypeName, *RotTypeName, *TrajectoryName, Run.HasDiverged() ? TEXT(" (diverged)") : TEXT(""),
+			Run.Loc.RiseTime, Run.Loc.Overshoot, Run.Loc.SettlingTime, Run.Loc.SteadyStateError, Run.Loc.RMSError,
+			Run.Rot.RiseTime, Run.Rot.Overshoot, Run.Rot.SettlingTime, Run.Rot.SteadyStateError, Run.Rot.RMSError);
+		Runs.Add(RunToJson(LocTypeName, RotTypeName, TrajectoryName, Gains[Idx], Run));
+	}
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Benchmarked %d runs in %.2fs.."),
+		*FString(__func__), __LINE__, NumRuns, FPlatformTime::Seconds() - StartTime);
+
+	const bool bWritten = WriteJson(Runs);
+	return (BaselinePath.IsEmpty() || CheckBaseline(Runs)) && bWritten;
+}
+
+// Create or load the comma separated trajectories
+bool UMC6DTuneCommandlet::LoadTrajectories(const FString& InList)
+{
+	TArray<FString> Entries;
+	InList.ParseIntoArray(Entries, TEXT(","));
+	for (const FString& Entry : Entries)
+	{
+		if (Entry.Equals(TEXT("step"), ESearchCase::IgnoreCase))
+		{
+			Trajectories.Add(FMC6DTrajectory::MakeStep(FVector(10.f, 0.f, 0.f), FRotator(0.f, 45.f, 0.f)));
+		}
+		else if (Entry.Equals(TEXT("ramp"), ESearchCase::IgnoreCase))
+		{
+			Trajectories.Add(FMC6DTrajectory::MakeRamp(FVector(0.f, 0.f, 10.f), FRotator(0.f, 0.f, 45.f)));
+		}
+		else if (Entry.Equals(TEXT("sine"), ESearchCase::IgnoreCase))
+		{
+			Trajectories.Add(FMC6DTrajectory::MakeSine(FVector(0.f, 10.f, 0.f), FRotator(30.f, 0.f, 0.f), 1.f, 4.f));
+		}
+		else if (Entry.Equals(TEXT("sweep"), ESearchCase::IgnoreCase))
+		{
+			Trajectories.Add(FMC6DTrajectory::MakeSineSweep(FVector(10.f, 0.f, 0.f), FRotator(0.f, 30.f, 0.f), 0.2f, 4.f, 6.f));
+		}
+		else
+		{
+			FMC6DTrajectory Trajectory;
+			if (!FMC6DTrajectory::LoadFromFile(FPaths::ConvertRelativePathToFull(Entry), Trajectory))
+			{
+				return false;
+			}
+			Trajectories.Add(Trajectory);
+		}
+	}
+
+	if (Trajectories.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d No trajectories given (-trajectories=).."), *FString(__func__), __LINE__);
+		return false;
+	}
+	return true;
+}
+
+// Search the gains with a separable CMA-ES (diagonal covariance) in log10 gain space
+FMC6DGains UMC6DTuneCommandlet::Search()
+{
+	const int32 N = NumDims;
+	const int32 Lambda = Population;
+	const int32 Mu = Lambda / 2;
+
+	// Recombination weights
+	TArray<float> Weights;
+	Weights.SetNum(Mu);
+	float WeightSum = 0.f;
+	for (int32 Idx = 0; Idx < Mu; ++Idx)
+	{
+		Weights[Idx] = FMath::Loge(Mu + 0.5f) - FMath::Loge(Idx + 1.f);
+		WeightSum += Weights[Idx];
+	}
+	float WeightSqSum = 0.f;
+	for (float& Weight : Weights)
+	{
+		Weight /= WeightSum;
+		WeightSqSum += Weight * Weight;
+	}
+	const float MuEff = 1.f / WeightSqSum;
+
+	// Adaptation constants, the rank-one and rank-mu rates are scaled up for the diagonal covariance
+	const float CSigma = (MuEff + 2.f) / (N + MuEff + 5.f);
+	const float DSigma = 1.f + 2.f * FMath::Max(0.f, FMath::Sqrt((MuEff - 1.f) / (N + 1.f)) - 1.f) + CSigma;
+	const float Cc = (4.f + MuEff / N) / (N + 4.f + 2.f * MuEff / N);
+	const float DiagScale = (N + 2.f) / 3.f;
+	const float C1 = FMath::Min(1.f, DiagScale * 2.f / (FMath::Square(N + 1.3f) + MuEff));
+	const float CMu = FMath::Min(1.f - C1, DiagScale * 2.f * (MuEff - 2.f + 1.f / MuEff) / (FMath::Square(N + 2.f) + MuEff));
+	const float ChiN = FMath::Sqrt((float)N) * (1.f - 1.f / (4.f * N) + 1.f / (21.f * N * N));
+
+	// Start from the defaults, zero gains start from the lower part of the range
+	TArray<float> Mean;
+	Mean.Add(FMath::LogX(10.f, FMath::Max(InitialGains.PLoc, 0.01f)));
+	Mean.Add(FMath::LogX(10.f, FMath::Max(InitialGains.ILoc, 0.01f)));
+	Mean.Add(FMath::LogX(10.f, FMath::Max(InitialGains.DLoc, 0.01f)));
+	Mean.Add(FMath::LogX(10.f, FMath::Max(InitialGains.PRot, 0.01f)));
+	Mean.Add(FMath::LogX(10.f, FMath::Max(InitialGains.IRot, 0.01f)));
+	Mean.Add(FMath::LogX(10.f, FMath::Max(InitialGains.DRot, 0.01f)));
+	float Sigma = 0.5f;
+	TArray<float> C;
+	C.Init(1.f, N);
+	TArray<float> PathC;
+	PathC.Init(0.f, N);
+	TArray<float> PathSigma;
+	PathSigma.Init(0.f, N);
+
+	FRandomStream Random(Seed);
+	auto Gaussian = [&Random]()
+	{
+		// Box-Muller
+		const float U1 = FMath::Max(Random.GetFraction(), SMALL_NUMBER);
+		const float U2 = Random.GetFraction();
+		return FMath::Sqrt(-2.f * FMath::Loge(U1)) * FMath::Cos(2.f * PI * U2);
+	};
+
+	TArray<TArray<float>> Candidates;
+	Candidates.SetNum(Lambda);
+	TArray<float> Scores;
+	Scores.SetNumZeroed(Lambda);
+	TArray<int32> Order;
+	Order.SetNum(Lambda);
+
+	TArray<float> BestX = Mean;
+	float BestScore = Evaluate(ToGains(Mean));
+
+	for (int32 Gen = 0; Gen < Generations; ++Gen)
+	{
+		// Sample on the game thread, the random stream is not thread safe
+		for (TArray<float>& X : Candidates)
+		{
+			X.SetNum(N);
+			for (int32 Dim = 0; Dim < N; ++Dim)
+			{
+				X[Dim] = FMath::Clamp(Mean[Dim] + Sigma * FMath::Sqrt(C[Dim]) * Gaussian(), MinLogGain, MaxLogGain);
+			}
+		}
+
+		// The candidates are independent, replay them in parallel
+		ParallelFor(Lambda, [&](int32 Idx)
+		{
+			Scores[Idx] = Evaluate(ToGains(Candidates[Idx]));
+		});
+
+		for (int32 Idx = 0; Idx < Lambda; ++Idx)
+		{
+			Order[Idx] = Idx;
+		}
+		Order.Sort([&Scores](int32 A, int32 B) { return Scores[A] < Scores[B]; });
+		if (Scores[Order[0]] < BestScore)
+		{
+			BestScore = Scores[Order[0]];
+			BestX = Candidates[Order[0]];
+		}
+
+		// Move the mean towards the weighted best candidates
+		const TArray<float> OldMean = Mean;
+		for (int32 Dim = 0; Dim < N; ++Dim)
+		{
+			Mean[Dim] = 0.f;
+			for (int32 Idx = 0; Idx < Mu; ++Idx)
+			{
+				Mean[Dim] += Weights[Idx] * Candidates[Order[Idx]][Dim];
+			}
+		}
+
+		// Evolution paths
+		float PathSigmaSq = 0.f;
+		for (int32 Dim = 0; Dim < N; ++Dim)
+		{
+			const float Step = (Mean[Dim] - OldMean[Dim]) / Sigma;
+			PathSigma[Dim] = (1.f - CSigma) * PathSigma[Dim] + FMath::Sqrt(CSigma * (2.f - CSigma) * MuEff) * Step / FMath::Sqrt(C[Dim]);
+			PathSigmaSq += PathSigma[Dim] * PathSigma[Dim];
+		}
+		const float PathSigmaNorm = FMath::Sqrt(PathSigmaSq);
+		const bool bHSigma = PathSigmaNorm / FMath::Sqrt(1.f - FMath::Pow(1.f - CSigma, 2.f * (Gen + 1))) / ChiN < 1.4f + 2.f / (N + 1.f);
+
+		// Diagonal covariance update (rank-one and rank-mu)
+		for (int32 Dim = 0; Dim < N; ++Dim)
+		{
+			const float Step = (Mean[Dim] - OldMean[Dim]) / Sigma;
+			PathC[Dim] = (1.f - Cc) * PathC[Dim] + (bHSigma ? FMath::Sqrt(Cc * (2.f - Cc) * MuEff) * Step : 0.f);
+			float RankMu = 0.f;
+			for (int32 Idx = 0; Idx < Mu; ++Idx)
+			{
+				RankMu += Weights[Idx] * FMath::Square((Candidates[Order[Idx]][Dim] - OldMean[Dim]) / Sigma);
+			}
+			C[Dim] = (1.f - C1 - CMu) * C[Dim]
+				+ C1 * (PathC[Dim] * PathC[Dim] + (bHSigma ? 0.f : Cc * (2.f - Cc) * C[Dim]))
+				+ CMu * RankMu;
+			C[Dim] = FMath::Max(C[Dim], KINDA_SMALL_NUMBER);
+		}
+
+		// Step size control
+		Sigma *= FMath::Exp((CSigma / DSigma) * (PathSigmaNorm / ChiN - 1.f));
+		Sigma = FMath::Clamp(Sigma, KINDA_SMALL_NUMBER, MaxLogGain - MinLogGain);
+
+		UE_LOG(LogTemp, Display, TEXT("%s::%d Generation %d/%d; Best=%.4f; GenBest=%.4f; Sigma=%.4f.."),
+			*FString(__func__), __LINE__, Gen + 1, Generations, BestScore, Scores[Order[0]], Sigma);
+	}
+	return ToGains(BestX);
+}
+
+// Score the gains on all the trajectories
+float UMC6DTuneCommandlet::Evaluate(const FMC6DGains& InGains, TArray<FMC6DResponseMetrics>* OutMetrics) const
+{
+	float Score = 0.f;
+	FMC6DResponseMetrics Metrics;
+	for (const FMC6DTrajectory& Trajectory : Trajectories)
+	{
+		Simulate(LocControlType, RotControlType, InGains, Trajectory, Metrics);
+		Score += GetScore(Metrics, InGains);
+		if (OutMetrics)
+		{
+			OutMetrics->Add(Metrics);
+		}
+	}
+	return Score;
+}
+
+// Score the response metrics of a run
+float UMC6DTuneCommandlet::GetScore(const FMC6DResponseMetrics& InMetrics, const FMC6DGains& InGains) const
+{
+	if (InMetrics.HasDiverged())
+	{
+		return DivergenceScore;
+	}
+	const float Effort = InMetrics.Loc.Effort / FMath::Square(FMath::Max(InGains.MaxLoc, 1.f))
+		+ InMetrics.Rot.Effort / FMath::Square(FMath::Max(InGains.MaxRot, 1.f));
+	return InMetrics.Loc.RMSError / LocErrorScale + InMetrics.Rot.RMSError / RotErrorScale
+		+ OvershootWeight * (InMetrics.Loc.Overshoot + InMetrics.Rot.Overshoot)
+		+ SettlingWeight * FMath::Max(InMetrics.Loc.SettlingTime, InMetrics.Rot.SettlingTime)
+		+ EffortWeight * Effort;
+}
+
+// Replay the trajectory with the gains on the simulated body
+void UMC6DTuneCommandlet::Simulate(EMC6DControlType InLocControlType, EMC6DControlType InRotControlType, const FMC6DGains& InGains,
+	const FMC6DTrajectory& InTrajectory, FMC6DResponseMetrics& OutMetrics) const
+{
+	FMC6DSimBody Body;
+	InitBody(Body, InTrajectory.Sample(0.f));
+
+	FMCPIDController3D PIDLoc(InGains.PLoc, InGains.ILoc, InGains.DLoc, InGains.MaxLoc);
+	FMCPIDController3D PIDRot(InGains.PRot, InGains.IRot, InGains.DRot, InGains.MaxRot);
+
+	const int32 NumSteps = FMath::Max(FMath::CeilToInt(InTrajectory.GetDuration() / DeltaTime), 1);
+	OutMetrics.Begin(InTrajectory.GetHoldTime(), NumSteps * DeltaTime);
+	for (int32 StepIdx = 1; StepIdx <= NumSteps && !OutMetrics.HasDiverged(); ++StepIdx)
+	{
+		const float Time = StepIdx * DeltaTime;
+		const FTransform Target = InTrajectory.Sample(Time);
+		const FQuat TargetQuat = Target.GetRotation();
+
+		// Control outputs from the state before the step
+		const FVector OutLoc = PIDLoc.Update(Target.GetLocation() - Body.Location, Body.Location, DeltaTime);
+		const FVector RotError = FMC6DRotationError::Get(Body.Rotation, TargetQuat, RotErrorType, EMC6DRotationFrame::World);
+		const FVector OutRot = PIDRot.Update(RotError, DeltaTime);
+		Body.ApplyLocOutput(InLocControlType, OutLoc, Target.GetLocation());
+		Body.ApplyRotOutput(InRotControlType, OutRot, TargetQuat);
+		Body.Step(DeltaTime);
+
+		// Errors after the step, the rotation as a rotation vector in degrees
+		OutMetrics.Add(Time, DeltaTime, Target.GetLocation() - Body.Location,
+			FMath::RadiansToDegrees(FMC6DRotationError::LogMap(TargetQuat * Body.Rotation.Inverse())), OutLoc, OutRot);
+	}
+	OutMetrics.End();
+}
+
+// Measure the simulated steps per second
+bool UMC6DTuneCommandlet::Throughput(int32 InNumSteps)
+{
+	if (InNumSteps <= 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d The number of steps has to be positive.."), *FString(__func__), __LINE__);
+		return false;
+	}
+	const FMC6DGains Gains = UMC6DTarget::GetDefaultGains(LocControlType, RotControlType);
+
+	double StartTime = FPlatformTime::Seconds();
+	const float SingleError = RunSteps(InNumSteps, Gains);
+	const double SingleDuration = FPlatformTime::Seconds() - StartTime;
+
+	// One independent body per worker
+	const int32 NumWorkers = FMath::Max(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1);
+	TArray<float> Errors;
+	Errors.SetNumZeroed(NumWorkers);
+	StartTime = FPlatformTime::Seconds();
+	ParallelFor(NumWorkers, [&](int32 Idx)
+	{
+		Errors[Idx] = RunSteps(InNumSteps, Gains);
+	});
+	const double ParallelDuration = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Display, TEXT("%s::%d %s/%s on %s: %.0f steps/s single threaded, %.0f steps/s on %d workers (last error %.4f).."),
+		*FString(__func__), __LINE__, *GetControlTypeName(LocControlType), *GetControlTypeName(RotControlType), *Trajectories[0].Name,
+		InNumSteps / FMath::Max(SingleDuration, SMALL_NUMBER), (double)InNumSteps * NumWorkers / FMath::Max(ParallelDuration, SMALL_NUMBER),
+		NumWorkers, SingleError);
+	return FMath::IsFinite(SingleError);
+}
+
+// Run the controllers and the body for the number of steps looping the first trajectory
+float UMC6DTuneCommandlet::RunSteps(int32 InNumSteps, const FMC6DGains& InGains) const
+{
+	const FMC6DTrajectory& Trajectory = Trajectories[0];
+	const float Duration = FMath::Max(Trajectory.GetDuration(), DeltaTime);
+
+	FMC6DSimBody Body;
+	InitBody(Body, Trajectory.Sample(0.f));
+	FMCPIDController3D PIDLoc(InGains.PLoc, InGains.ILoc, InGains.DLoc, InGains.MaxLoc);
+	FMCPIDController3D PIDRot(InGains.PRot, InGains.IRot, InGains.DRot, InGains.MaxRot);
+
+	FVector LocError = FVector::ZeroVector;
+	float Time = 0.f;
+	for (int32 StepIdx = 0; StepIdx < InNumSteps; ++StepIdx)
+	{
+		Time += DeltaTime;
+		if (Time > Duration)
+		{
+			Time -= Duration;
+		}
+		const FTransform Target = Trajectory.Sample(Time);
+		const FQuat TargetQuat = Target.GetRotation();
+		LocError = Target.GetLocation() - Body.Location;
+		const FVector OutLoc = PIDLoc.Update(LocError, Body.Location, DeltaTime);
+		const FVector OutRot = PIDRot.Update(
+			FMC6DRotationError::Get(Body.Rotation, TargetQuat, RotErrorType, EMC6DRotationFrame::World), DeltaTime);
+		Body.ApplyLocOutput(LocControlType, OutLoc, Target.GetLocation());
+		Body.ApplyRotOutput(RotControlType, OutRot, TargetQuat);
+		Body.Step(DeltaTime);
+	}
+	return LocError.Size();
+}
+
+// Create the simulated body at the pose
+void UMC6DTuneCommandlet::InitBody(FMC6DSimBody& OutBody, const FTransform& InPose) const
+{
+	OutBody.Init(Mass, Inertia, LinearDamping, AngularDamping, FVector(0.f, 0.f, -Gravity));
+	OutBody.ContactRadius = ContactRadius;
+	if (bUseFloor)
+	{
+		OutBody.AddPlane(FMC6DSimPlane(FVector::UpVector, FVector(0.f, 0.f, FloorHeight)));
+	}
+	OutBody.SetPose(InPose);
+}
+
+// Write the runs as json
+bool UMC6DTuneCommandlet::WriteJson(const TArray<TSharedPtr<FJsonValue>>& InRuns) const
+{
+	TSharedRef<FJsonObject> JsonRoot = MakeShared<FJsonObject>();
+	JsonRoot->SetNumberField(TEXT("DeltaTime"), DeltaTime);
+	JsonRoot->SetNumberField(TEXT("Mass"), Mass);
+	JsonRoot->SetNumberField(TEXT("Inertia"), Inertia.X);
+	JsonRoot->SetNumberField(TEXT("LinearDamping"), LinearDamping);
+	JsonRoot->SetNumberField(TEXT("AngularDamping"), AngularDamping);
+	JsonRoot->SetNumberField(TEXT("Gravity"), Gravity);
+	JsonRoot->SetBoolField(TEXT("Floor"), bUseFloor);
+	JsonRoot->SetArrayField(TEXT("Runs"), InRuns);
+
+	FString JsonString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+	if (!FJsonSerializer::Serialize(JsonRoot, Writer) || !FFileHelper::SaveStringToFile(JsonString, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %s.."), *FString(__func__), __LINE__, *OutputPath);
+		return false;
+	}
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Wrote %d runs to %s.."), *FString(__func__), __LINE__, InRuns.Num(), *OutputPath);
+	return true;
+}
+
+// Compare the runs against the baseline json
+bool UMC6DTuneCommandlet::CheckBaseline(const TArray<TSharedPtr<FJsonValue>>& InRuns) const
+{
+	FString JsonString;
+	TSharedPtr<FJsonObject> JsonBaseline;
+	if (!FFileHelper::LoadFileToString(JsonString, *BaselinePath)
+		|| !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), JsonBaseline)
+		|| !JsonBaseline.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read the baseline %s.."), *FString(__func__), __LINE__, *BaselinePath);
+		return false;
+	}
+
+	// Baseline runs by name
+	TMap<FString, TSharedPtr<FJsonObject>> BaselineRuns;
+	for (const TSharedPtr<FJsonValue>& JsonRun : JsonBaseline->GetArrayField(TEXT("Runs")))
+	{
+		const TSharedPtr<FJsonObject> RunObject = JsonRun->AsObject();
+		BaselineRuns.Add(RunObject->GetStringField(TEXT("Name")), RunObject);
+	}
+
+	// Metrics where larger values are regressions
+	static const TCHAR* CheckedFields[] = { TEXT("RMSError"), TEXT("SteadyStateError"), TEXT("SettlingTime"), TEXT("Overshoot") };
+	static const TCHAR* CheckedGroups[] = { TEXT("Location"), TEXT("Rotation") };
+
+	int32 NumRegressions = 0;
+	for (const TSharedPtr<FJsonValue>& JsonRun : InRuns)
+	{
+		const TSharedPtr<FJsonObject> RunObject = JsonRun->AsObject();
+		const FString Name = RunObject->GetStringField(TEXT("Name"));
+		const TSharedPtr<FJsonObject>* BaselineRun = BaselineRuns.Find(Name);
+		if (!BaselineRun)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not in the baseline, skipping.."), *FString(__func__), __LINE__, *Name);
+			continue;
+		}
+		if (RunObject->GetBoolField(TEXT("Diverged")) && !(*BaselineRun)->GetBoolField(TEXT("Diverged")))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d %s diverged.."), *FString(__func__), __LINE__, *Name);
+			NumRegressions++;
+			continue;
+		}
+		for (const TCHAR* Group : CheckedGroups)
+		{
+			const TSharedPtr<FJsonObject> Current = RunObject->GetObjectField(Group);
+			const TSharedPtr<FJsonObject> Baseline = (*BaselineRun)->GetObjectField(Group);
+			for (const TCHAR* Field : CheckedFields)
+			{
+				const double CurrentValue = Current->GetNumberField(Field);
+				const double BaselineValue = Baseline->GetNumberField(Field);
+				if (CurrentValue > BaselineValue * (1. + Tolerance) + KINDA_SMALL_NUMBER)
+				{
+					UE_LOG(LogTemp, Error, TEXT("%s::%d %s %s %s regressed %f -> %f.."),
+						*FString(__func__), __LINE__, *Name, Group, Field, BaselineValue, CurrentValue);
+					NumRegressions++;
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Compared %d runs against %s; %d regressions.."),
+		*FString(__func__), __LINE__, InRuns.Num(), *BaselinePath, NumRegressions);
+	return NumRegressions == 0;
+}
+
+// Convert the search space (log10 of the gains) to gains
+FMC6DGains UMC6DTuneCommandlet::ToGains(const TArray<float>& InX) const
+{
+	FMC6DGains Gains = InitialGains;
+	Gains.PLoc = FMath::Pow(10.f, InX[0]);
+	Gains.ILoc = FMath::Pow(10.f, InX[1]);
+	Gains.DLoc = FMath::Pow(10.f, InX[2]);
+	Gains.PRot = FMath::Pow(10.f, InX[3]);
+	Gains.IRot = FMath::Pow(10.f, InX[4]);
+	Gains.DRot = FMath::Pow(10.f, InX[5]);
+	return Gains;
+}
+
+// Create or update the gains data asset and save its package
+bool UMC6DTuneCommandlet::WriteDataAsset(const FMC6DGains& InGains) const
+{
+	const FString PackageName = PackagePath / AssetName;
+	UPackage* AssetPackage = CreatePackage(nullptr, *PackageName);
+	AssetPackage->FullyLoad();
+
+	UMC6DBoneGainsDataAsset* DataAsset = FindObject<UMC6DBoneGainsDataAsset>(AssetPackage, *AssetName);
+	if (!DataAsset)
+	{
+		DataAsset = NewObject<UMC6DBoneGainsDataAsset>(AssetPackage, FName(*AssetName), RF_Standalone | RF_Public);
+		FAssetRegistryModule::AssetCreated(DataAsset);
+	}
+	DataAsset->DefaultGains = InGains;
+	DataAsset->LocControlType = LocControlType;
+	DataAsset->RotControlType = RotControlType;
+	DataAsset->MarkPackageDirty();
+
+	const FString PackageFileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+	if (!UPackage::SavePackage(AssetPackage, DataAsset, RF_Public | RF_Standalone, *PackageFileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Failed to save %s to %s.."), *FString(__func__), __LINE__, *AssetName, *PackageFileName);
+		return false;
+	}
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Saved the gains to %s.."), *FString(__func__), __LINE__, *PackageFileName);
+	return true;
+}
+
+// Parse the control type name, NONE if not supported by the tuning
+EMC6DControlType UMC6DTuneCommandlet::ParseControlType(const FString& InName, EMC6DControlType InDefault)
+{
+	if (InName.IsEmpty())
+	{
+		return InDefault;
+	}
+	if (InName.Equals(TEXT("Velocity"), ESearchCase::IgnoreCase))
+	{
+		return EMC6DControlType::Velocity;
+	}
+	if (InName.Equals(TEXT("Acceleration"), ESearchCase::IgnoreCase))
+	{
+		return EMC6DControlType::Acceleration;
+	}
+	if (InName.Equals(TEXT("Force"), ESearchCase::IgnoreCase))
+	{
+		return EMC6DControlType::Force;
+	}
+	if (InName.Equals(TEXT("Impulse"), ESearchCase::IgnoreCase))
+	{
+		return EMC6DControlType::Impulse;
+	}
+	return EMC6DControlType::NONE;
+}
+
+// Name of the supported control type
+FString UMC6DTuneCommandlet::GetControlTypeName(EMC6DControlType InType)
+{
+	switch (InType)
+	{
+	case EMC6DControlType::Velocity:
+		return TEXT("Velocity");
+	case EMC6DControlType::Acceleration:
+		return TEXT("Acceleration");
+	case EMC6DControlType::Force:
+		return TEXT("Force");
+	case EMC6DControlType::Impulse:
+		return TEXT("Impulse");
+	default:
+		return TEXT("NONE");
+	}
+}
@@ -0,0 +1,177 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MC6DControlType.h"
+#include "MC6DRotationError.h"
+#include "MC6DTrajectory.h"
+#include "MC6DResponseMetrics.h"
+#include "MC6DBoneGainsDataAsset.h"
+#include "MC6DTuneCommandlet.generated.h"
+
+/**
+ * Headless tuning and benchmarking of the 6D controller PID gains on a simulated rigid body,
+ * tune: the candidates are replayed in parallel and searched with a separable CMA-ES in log gain space
+ * benchmark: the response metrics of every control type pair are written as json and optionally checked against a baseline
+ * throughput: simulated steps per second of the controllers and the body, single threaded and on all cores
+ *
+ * Usage:
+ *	UE4Editor-Cmd <Project> -run=MC6DTune [-mode=<tune|benchmark|throughput>] [options]
+ *
+ * Options:
+ *	-trajectories=<step,ramp,sine,sweep,file.csv,..>	target trajectories to replay (default step,sine)
+ *	-loctype=<Velocity|Acceleration|Force|Impulse>	location control type (default Acceleration, benchmark: all)
+ *	-rottype=<Velocity|Acceleration|Force|Impulse>	rotation control type (default Velocity, benchmark: all)
+ *	-gains=<object path>	gains data asset to benchmark instead of the control type defaults, only on the control types it was tuned for
+ *	-roterror=<quat|log>	rotation error type (default quat)
+ *	-mass=<kg> -inertia=<kg*cm^2>	simulated body (default 1, 100)
+ *	-lindamping=<v> -angdamping=<v>	simulated body damping (default 0.01, 0)
+ *	-gravity=<cm/s^2>	gravity along -Z (default 0)
+ *	-floor=<z> -radius=<cm>	floor plane height and contact sphere radius of the body (default no floor, 5)
+ *	-dt=<s>		simulation time step (default 1/90)
+ *	-generations=<n> -population=<n> -seed=<n>	search settings (default 40, 16, 0)
+ *	-overshoot=<w> -settling=<w> -effort=<w>	score weights (default 10, 1, 0.01)
+ *	-path=<path>	package path of the gains data asset (default /UPhysicsBasedMC/Presets)
+ *	-name=<name>	name of the gains data asset (default MC6DGains_<LocType>_<RotType>)
+ *	-nosave		only report the best gains
+ *	-output=<file>	json file of the response metrics (default <Saved>/MC6DBenchmark.json, tune: only if given)
+ *	-baseline=<file>	benchmark json to compare against, fails if any error or settling time is worse
+ *	-tolerance=<ratio>	allowed relative regression against the baseline (default 0.05)
+ *	-steps=<n>	simulated steps per thread of the throughput (default 1000000)
+ */
+UCLASS()
+class UMC6DTuneCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Default constructor
+	UMC6DTuneCommandlet();
+
+	// Commandlet entry point
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Create or load the comma separated trajectories
+	bool LoadTrajectories(const FString& InList);
+
+	// Tune the gains of the control types and write them as a data asset
+	bool Tune(bool bSave);
+
+	// Replay the trajectories with every control type pair and write the response metrics
+	bool Benchmark();
+
+	// Measure the simulated steps per second
+	bool Throughput(int32 InNumSteps);
+
+	// Run the controllers and the body for the number of steps looping the first trajectory, returns the last error
+	float RunSteps(int32 InNumSteps, const FMC6DGains& InGains) const;
+
+	// Create the simulated body at the pose
+	void InitBody(struct FMC6DSimBody& OutBody, const FTransform& InPose) const;
+
+	// Search the gains, return the best candidate
+	FMC6DGains Search();
+
+	// Score the gains on all the trajectories, lower is better
+	float Evaluate(const FMC6DGains& InGains, TArray<FMC6DResponseMetrics>* OutMetrics = nullptr) const;
+
+	// Score the response metrics of a run
+	float GetScore(const FMC6DResponseMetrics& InMetrics, const FMC6DGains& InGains) const;
+
+	// Replay the trajectory with the gains on the simulated body
+	void Simulate(EMC6DControlType InLocControlType, EMC6DControlType InRotControlType, const FMC6DGains& InGains,
+		const FMC6DTrajectory& InTrajectory, FMC6DResponseMetrics& OutMetrics) const;
+
+	// Write the runs as json
+	bool WriteJson(const TArray<TSharedPtr<class FJsonValue>>& InRuns) const;
+
+	// Compare the runs against the baseline json, return false on regressions
+	bool CheckBaseline(const TArray<TSharedPtr<class FJsonValue>>& InRuns) const;
+
+	// Convert the search space (log10 of the gains) to gains
+	FMC6DGains ToGains(const TArray<float>& InX) const;
+
+	// Create or update the gains data asset and save its package
+	bool WriteDataAsset(const FMC6DGains& InGains) const;
+
+	// Parse the control type name, NONE if not supported by the tuning
+	static EMC6DControlType ParseControlType(const FString& InName, EMC6DControlType InDefault);
+
+	// Name of the supported control type
+	static FString GetControlTypeName(EMC6DControlType InType);
+
+private:
+	// Target trajectories
+	TArray<FMC6DTrajectory> Trajectories;
+
+	// Control types of the tuned gains
+	EMC6DControlType LocControlType;
+	EMC6DControlType RotControlType;
+
+	// Rotation error type
+	EMC6DRotationErrorType RotErrorType;
+
+	// Simulated body
+	float Mass;
+	FVector Inertia;
+	float LinearDamping;
+	float AngularDamping;
+	float Gravity;
+
+	// Floor plane
+	bool bUseFloor;
+	float FloorHeight;
+	float ContactRadius;
+
+	// Simulation time step
+	float DeltaTime;
+
+	// Search settings
+	int32 Generations;
+	int32 Population;
+	int32 Seed;
+
+	// Score weights
+	float OvershootWeight;
+	float SettlingWeight;
+	float EffortWeight;
+
+	// Starting point of the search, the output limits are kept
+	FMC6DGains InitialGains;
+
+	// Package path and name of the gains data asset
+	FString PackagePath;
+	FString AssetName;
+
+	// Benchmarked gains data asset (optional)
+	FString GainsPath;
+
+	// Json output and baseline files
+	FString OutputPath;
+	FString BaselinePath;
+
+	// Allowed relative regression against the baseline
+	float Tolerance;
+
+	// Benchmark every supported control type
+	bool bAllLocControlTypes;
+	bool bAllRotControlTypes;
+
+	// Number of searched gains (P, I, D of location and rotation)
+	static constexpr int32 NumDims = 6;
+
+	// Search bounds of the log10 gains
+	static constexpr float MinLogGain = -3.f;
+	static constexpr float MaxLogGain = 6.f;
+
+	// Error scales of the score (cm, deg)
+	static constexpr float LocErrorScale = 1.f;
+	static constexpr float RotErrorScale = 1.f;
+
+	// Score of unstable candidates
+	static constexpr float DivergenceScore = 1000000.f;
+};
@@ -43,6 +43,9 @@ public class UMC6DControllerGUI : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"UMCPIDController",
+				"AssetRegistry",
+				"Json",
 				//"KantanChartsSlate",
 				// ... add private dependencies that you statically link with here ...	
 			}
@@ -32,6 +32,9 @@ UMCGraspAnimController::UMCGraspAnimController()
 	ActiveAnimIdx = INDEX_NONE;
 	bIsIdle = true;
 	bIsMax = false;
+
+	// Finer threshold, the frames are interpolated
+	InputFilter.Hysteresis = 0.01f;
 }
 
 // Called when the game starts
@@ -42,6 +45,15 @@ void UMCGraspAnimController::BeginPlay()
 	Init();
 }
 
+// Called when the game ends
+void UMCGraspAnimController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UE_LOG(LogTemp, Log, TEXT("%s::%d [%s] Input filter: %s"),
+		*FString(__func__), __LINE__, *InputAxisName.ToString(), *InputFilter.GetStatsString());
+
+	Super::EndPlay(EndPlayReason);
+}
+
 #if WITH_EDITOR
 // Called when a property is changed in the editor
 void UMCGraspAnimController::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
@@ -94,8 +106,7 @@ void UMCGraspAnimController::Init()
 
 	// Go to the first animations
 	ActiveAnimIdx = 0;
-	ActiveAnimation = Animations[0];
-	ActiveAnimStepSize = 1.f / static_cast<float>(ActiveAnimation.Num() - 1);
+	ActiveAnimStepSize = 1.f / static_cast<float>(Animations[ActiveAnimIdx].NumFrames - 1);
 
 	OnGraspType.Broadcast(AnimationNames[ActiveAnimIdx]);
 
@@ -156,8 +167,16 @@ bool UMCGraspAnimController::LoadAnimationData()
 
 	for (const auto& AnimationDataAsset : AnimationDataAssets)
 	{
+		// Prefer the compressed tracks if available
+		FLoadedAnimation& CurrAnim = Animations.AddDefaulted_GetRef();
+		AnimationNames.Add(AnimationDataAsset->Name);
+		if (AnimationDataAsset->CompressedData.IsValid())
+		{
+			LoadCompressedAnimation(AnimationDataAsset->CompressedData, CurrAnim);
+			continue;
+		}
+
 		// Iterate frames from the animation
-		FAnimation CurrAnim;
 		for (const auto& Frame : AnimationDataAsset->Frames)
 		{
 			// Iterate data from the frame and cache it
@@ -173,19 +192,75 @@ bool UMCGraspAnimController::LoadAnimationData()
 					UE_LOG(LogTemp, Error, TEXT("%s::%d Could not find constraint %s"), *FString(__func__), __LINE__, *BoneData.Key);
 				}
 			}
-			CurrAnim.Add(CurrFrame);
+			CurrAnim.Frames.Add(CurrFrame);
+		}
+		CurrAnim.NumFrames = CurrAnim.Frames.Num();
+	}
+
+	// At least two frames are needed to interpolate
+	for (int32 AnimIdx = Animations.Num() - 1; AnimIdx >= 0; --AnimIdx)
+	{
+		if (Animations[AnimIdx].NumFrames < 2)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Animation %s has less than two frames, it is skipped.."),
+				*FString(__func__), __LINE__, *AnimationNames[AnimIdx]);
+			Animations.RemoveAt(AnimIdx);
+			AnimationNames.RemoveAt(AnimIdx);
 		}
-		Animations.Add(CurrAnim);
-		AnimationNames.Add(AnimationDataAsset->Name);
 	}
 	return Animations.Num() > 0;
 }
 
+// Find the constraints of the compressed tracks, the tracks are sampled at runtime
+void UMCGraspAnimController::LoadCompressedAnimation(const FMCGraspAnimCompressedData& CompressedData, FLoadedAnimation& OutAnimation)
+{
+	// Find the constraint of every track only once
+	for (const auto& Track : CompressedData.Tracks)
+	{
+		if (FConstraintInstance* CI = SkelComp->FindConstraintInstance(FName(*Track.BoneName)))
+		{
+			OutAnimation.Tracks.Emplace(CI, &Track);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not find constraint %s"), *FString(__func__), __LINE__, *Track.BoneName);
+		}
+	}
+	OutAnimation.NumFrames = CompressedData.NumFrames;
+}
+
+// Set the cached target to the (fractional) frame position of the active animation
+void UMCGraspAnimController::SetTargetAtFrame(float FramePos)
+{
+	const FLoadedAnimation& Animation = Animations[ActiveAnimIdx];
+	if (Animation.Tracks.Num() > 0)
+	{
+		for (const auto& CT : Animation.Tracks)
+		{
+			DriveTarget.Add(CT.Key, CT.Value->Sample(FramePos));
+		}
+		return;
+	}
+
+	// Nearest smaller frame and the blend value towards the following one, e.g: 1.66f - 1.f = 0.66f
+	const int32 FrameIndex = FMath::Clamp(static_cast<int32>(FramePos), 0, Animation.NumFrames - 1);
+	const float Alpha = FramePos - static_cast<float>(FrameIndex);
+	if (Alpha <= 0.f || FrameIndex == Animation.NumFrames - 1)
+	{
+		DriveTarget = Animation.Frames[FrameIndex];
+	}
+	else
+	{
+		SetTargetUsingLerp(Animation.Frames[FrameIndex], Animation.Frames[FrameIndex + 1], Alpha);
+	}
+}
+
 // Set the motors target value to the first frame
 void UMCGraspAnimController::DriveToFirstFrame()
 {
 	SpringActive = SpringIdle;
-	DriveTarget = ActiveAnimation[0];
+	DriveTarget.Reset();
+	SetTargetAtFrame(0.f);
 	DriveToTarget();
 }
 
@@ -195,7 +270,7 @@ void UMCGraspAnimController::DriveToLastFrame()
 	//SpringActive = SpringIdle + (SpringIdle * TriggerStrength);
 	const float Strength = bDecreaseStrength ? 1.f / (1.f + TriggerStrength) : 1.f + TriggerStrength;
 	SpringActive = SpringIdle * Strength;
-	DriveTarget = ActiveAnimation[ActiveAnimation.Num()-1];
+	SetTargetAtFrame(static_cast<float>(Animations[ActiveAnimIdx].NumFrames - 1));
 	DriveToTarget();
 }
 
@@ -250,6 +325,12 @@ int32 UMCGraspAnimController::GetActiveFrameIndex(float Value)
 // Forward the axis input value to the grasp animation executor
 void UMCGraspAnimController::GraspUpdateCallback(float Value)
 {
+	// Skip the update if the input did not change enough
+	if (!InputFilter.Filter(Value, GetWorld()->GetDeltaSeconds(), Value))
+	{
+		return;
+	}
+
 	// If value is almost 1.0, go to the final frame directly
 	if (Value > 0.98f)
 	{
@@ -272,20 +353,11 @@ void UMCGraspAnimController::GraspUpdateCallback(float Value)
 		SpringActive = SpringIdle * Strength;
 		
 		// Checks in which position we are between the frist frame (0.f) .. () ..  () .. and last frame ((Num()-1).f) 
-		float ValueOnTheFrameAxis = Value / ActiveAnimStepSize;
-
-		// Fast floor by casting to in this gives us the nearest smaller frame index
-		int32 FrameIndex = static_cast<int32>(ValueOnTheFrameAxis);
-
-		// Gets the value between [0.f,1.f] on how to blend between the frames e.g: 1.66f - 1.f = 0.66f
-		float Alpha = ValueOnTheFrameAxis - static_cast<float>(FrameIndex);
+		const float ValueOnTheFrameAxis = Value / ActiveAnimStepSize;
 
 		// Set the driver target by interpolating between the nearest smaller frame and the following one
-		SetTargetUsingLerp(ActiveAnimation[FrameIndex], ActiveAnimation[FrameIndex + 1], Alpha);
+		SetTargetAtFrame(ValueOnTheFrameAxis);
 		DriveToTarget();
-
-		//UE_LOG(LogTemp, Warning, TEXT("%s::%d \n\t Value=%f; \n\t ValueOnTheFrameAxis=%f; \n\t FrameIndex=%d; \n\t Alpha=%f; \n\t ActiveAnimStepSize=%f; \n\t Num=%d"),
-		//	*FString(__func__), __LINE__, Value, ValueOnTheFrameAxis, FrameIndex, Alpha, ActiveAnimStepSize, ActiveAnimation.Num());
 	}
 	else if(!bIsIdle)
 	{
@@ -302,8 +374,7 @@ void UMCGraspAnimController::GotoNextAnimationCallback()
 	{
 		// Increase the index, if it is the last in the array, set it back to 0
 		ActiveAnimIdx = ActiveAnimIdx >= Animations.Num() - 1 ? 0 : ActiveAnimIdx + 1;
-		ActiveAnimation = Animations[ActiveAnimIdx];
-		ActiveAnimStepSize = 1.f / static_cast<float>(ActiveAnimation.Num() - 1);
+		ActiveAnimStepSize = 1.f / static_cast<float>(Animations[ActiveAnimIdx].NumFrames - 1);
 
 		DriveToFirstFrame();
 		if (bLogDebug)
@@ -333,8 +404,7 @@ void UMCGraspAnimController::GotoPreviousAnimationCallback()
 	{
 		// Decrease the index, if it becomes smaller than 0, set it to the last the array
 		ActiveAnimIdx = ActiveAnimIdx <= 0 ? Animations.Num() - 1 : ActiveAnimIdx - 1;
-		ActiveAnimation = Animations[ActiveAnimIdx];
-		ActiveAnimStepSize = 1.f / static_cast<float>(ActiveAnimation.Num() - 1);
+		ActiveAnimStepSize = 1.f / static_cast<float>(Animations[ActiveAnimIdx].NumFrames - 1);
 
 		DriveToFirstFrame();
 		if (bLogDebug)
@@ -0,0 +1,67 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#include "MCGraspAnimDataAsset.h"
+#include "Algo/BinarySearch.h"
+
+// Get the rotation of the given key, normalized to (-180, 180] as the uncompressed frames
+FRotator FMCGraspAnimCompressedTrack::GetKey(int32 KeyIdx) const
+{
+	const int32 ValueIdx = KeyIdx * 3;
+	return FRotator(FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(KeyValues[ValueIdx])),
+		FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(KeyValues[ValueIdx + 1])),
+		FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(KeyValues[ValueIdx + 2])));
+}
+
+// Sample the track at the given (fractional) frame position by interpolating between the neighbouring keys
+FRotator FMCGraspAnimCompressedTrack::Sample(float FramePos) const
+{
+	if (KeyFrames.Num() < 2 || FramePos <= KeyFrames[0])
+	{
+		return GetKey(0);
+	}
+	
+	// Index of the first key after the frame position
+	const int32 NextKeyIdx = Algo::UpperBound(KeyFrames, FramePos);
+	if (NextKeyIdx >= KeyFrames.Num())
+	{
+		return GetKey(KeyFrames.Num() - 1);
+	}
+
+	const int32 PrevKeyIdx = NextKeyIdx - 1;
+	const float Alpha = (FramePos - KeyFrames[PrevKeyIdx]) / static_cast<float>(KeyFrames[NextKeyIdx] - KeyFrames[PrevKeyIdx]);
+	return FMath::LerpRange(GetKey(PrevKeyIdx), GetKey(NextKeyIdx), Alpha).GetNormalized();
+}
+
+// Strip the frames of the compressed animations from the cooked asset
+void UMCGraspAnimDataAsset::Serialize(FArchive& Ar)
+{
+#if WITH_EDITOR
+	// The cooked builds sample the compressed tracks, the frames are only needed for editing
+	if (Ar.IsCooking() && CompressedData.IsValid())
+	{
+		TArray<FMCGraspAnimFrameData> EditorFrames = MoveTemp(Frames);
+		Super::Serialize(Ar);
+		Frames = MoveTemp(EditorFrames);
+		return;
+	}
+#endif // WITH_EDITOR
+	Super::Serialize(Ar);
+}
+
+#if WITH_EDITOR
+// Called when a property is changed in the editor
+void UMCGraspAnimDataAsset::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// The compressed keys no longer match the edited frames, fall back to the frames until recompressed
+	const FName MemberPropertyName = (PropertyChangedEvent.MemberProperty != nullptr) ?
+		PropertyChangedEvent.MemberProperty->GetFName() : NAME_None;
+	if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(UMCGraspAnimDataAsset, Frames) && CompressedData.IsValid())
+	{
+		CompressedData = FMCGraspAnimCompressedData();
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s frames edited, the compressed data was cleared (recompress the asset).."),
+			*FString(__func__), __LINE__, *Name);
+	}
+}
+#endif // WITH_EDITOR
@@ -27,9 +27,8 @@ UMCGraspBasicController::UMCGraspBasicController()
 	Damping = 500.0f;
 	ForceLimit = 250000.0f;
 
-	// Previous input value
-	PrevInputVal = 0.f;
 	MaxAngleMultiplier = 55.f;
+	bUseSkeletalTypeHysteresis = true;
 }
 
 // Called when the game starts
@@ -41,6 +40,15 @@ void UMCGraspBasicController::BeginPlay()
 	Init();
 }
 
+// Called when the game ends
+void UMCGraspBasicController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UE_LOG(LogTemp, Log, TEXT("%s::%d [%s] Input filter: %s"),
+		*FString(__func__), __LINE__, *InputAxisName.ToString(), *InputFilter.GetStatsString());
+
+	Super::EndPlay(EndPlayReason);
+}
+
 #if WITH_EDITOR
 // Called when a property is changed in the editor
 void UMCGraspBasicController::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
@@ -74,6 +82,12 @@ void UMCGraspBasicController::Init()
 		return;
 	}
 
+	// The genesis hands use a coarser threshold
+	if (bUseSkeletalTypeHysteresis)
+	{
+		InputFilter.Hysteresis = SkeletalType == EMCSkeletalType::Genesis ? 0.05f : FMCInputFilter().Hysteresis;
+	}
+
 	// Check that owner is a skeletal mesh actor and has a valid skeletal mesh component
 	if (ASkeletalMeshActor* OwnerAsSkelMA = Cast<ASkeletalMeshActor>(GetOwner()))
 	{
@@ -135,9 +149,8 @@ void UMCGraspBasicController::Init()
 void UMCGraspBasicController::Update(float Value)
 {
 	// Skip iterating constraints for small changes
-	if (FMath::Abs(Value - PrevInputVal) > 0.025)
+	if (InputFilter.Filter(Value, GetWorld()->GetDeltaSeconds(), Value))
 	{
-		PrevInputVal = Value;
 		// Apply target to fingers
 		for (auto& ConstraintInstance : SkeletalMesh->Constraints)
 		{
@@ -150,9 +163,8 @@ void UMCGraspBasicController::Update(float Value)
 void UMCGraspBasicController::Update_IAI(float Value)
 {
 	// Skip iterating constraints for small changes
-	if (FMath::Abs(Value - PrevInputVal) > 0.025)
+	if (InputFilter.Filter(Value, GetWorld()->GetDeltaSeconds(), Value))
 	{
-		PrevInputVal = Value;
 		// Apply target to fingers
 		for (auto& ConstraintInstance : SkeletalMesh->Constraints)
 		{
@@ -172,9 +184,8 @@ void UMCGraspBasicController::Update_IAI(float Value)
 void UMCGraspBasicController::Update_Genesis(float Value)
 {
 	// Skip iterating constraints for small changes
-	if (FMath::Abs(Value - PrevInputVal) > 0.05)
+	if (InputFilter.Filter(Value, GetWorld()->GetDeltaSeconds(), Value))
 	{
-		PrevInputVal = Value;
 
 		if (HandType == EMCHandType::Right)
 		{
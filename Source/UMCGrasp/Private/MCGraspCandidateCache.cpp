@@ -0,0 +1,143 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCGraspCandidateCache.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/ShapeComponent.h"
+
+// Get the shared cache
+FMCGraspCandidateCache& FMCGraspCandidateCache::Get()
+{
+	static FMCGraspCandidateCache Instance;
+	return Instance;
+}
+
+// Check if the component is a semantic contact monitor area of a static mesh actor
+bool FMCGraspCandidateCache::IsContactMonitor(UPrimitiveComponent* InComponent)
+{
+	if (!InComponent)
+	{
+		return false;
+	}
+
+	if (const bool* bIsContactMonitor = ContactMonitorFlags.Find(InComponent))
+	{
+		return *bIsContactMonitor;
+	}
+
+	if (++NumInsertsSinceCleanup > CleanupInterval)
+	{
+		RemoveStaleEntries();
+	}
+	const bool bIsContactMonitor = InComponent->GetName().StartsWith("SLContactMonitor")
+		&& Cast<AStaticMeshActor>(InComponent->GetOwner()) != nullptr;
+	ContactMonitorFlags.Add(InComponent, bIsContactMonitor);
+	return bIsContactMonitor;
+}
+
+// Get the candidate data of the actor, computed on the first call, the mass is refreshed if the body mass settings changed
+FMCGraspCandidateInfo FMCGraspCandidateCache::GetInfo(AStaticMeshActor* InActor)
+{
+	if (FMCGraspCandidateInfo* Info = CandidateInfos.Find(InActor))
+	{
+		if (Info->bHasStaticMesh)
+		{
+			UpdateMass(InActor, *Info);
+		}
+		return *Info;
+	}
+
+	if (++NumInsertsSinceCleanup > CleanupInterval)
+	{
+		RemoveStaleEntries();
+	}
+	return CandidateInfos.Add(InActor, ComputeInfo(InActor));
+}
+
+// Remove the cached data of the actor (e.g. if its components changed)
+void FMCGraspCandidateCache::Invalidate(AStaticMeshActor* InActor)
+{
+	CandidateInfos.Remove(InActor);
+	for (auto Itr = ContactMonitorFlags.CreateIterator(); Itr; ++Itr)
+	{
+		if (!Itr.Key().IsValid() || Itr.Key()->GetOwner() == InActor)
+		{
+			Itr.RemoveCurrent();
+		}
+	}
+}
+
+// Compute the candidate data of the actor
+FMCGraspCandidateInfo FMCGraspCandidateCache::ComputeInfo(AStaticMeshActor* InActor)
+{
+	FMCGraspCandidateInfo Info;
+	if (!InActor || InActor->IsPendingKillOrUnreachable())
+	{
+		return Info;
+	}
+
+	Info.bIsMovable = InActor->IsRootComponentMovable();
+	if (UStaticMeshComponent* SMC = InActor->GetStaticMeshComponent())
+	{
+		Info.bHasStaticMesh = true;
+		UpdateMass(InActor, Info);
+	}
+	Info.BoundsVolume = InActor->GetComponentsBoundingBox().GetVolume();
+
+	// Check if object has a contact area
+#if ENGINE_MINOR_VERSION > 23 || ENGINE_MAJOR_VERSION > 4
+	TArray<UActorComponent*> Components;
+	InActor->GetComponents(UShapeComponent::StaticClass(), Components);
+#else
+	const TArray<UActorComponent*> Components = InActor->GetComponentsByClass(UShapeComponent::StaticClass());
+#endif
+	for (const auto C : Components)
+	{
+		if (C->GetName().StartsWith("SLContactMonitor"))
+		{
+			Info.bHasContactMonitor = true;
+			break;
+		}
+	}
+	return Info;
+}
+
+// Recompute the mass if the mass scale or override of the body changed (they can be set at runtime)
+void FMCGraspCandidateCache::UpdateMass(AStaticMeshActor* InActor, FMCGraspCandidateInfo& InOutInfo)
+{
+	UStaticMeshComponent* SMC = InActor ? InActor->GetStaticMeshComponent() : nullptr;
+	FBodyInstance* BI = SMC ? SMC->GetBodyInstance() : nullptr;
+	if (!BI)
+	{
+		return;
+	}
+
+	const float MassOverride = BI->bOverrideMass ? BI->GetMassOverride() : -1.f;
+	if (BI->MassScale != InOutInfo.MassScale || MassOverride != InOutInfo.MassOverride)
+	{
+		InOutInfo.Mass = SMC->GetMass();
+		InOutInfo.MassScale = BI->MassScale;
+		InOutInfo.MassOverride = MassOverride;
+	}
+}
+
+// Remove the entries of the destroyed objects, called periodically on inserts
+void FMCGraspCandidateCache::RemoveStaleEntries()
+{
+	NumInsertsSinceCleanup = 0;
+	for (auto Itr = ContactMonitorFlags.CreateIterator(); Itr; ++Itr)
+	{
+		if (!Itr.Key().IsValid())
+		{
+			Itr.RemoveCurrent();
+		}
+	}
+	for (auto Itr = CandidateInfos.CreateIterator(); Itr; ++Itr)
+	{
+		if (!Itr.Key().IsValid())
+		{
+			Itr.RemoveCurrent();
+		}
+	}
+}
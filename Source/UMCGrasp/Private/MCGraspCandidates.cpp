@@ -0,0 +1,178 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCGraspCandidates.h"
+#include "Engine/StaticMeshActor.h"
+#include "CoreGlobals.h"
+
+// Default ctor
+FMCGraspCandidates::FMCGraspCandidates()
+{
+	ApproachWeight = 0.5f;
+	LastRefreshFrame = 0;
+}
+
+// Add the candidate (no-op if already present)
+void FMCGraspCandidates::Add(AStaticMeshActor* InActor, const FVector& InCenter, const FVector& InApproachDir)
+{
+	if (!InActor)
+	{
+		return;
+	}
+
+	if (const int32* ExistingIdx = EntryIndices.Find(InActor))
+	{
+		if (Entries[*ExistingIdx].Actor.IsValid())
+		{
+			return;
+		}
+		// Stale entry of a destroyed actor with the same address
+		RemoveAt(*ExistingIdx);
+	}
+
+	const int32 Idx = Entries.Add({ InActor, InActor, ComputeScore(InActor, InCenter, InApproachDir) });
+	EntryIndices.Add(InActor, Idx);
+	SiftUp(Idx);
+}
+
+// Remove the candidate, return true if it was present
+bool FMCGraspCandidates::Remove(AStaticMeshActor* InActor)
+{
+	if (const int32* Idx = EntryIndices.Find(InActor))
+	{
+		RemoveAt(*Idx);
+		return true;
+	}
+	return false;
+}
+
+// Remove all the candidates
+void FMCGraspCandidates::Empty()
+{
+	Entries.Empty();
+	EntryIndices.Empty();
+}
+
+// Update the score of every candidate and rebuild the heap, at most once per frame (later calls in the same frame are skipped)
+void FMCGraspCandidates::Refresh(const FVector& InCenter, const FVector& InApproachDir)
+{
+	if (LastRefreshFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastRefreshFrame = GFrameCounter;
+
+	for (FEntry& Entry : Entries)
+	{
+		if (AStaticMeshActor* Actor = Entry.Actor.Get())
+		{
+			Entry.Score = ComputeScore(Actor, InCenter, InApproachDir);
+		}
+	}
+	for (int32 Idx = Entries.Num() / 2 - 1; Idx >= 0; --Idx)
+	{
+		SiftDown(Idx);
+	}
+}
+
+// Get the best candidate, nullptr if there are no valid candidates
+AStaticMeshActor* FMCGraspCandidates::GetBest()
+{
+	// Drop the destroyed actors reaching the top
+	while (Entries.Num() > 0 && !Entries[0].Actor.IsValid())
+	{
+		RemoveAt(0);
+	}
+	return Entries.Num() > 0 ? Entries[0].Actor.Get() : nullptr;
+}
+
+// Remove and return the best candidate
+AStaticMeshActor* FMCGraspCandidates::PopBest()
+{
+	AStaticMeshActor* Best = GetBest();
+	if (Best)
+	{
+		RemoveAt(0);
+	}
+	return Best;
+}
+
+// Compute the score of the actor (lower is better)
+float FMCGraspCandidates::ComputeScore(AStaticMeshActor* InActor, const FVector& InCenter, const FVector& InApproachDir) const
+{
+	const FVector ToActor = InActor->GetActorLocation() - InCenter;
+	const float Dist = ToActor.Size();
+	if (Dist < KINDA_SMALL_NUMBER || InApproachDir.IsZero())
+	{
+		return Dist;
+	}
+
+	// Objects in front of the moving hand are preferred
+	const float CosAngle = FVector::DotProduct(ToActor / Dist, InApproachDir);
+	return Dist * (1.f - ApproachWeight * CosAngle);
+}
+
+// Remove the entry at the given heap index
+void FMCGraspCandidates::RemoveAt(int32 Idx)
+{
+	const int32 LastIdx = Entries.Num() - 1;
+	EntryIndices.Remove(Entries[Idx].Key);
+	if (Idx != LastIdx)
+	{
+		Entries[Idx] = Entries[LastIdx];
+		EntryIndices.Add(Entries[Idx].Key, Idx);
+	}
+	Entries.RemoveAt(LastIdx, 1, false);
+
+	// The moved entry can go either way
+	if (Idx < Entries.Num())
+	{
+		SiftDown(SiftUp(Idx));
+	}
+}
+
+// Move the entry towards the root until the heap order holds, return its new index
+int32 FMCGraspCandidates::SiftUp(int32 Idx)
+{
+	while (Idx > 0)
+	{
+		const int32 ParentIdx = (Idx - 1) / 2;
+		if (Entries[ParentIdx].Score <= Entries[Idx].Score)
+		{
+			break;
+		}
+		SwapEntries(Idx, ParentIdx);
+		Idx = ParentIdx;
+	}
+	return Idx;
+}
+
+// Move the entry towards the leaves until the heap order holds
+void FMCGraspCandidates::SiftDown(int32 Idx)
+{
+	const int32 Num = Entries.Num();
+	while (true)
+	{
+		const int32 LeftIdx = 2 * Idx + 1;
+		if (LeftIdx >= Num)
+		{
+			break;
+		}
+		const int32 RightIdx = LeftIdx + 1;
+		const int32 ChildIdx = RightIdx < Num && Entries[RightIdx].Score < Entries[LeftIdx].Score ? RightIdx : LeftIdx;
+		if (Entries[Idx].Score <= Entries[ChildIdx].Score)
+		{
+			break;
+		}
+		SwapEntries(Idx, ChildIdx);
+		Idx = ChildIdx;
+	}
+}
+
+// Swap two entries and their indices
+void FMCGraspCandidates::SwapEntries(int32 A, int32 B)
+{
+	Swap(Entries[A], Entries[B]);
+	EntryIndices.FindChecked(Entries[A].Key) = A;
+	EntryIndices.FindChecked(Entries[B].Key) = B;
+}
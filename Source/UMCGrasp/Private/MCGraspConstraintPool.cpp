@@ -0,0 +1,76 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCGraspConstraintPool.h"
+#include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+// Sets default values
+AMCGraspConstraintPool::AMCGraspConstraintPool()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+// Get the pool of the world, spawn it if it does not exist
+AMCGraspConstraintPool* AMCGraspConstraintPool::Get(UWorld* InWorld)
+{
+	if (!InWorld)
+	{
+		return nullptr;
+	}
+
+	for (TActorIterator<AMCGraspConstraintPool> Itr(InWorld); Itr; ++Itr)
+	{
+		return *Itr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Name = FName("MCGraspConstraintPool");
+	SpawnParams.ObjectFlags |= RF_Transient;
+	return InWorld->SpawnActor<AMCGraspConstraintPool>(SpawnParams);
+}
+
+// Make sure at least the given number of components are free (call at init time)
+void AMCGraspConstraintPool::Reserve(int32 NumFree)
+{
+	while (FreeComponents.Num() < NumFree)
+	{
+		UPhysicsConstraintComponent* ConstraintComp = NewObject<UPhysicsConstraintComponent>(this);
+		ConstraintComp->SetupAttachment(RootComponent);
+		ConstraintComp->RegisterComponent();
+		AllComponents.Add(ConstraintComp);
+		FreeComponents.Add(ConstraintComp);
+	}
+}
+
+// Borrow a component with the given profile, attached to the parent, nullptr if the pool is empty
+UPhysicsConstraintComponent* AMCGraspConstraintPool::Borrow(const FConstraintProfileProperties& InProfile, USceneComponent* InParent, FName InSocketName)
+{
+	if (FreeComponents.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d No free constraint components, reserve more at init.."), *FString(__FUNCTION__), __LINE__);
+		return nullptr;
+	}
+
+	UPhysicsConstraintComponent* ConstraintComp = FreeComponents.Pop(false);
+	ConstraintComp->ConstraintInstance.ProfileInstance = InProfile;
+	ConstraintComp->AttachToComponent(InParent, FAttachmentTransformRules::SnapToTargetIncludingScale, InSocketName);
+	return ConstraintComp;
+}
+
+// Break the constraint and give the component back to the pool
+void AMCGraspConstraintPool::Return(UPhysicsConstraintComponent* InConstraintComp)
+{
+	if (!InConstraintComp || !AllComponents.Contains(InConstraintComp))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d The component is not part of the pool.."), *FString(__FUNCTION__), __LINE__);
+		return;
+	}
+
+	InConstraintComp->BreakConstraint();
+	InConstraintComp->AttachToComponent(RootComponent, FAttachmentTransformRules::SnapToTargetIncludingScale);
+	FreeComponents.AddUnique(InConstraintComp);
+}
@@ -2,6 +2,7 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "MCGraspFixation.h"
+#include "MCGraspCandidateCache.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "Engine/StaticMeshActor.h"
 #include "Components/StaticMeshComponent.h"
@@ -13,7 +14,9 @@ UMCGraspFixation::UMCGraspFixation()
 {	
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = false;
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
 
 	bIgnore = false;
 
@@ -29,9 +32,13 @@ UMCGraspFixation::UMCGraspFixation()
 #endif // WITH_EDITORONLY_DATA
 
 	InputActionName = "LeftFixate";
+	InputPreGraspAxisName = "LeftGrasp";
+	CandidateApproachWeight = 0.5f;
 	bWeldBodies = false;
 	WeightLimit = 15.0f;
 	VolumeLimit = 30000.0f; // 1000cm^3 = 1 Liter
+	ReleasePoseHistorySize = 16;
+	ReleaseVelocityWindow = 0.1f;
 }
 
 // Called when the game starts
@@ -46,6 +53,17 @@ void UMCGraspFixation::BeginPlay()
 	Init();
 }
 
+// Called every frame while an object is fixated, samples its pose for the release velocity
+void UMCGraspFixation::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (GraspedObject)
+	{
+		GraspedObjectPoseHistory.Add(GetWorld()->GetTimeSeconds(), GraspedObject->GetActorTransform());
+	}
+}
+
 #if WITH_EDITOR
 // Called when a property is changed in the editor
 void UMCGraspFixation::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
@@ -62,10 +80,12 @@ void UMCGraspFixation::PostEditChangeProperty(struct FPropertyChangedEvent& Prop
 		if (HandType == EMCHandType::Left)
 		{
 			InputActionName = "LeftFixate";
+			InputPreGraspAxisName = "LeftGrasp";
 		}
 		else if (HandType == EMCHandType::Right)
 		{
 			InputActionName = "RightFixate";
+			InputPreGraspAxisName = "RightGrasp";
 		}
 	}
 }
@@ -77,6 +97,8 @@ void UMCGraspFixation::Init()
 	// Bind user input
 	SetupInputBindings();
 
+	ObjectsInSphereArea.ApproachWeight = CandidateApproachWeight;
+
 	// Bind overlap functions
 	OnComponentBeginOverlap.AddDynamic(this, &UMCGraspFixation::OnOverlapBegin);
 	OnComponentEndOverlap.AddDynamic(this, &UMCGraspFixation::OnOverlapEnd);
@@ -91,6 +113,10 @@ void UMCGraspFixation::SetupInputBindings()
 		{
 			IC->BindAction(InputActionName, IE_Pressed, this, &UMCGraspFixation::Grasp);
 			IC->BindAction(InputActionName, IE_Released, this, &UMCGraspFixation::Release);
+			if (!InputPreGraspAxisName.IsNone())
+			{
+				IC->BindAxis(InputPreGraspAxisName, this, &UMCGraspFixation::PreGraspUpdateCallback);
+			}
 		}
 	}
 }
@@ -98,10 +124,19 @@ void UMCGraspFixation::SetupInputBindings()
 // Try to fixate overlapping object to parent
 void UMCGraspFixation::Grasp()
 {
+	if (!GraspedObject)
+	{
+		ObjectsInSphereArea.Refresh(GetComponentLocation(), GetOwner()->GetVelocity().GetSafeNormal());
+	}
+
 	while (!GraspedObject && ObjectsInSphereArea.Num() > 0)
 	{
-		// Get an object from the sphere area and try to grasp it
-		AStaticMeshActor* SMA = ObjectsInSphereArea.Pop();
+		// Get the best object from the sphere area and try to grasp it
+		AStaticMeshActor* SMA = ObjectsInSphereArea.PopBest();
+		if (!SMA)
+		{
+			break;
+		}
 
 		// Check if the object can be grasped (not to heavy/large)
 		if (UMCGraspFixation::CanObjectBeGrasped(SMA))
@@ -126,17 +161,26 @@ void UMCGraspFixation::Release()
 {
 	if (GraspedObject)
 	{
-		// Cache the current grasped object velocity (it will be re-applied to the released object)
-		const FVector CachedVelocity = GraspedObject->GetVelocity();
+		// Estimate the grasped object velocity from its pose history (it will be re-applied to the released object)
+		FVector LinearVelocity;
+		FVector AngularVelocity;
+		GraspedObjectPoseHistory.Add(GetWorld()->GetTimeSeconds(), GraspedObject->GetActorTransform());
+		if (!GraspedObjectPoseHistory.EstimateVelocity(ReleaseVelocityWindow, LinearVelocity, AngularVelocity))
+		{
+			LinearVelocity = GraspedObject->GetVelocity();
+			AngularVelocity = FVector::ZeroVector;
+		}
+		SetComponentTickEnabled(false);
 
 		// Detach the static mesh component
 		UStaticMeshComponent* SMC = GraspedObject->GetStaticMeshComponent();
 		{
 			SMC->DetachFromComponent(FDetachmentTransformRules(EDetachmentRule::KeepWorld, true));
 
-			// Enable physics with and apply current hand velocity, clear pointer to object
+			// Enable physics with and apply the estimated velocity, clear pointer to object
 			SMC->SetSimulatePhysics(true);
-			SMC->SetPhysicsLinearVelocity(CachedVelocity * VelocityBoostAtRelease);
+			SMC->SetPhysicsLinearVelocity(LinearVelocity);
+			SMC->SetPhysicsAngularVelocityInRadians(AngularVelocity);
 
 			// Enable and update overlaps
 			SetGenerateOverlapEvents(true);
@@ -151,33 +195,26 @@ void UMCGraspFixation::Release()
 	}
 }
 
-// Check if the object can be grasped (not too heavy/large)
-bool UMCGraspFixation::CanObjectBeGrasped(AStaticMeshActor* InObject)
+// Refresh the candidate scores while the trigger is pre-pressed
+void UMCGraspFixation::PreGraspUpdateCallback(float Value)
 {
-	// Check if the object is movable
-	if (!InObject->IsRootComponentMovable())
+	if (Value > 0.05f && !GraspedObject && ObjectsInSphereArea.Num() > 0)
 	{
-		return false;
+		ObjectsInSphereArea.Refresh(GetComponentLocation(), GetOwner()->GetVelocity().GetSafeNormal());
 	}
+}
 
-	// Check if actor has a valid static mesh component
-	if (UStaticMeshComponent* SMC = InObject->GetStaticMeshComponent())
+// Check if the object can be grasped (not too heavy/large)
+bool UMCGraspFixation::CanObjectBeGrasped(AStaticMeshActor* InObject)
+{
+	// Check if the object is movable and not too heavy/large
+	if (!FMCGraspCandidateCache::Get().GetInfo(InObject).IsGraspable(WeightLimit, VolumeLimit))
 	{
-		// Check if component has physics on
-		if (!SMC->IsSimulatingPhysics())
-		{
-			return false;
-		}
-
-		// Check that object is not too heavy/large
-		if (SMC->GetMass() < WeightLimit && 
-			InObject->GetComponentsBoundingBox().GetVolume() < VolumeLimit)
-		{
-			return true;
-		}
+		return false;
 	}
 
-	return false;
+	// Check if component has physics on (changes at runtime, not cached)
+	return InObject->GetStaticMeshComponent()->IsSimulatingPhysics();
 }
 
 // Fixate the given object to parent
@@ -195,6 +232,11 @@ bool UMCGraspFixation::Fixate(AStaticMeshActor* InObject)
 			// Set the pointer to the grasped object
 			GraspedObject = InObject;
 
+			// Start sampling the object poses for the release velocity
+			GraspedObjectPoseHistory.Reset(ReleasePoseHistorySize);
+			GraspedObjectPoseHistory.Add(GetWorld()->GetTimeSeconds(), InObject->GetActorTransform());
+			SetComponentTickEnabled(true);
+
 			// Disable overlap checks during fixation grasp
 			SetGenerateOverlapEvents(false);
 
@@ -217,9 +259,13 @@ void UMCGraspFixation::OnOverlapBegin(UPrimitiveComponent* OverlappedComp,
 		return;
 	}
 
+	// Skip objects which can never be grasped (static, too heavy/large)
 	if (AStaticMeshActor* OtherAsSMA = Cast<AStaticMeshActor>(OtherActor))
 	{
-		ObjectsInSphereArea.Emplace(OtherAsSMA);
+		if (FMCGraspCandidateCache::Get().GetInfo(OtherAsSMA).IsGraspable(WeightLimit, VolumeLimit))
+		{
+			ObjectsInSphereArea.Add(OtherAsSMA, GetComponentLocation(), GetOwner()->GetVelocity().GetSafeNormal());
+		}
 	}
 }
 
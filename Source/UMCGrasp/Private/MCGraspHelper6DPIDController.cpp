@@ -8,13 +8,14 @@
 // Default constructor
 FMCGraspHelper6DPIDController::FMCGraspHelper6DPIDController()
 {
+	TargetSceneComp = nullptr;
 	LocUpdateFunctionPointer = &FMCGraspHelper6DPIDController::Loc_Update_NONE;
 	RotUpdateFunctionPointer = &FMCGraspHelper6DPIDController::Rot_Update_NONE;
 }
 
-// Init as static mesh with an offset
+// Init with the static meshes to control and their offsets relative to the target
 void FMCGraspHelper6DPIDController::Init(USceneComponent* InTarget,
-	UStaticMeshComponent* InSelfAsStaticMesh,
+	const TArray<UStaticMeshComponent*>& InSelfAsStaticMeshes,
 	EMCGraspHelp6DControlType LocControlType,
 	float PLoc, float ILoc, float DLoc, float MaxLoc,
 	EMCGraspHelp6DControlType RotControlType,
@@ -23,14 +24,18 @@ void FMCGraspHelper6DPIDController::Init(USceneComponent* InTarget,
 {
 	// Set target and self
 	TargetSceneComp = InTarget;
-	SelfAsStaticMeshComp = InSelfAsStaticMesh;
+	SelfAsStaticMeshComps = InSelfAsStaticMeshes;
 
-	// Calculate target offset
-	LocalTargetOffset = SelfAsStaticMeshComp->GetComponentTransform().GetRelativeTransform(InOffset);
+	// Calculate target offsets
+	LocalTargetOffsets.Reset(SelfAsStaticMeshComps.Num());
+	for (UStaticMeshComponent* SMC : SelfAsStaticMeshComps)
+	{
+		LocalTargetOffsets.Add(SMC->GetComponentTransform().GetRelativeTransform(InOffset));
+	}
 
-	// Init pid controllers
-	PIDLoc.Init(PLoc, ILoc, DLoc, MaxLoc);
-	PIDRot.Init(PRot, IRot, DRot, MaxRot);
+	// Init pid controllers, one per object
+	PIDLoc.Init(PLoc, ILoc, DLoc, MaxLoc, SelfAsStaticMeshComps.Num());
+	PIDRot.Init(PRot, IRot, DRot, MaxRot, SelfAsStaticMeshComps.Num());
 
 	// Bind update function depending on the control type
 	switch (LocControlType)
@@ -78,32 +83,92 @@ void FMCGraspHelper6DPIDController::Init(USceneComponent* InTarget,
 	}
 }
 
-// Clear the update function
+// Clear the update functions and the controlled objects
 void FMCGraspHelper6DPIDController::Clear()
 {
 	LocUpdateFunctionPointer = &FMCGraspHelper6DPIDController::Loc_Update_NONE;
+	RotUpdateFunctionPointer = &FMCGraspHelper6DPIDController::Rot_Update_NONE;
+	SelfAsStaticMeshComps.Reset();
+	LocalTargetOffsets.Reset();
+	PIDLoc.Empty();
+	PIDRot.Empty();
 }
 
 
 // Reset the location pid controller
 void FMCGraspHelper6DPIDController::ResetLoc(float P, float I, float D, float Max, bool bClearErrors /* = true*/)
 {
-	PIDLoc.Init(P, I, D, Max, bClearErrors);
+	if (bClearErrors)
+	{
+		PIDLoc.Init(P, I, D, Max, SelfAsStaticMeshComps.Num());
+	}
+	else
+	{
+		PIDLoc.SetGains(P, I, D, Max);
+	}
 }
 
 // Call the update function pointer
 void FMCGraspHelper6DPIDController::ResetRot(float P, float I, float D, float Max, bool bClearErrors /* = true*/)
 {
-	PIDRot.Init(P, I, D, Max, bClearErrors);
+	if (bClearErrors)
+	{
+		PIDRot.Init(P, I, D, Max, SelfAsStaticMeshComps.Num());
+	}
+	else
+	{
+		PIDRot.SetGains(P, I, D, Max);
+	}
 }
 
 // Call the update function pointer
 void FMCGraspHelper6DPIDController::UpdateController(float DeltaTime)
 {
+	Commands = FMC6DPhysicsCommandList::GetWorldList(TargetSceneComp ? TargetSceneComp->GetWorld() : nullptr);
+	if (!Commands)
+	{
+		return;
+	}
+
+	// The targets are shared by the location and rotation updates
+	UpdateTargets();
 	(this->*LocUpdateFunctionPointer)(DeltaTime);
 	(this->*RotUpdateFunctionPointer)(DeltaTime);
 }
 
+// Compute the target transform of every object
+void FMCGraspHelper6DPIDController::UpdateTargets()
+{
+	const FTransform& TargetTransform = TargetSceneComp->GetComponentTransform();
+	CurrentTargets.SetNumUninitialized(LocalTargetOffsets.Num(), false);
+	for (int32 Idx = 0; Idx < LocalTargetOffsets.Num(); ++Idx)
+	{
+		FTransform::Multiply(&CurrentTargets[Idx], &LocalTargetOffsets[Idx], &TargetTransform);
+	}
+}
+
+// Compute the location errors of every object and run the pid batch
+void FMCGraspHelper6DPIDController::UpdateLocPID(float DeltaTime)
+{
+	Errors.SetNumUninitialized(SelfAsStaticMeshComps.Num(), false);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Errors[Idx] = CurrentTargets[Idx].GetLocation() - SelfAsStaticMeshComps[Idx]->GetComponentLocation();
+	}
+	PIDLoc.Update(Errors, DeltaTime, Outputs);
+}
+
+// Compute the rotation errors of every object and run the pid batch
+void FMCGraspHelper6DPIDController::UpdateRotPID(float DeltaTime)
+{
+	Errors.SetNumUninitialized(SelfAsStaticMeshComps.Num(), false);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Errors[Idx] = GetRotationDelta(SelfAsStaticMeshComps[Idx]->GetComponentQuat(), CurrentTargets[Idx].GetRotation());
+	}
+	PIDRot.Update(Errors, DeltaTime, Outputs);
+}
+
 
 // Get the location delta (error)
 FORCEINLINE FVector FMCGraspHelper6DPIDController::GetRotationDelta(const FQuat& From, const FQuat& To)
@@ -141,111 +206,93 @@ void FMCGraspHelper6DPIDController::Rot_Update_NONE(float DeltaTime)
 // Loc
 void FMCGraspHelper6DPIDController::Loc_Update_Static_Position_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
 	/* Location and Rotation */
-	SelfAsStaticMeshComp->SetWorldLocation(CurrentTargetOffset.GetLocation(),
-		false, (FHitResult*)nullptr, ETeleportType::TeleportPhysics);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		SelfAsStaticMeshComps[Idx]->SetWorldLocation(CurrentTargets[Idx].GetLocation(),
+			false, (FHitResult*)nullptr, ETeleportType::TeleportPhysics);
+	}
 }
 
 void FMCGraspHelper6DPIDController::Loc_Update_Static_Velocity_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->SetPhysicsLinearVelocity(OutLoc);
+	UpdateLocPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->SetLinearVelocity(SelfAsStaticMeshComps[Idx], Outputs[Idx]);
+	}
 }
 
 void FMCGraspHelper6DPIDController::Loc_Update_Static_Impulse_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddImpulse(OutLoc);
+	UpdateLocPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->AddImpulse(SelfAsStaticMeshComps[Idx], Outputs[Idx]);
+	}
 }
 
 void FMCGraspHelper6DPIDController::Loc_Update_Static_Acceleration_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddForce(OutLoc, NAME_None, true); // Acceleration based (mass will have no effect)
+	UpdateLocPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->AddForce(SelfAsStaticMeshComps[Idx], Outputs[Idx], true); // Acceleration based (mass will have no effect)
+	}
 }
 
 void FMCGraspHelper6DPIDController::Loc_Update_Static_Force_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaLoc = CurrentTargetOffset.GetLocation() - SelfAsStaticMeshComp->GetComponentLocation();
-	const FVector OutLoc = PIDLoc.Update(DeltaLoc, DeltaTime);
-	SelfAsStaticMeshComp->AddForce(OutLoc); 
+	UpdateLocPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->AddForce(SelfAsStaticMeshComps[Idx], Outputs[Idx]);
+	}
 }
 
 // Rot
 void FMCGraspHelper6DPIDController::Rot_Update_Static_Position_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
 	/* Location and Rotation */
-	SelfAsStaticMeshComp->SetWorldRotation(CurrentTargetOffset.GetRotation(),
-		false, (FHitResult*)nullptr, ETeleportType::TeleportPhysics);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		SelfAsStaticMeshComps[Idx]->SetWorldRotation(CurrentTargets[Idx].GetRotation(),
+			false, (FHitResult*)nullptr, ETeleportType::TeleportPhysics);
+	}
 }
 
 void FMCGraspHelper6DPIDController::Rot_Update_Static_Velocity_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->SetPhysicsAngularVelocityInRadians(OutRot);
+	UpdateRotPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->SetAngularVelocityInRadians(SelfAsStaticMeshComps[Idx], Outputs[Idx]);
+	}
 }
 
 void FMCGraspHelper6DPIDController::Rot_Update_Static_Impulse_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddAngularImpulseInRadians(OutRot);
+	UpdateRotPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->AddAngularImpulseInRadians(SelfAsStaticMeshComps[Idx], Outputs[Idx]);
+	}
 }
 
 void FMCGraspHelper6DPIDController::Rot_Update_Static_Acceleration_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddTorqueInRadians(OutRot, NAME_None, true); // Acceleration based (mass will have no effect)
+	UpdateRotPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->AddTorqueInRadians(SelfAsStaticMeshComps[Idx], Outputs[Idx], true); // Acceleration based (mass will have no effect)
+	}
 }
 
 void FMCGraspHelper6DPIDController::Rot_Update_Static_Force_Offset(float DeltaTime)
 {
-	/* Offset target calculation */
-	FTransform CurrentTargetOffset;
-	FTransform::Multiply(&CurrentTargetOffset, &LocalTargetOffset, &TargetSceneComp->GetComponentTransform());
-
-	const FVector DeltaRotAsVector = GetRotationDelta(SelfAsStaticMeshComp->GetComponentQuat(), CurrentTargetOffset.GetRotation());
-	const FVector OutRot = PIDRot.Update(DeltaRotAsVector, DeltaTime);
-	SelfAsStaticMeshComp->AddTorqueInRadians(OutRot);
+	UpdateRotPID(DeltaTime);
+	for (int32 Idx = 0; Idx < SelfAsStaticMeshComps.Num(); ++Idx)
+	{
+		Commands->AddTorqueInRadians(SelfAsStaticMeshComps[Idx], Outputs[Idx]);
+	}
 }
@@ -2,6 +2,8 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "MCGraspHelperController.h"
+#include "MCGraspCandidateCache.h"
+#include "MCGraspConstraintPool.h"
 #include "GameFramework/PlayerController.h"
 #include "Components/InputComponent.h"
 #include "Engine/StaticMeshActor.h"
@@ -30,9 +32,12 @@ UMCGraspHelperController::UMCGraspHelperController()
 #endif // WITH_EDITORONLY_DATA
 
 	bHelpIsActive = false;
-	GraspedObject = nullptr;
+	MaxGraspedObjects = 1;
+	ConstraintPool = nullptr;
 
 	InputActionName = "LeftGraspHelper";
+	InputPreGraspAxisName = "LeftGrasp";
+	CandidateApproachWeight = 0.5f;
 
 	bUseAttractionForce = false;
 	AttractionForceFactor = 1000.f;
@@ -105,11 +110,13 @@ void UMCGraspHelperController::PostEditChangeProperty(struct FPropertyChangedEve
 		if (HandType == EMCHandType::Left)
 		{
 			InputActionName = "LeftGraspHelper";
+			InputPreGraspAxisName = "LeftGrasp";
 			BoneName = "lHand";
 		}
 		else if (HandType == EMCHandType::Right)
 		{
 			InputActionName = "RightGraspHelper";
+			InputPreGraspAxisName = "RightGrasp";
 			BoneName = "rHand";
 		}
 	}
@@ -135,40 +142,48 @@ void UMCGraspHelperController::Init()
 
 	if (bUseConstraintComponent)
 	{
-		ConstraintHelperComponent = NewObject<UPhysicsConstraintComponent>(this, FName("ConstraintHelperComponent"));
-		ConstraintHelperComponent->RegisterComponent();
-		ConstraintHelperComponent->AttachToComponent(OwnerSkelMC, FAttachmentTransformRules::SnapToTargetIncludingScale, BoneName);
-
-
-		ConstraintHelperComponent->ConstraintInstance.SetAngularSwing1Limit(EAngularConstraintMotion::ACM_Limited, 0.1f);
-		ConstraintHelperComponent->ConstraintInstance.SetAngularSwing2Limit(EAngularConstraintMotion::ACM_Limited, 0.1f);
-		ConstraintHelperComponent->ConstraintInstance.SetAngularTwistLimit(EAngularConstraintMotion::ACM_Limited, 0.1f);
-
-		ConstraintHelperComponent->ConstraintInstance.SetLinearXLimit(ELinearConstraintMotion::LCM_Limited, 0.1f);
-		ConstraintHelperComponent->ConstraintInstance.SetLinearYLimit(ELinearConstraintMotion::LCM_Limited, 0.1f);
-		ConstraintHelperComponent->ConstraintInstance.SetLinearZLimit(ELinearConstraintMotion::LCM_Limited, 0.1f);
-
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.LinearLimit.bSoftConstraint = true;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.LinearLimit.Stiffness = ConstraintStiffness;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.LinearLimit.Damping = ConstraintDamping;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.LinearLimit.ContactDistance = ConstraintContactDistance;
-
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.ConeLimit.bSoftConstraint = true;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.ConeLimit.Stiffness = ConstraintStiffness;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.ConeLimit.Damping = ConstraintDamping;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.ConeLimit.ContactDistance = ConstraintContactDistance;
-
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.TwistLimit.bSoftConstraint = true;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.TwistLimit.Stiffness = ConstraintStiffness;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.TwistLimit.Damping = ConstraintDamping;
-		ConstraintHelperComponent->ConstraintInstance.ProfileInstance.TwistLimit.ContactDistance = ConstraintContactDistance;
+		// Build the constraint profile once, it is copied to the pooled components on grasp
+		FConstraintInstance ConstraintTemplate;
+		ConstraintTemplate.SetAngularSwing1Limit(EAngularConstraintMotion::ACM_Limited, 0.1f);
+		ConstraintTemplate.SetAngularSwing2Limit(EAngularConstraintMotion::ACM_Limited, 0.1f);
+		ConstraintTemplate.SetAngularTwistLimit(EAngularConstraintMotion::ACM_Limited, 0.1f);
+
+		ConstraintTemplate.SetLinearXLimit(ELinearConstraintMotion::LCM_Limited, 0.1f);
+		ConstraintTemplate.SetLinearYLimit(ELinearConstraintMotion::LCM_Limited, 0.1f);
+		ConstraintTemplate.SetLinearZLimit(ELinearConstraintMotion::LCM_Limited, 0.1f);
+
+		ConstraintTemplate.ProfileInstance.LinearLimit.bSoftConstraint = true;
+		ConstraintTemplate.ProfileInstance.LinearLimit.Stiffness = ConstraintStiffness;
+		ConstraintTemplate.ProfileInstance.LinearLimit.Damping = ConstraintDamping;
+		ConstraintTemplate.ProfileInstance.LinearLimit.ContactDistance = ConstraintContactDistance;
+
+		ConstraintTemplate.ProfileInstance.ConeLimit.bSoftConstraint = true;
+		ConstraintTemplate.ProfileInstance.ConeLimit.Stiffness = ConstraintStiffness;
+		ConstraintTemplate.ProfileInstance.ConeLimit.Damping = ConstraintDamping;
+		ConstraintTemplate.ProfileInstance.ConeLimit.ContactDistance = ConstraintContactDistance;
+
+		ConstraintTemplate.ProfileInstance.TwistLimit.bSoftConstraint = true;
+		ConstraintTemplate.ProfileInstance.TwistLimit.Stiffness = ConstraintStiffness;
+		ConstraintTemplate.ProfileInstance.TwistLimit.Damping = ConstraintDamping;
+		ConstraintTemplate.ProfileInstance.TwistLimit.ContactDistance = ConstraintContactDistance;
 
 		if (bConstraintParentDominates)
 		{
-			ConstraintHelperComponent->ConstraintInstance.EnableParentDominates();
+			ConstraintTemplate.EnableParentDominates();
+		}
+		ConstraintProfile = ConstraintTemplate.ProfileInstance;
+
+		// Make sure the pool has enough components for every object this helper can hold
+		ConstraintPool = AMCGraspConstraintPool::Get(GetWorld());
+		if (ConstraintPool)
+		{
+			ConstraintPool->Reserve(ConstraintPool->NumFree() + MaxGraspedObjects);
 		}
 	}
 
+	GraspedObjects.Reserve(MaxGraspedObjects);
+	OverlappingCandidates.ApproachWeight = CandidateApproachWeight;
+
 	// Bind overlap functions
 	OnComponentBeginOverlap.AddDynamic(this, &UMCGraspHelperController::OnOverlapBegin);
 	OnComponentEndOverlap.AddDynamic(this, &UMCGraspHelperController::OnOverlapEnd);
@@ -182,6 +197,10 @@ void UMCGraspHelperController::SetupInputBindings()
 		if (UInputComponent* IC = PC->InputComponent)
 		{
 			IC->BindAction(InputActionName, IE_Pressed, this, &UMCGraspHelperController::ToggleHelp);
+			if (!InputPreGraspAxisName.IsNone())
+			{
+				IC->BindAxis(InputPreGraspAxisName, this, &UMCGraspHelperController::PreGraspUpdateCallback);
+			}
 			//IC->BindAction(InputActionName, IE_Pressed, this, &UMCGraspHelperController::StartHelp);
 			//IC->BindAction(InputActionName, IE_Released, this, &UMCGraspHelperController::StopHelp);
 		}
@@ -191,24 +210,37 @@ void UMCGraspHelperController::SetupInputBindings()
 // Start helping with grasp
 void UMCGraspHelperController::StartHelp()
 {
-	// Set the properties for the object to thelp
+	// Set the properties for the objects to help
 	if (SetGraspedObjectProperties())
 	{
 		if (bUseAttachment)
 		{
-			if (bUseConstraintComponent)
+			for (FMCGraspHelperObject& GraspedObject : GraspedObjects)
 			{
-				ConstraintHelperComponent->SetConstrainedComponents(OwnerSkelMC, BoneName, GraspedObjectSMC, NAME_None);
-			}
-			else
-			{
-				GraspedObjectSMC->SetSimulatePhysics(false);
-				GraspedObject->AttachToComponent(OwnerSkelMC, FAttachmentTransformRules::KeepWorldTransform, BoneName);
+				if (bUseConstraintComponent)
+				{
+					GraspedObject.ConstraintComp = ConstraintPool ? ConstraintPool->Borrow(ConstraintProfile, OwnerSkelMC, BoneName) : nullptr;
+					if (GraspedObject.ConstraintComp)
+					{
+						GraspedObject.ConstraintComp->SetConstrainedComponents(OwnerSkelMC, BoneName, GraspedObject.SMC, NAME_None);
+					}
+				}
+				else
+				{
+					GraspedObject.SMC->SetSimulatePhysics(false);
+					GraspedObject.Actor->AttachToComponent(OwnerSkelMC, FAttachmentTransformRules::KeepWorldTransform, BoneName);
+				}
 			}
 		}
 		else if (bUsePID)
 		{
-			Controller6DPID.Init(this, GraspedObjectSMC, LocControlType,
+			TArray<UStaticMeshComponent*> GraspedSMCs;
+			GraspedSMCs.Reserve(GraspedObjects.Num());
+			for (const FMCGraspHelperObject& GraspedObject : GraspedObjects)
+			{
+				GraspedSMCs.Add(GraspedObject.SMC);
+			}
+			Controller6DPID.Init(this, GraspedSMCs, LocControlType,
 				PLoc, ILoc, DLoc, MaxLoc, RotControlType, PRot, IRot, DRot, MaxRot,
 				this->GetComponentTransform());
 			SetComponentTickEnabled(true);
@@ -230,14 +262,21 @@ void UMCGraspHelperController::StopHelp()
 {	
 	if (bUseAttachment)
 	{
-		if (bUseConstraintComponent)
+		for (FMCGraspHelperObject& GraspedObject : GraspedObjects)
 		{
-			ConstraintHelperComponent->BreakConstraint();
-		}
-		else
-		{
-			GraspedObject->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
-			GraspedObjectSMC->SetSimulatePhysics(true);
+			if (bUseConstraintComponent)
+			{
+				if (GraspedObject.ConstraintComp)
+				{
+					ConstraintPool->Return(GraspedObject.ConstraintComp);
+					GraspedObject.ConstraintComp = nullptr;
+				}
+			}
+			else
+			{
+				GraspedObject.Actor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+				GraspedObject.SMC->SetSimulatePhysics(true);
+			}
 		}
 	}
 	else if (bUsePID)
@@ -266,20 +305,32 @@ void UMCGraspHelperController::ToggleHelp()
 	}
 }
 
+// Refresh the candidate scores while the trigger is pre-pressed
+void UMCGraspHelperController::PreGraspUpdateCallback(float Value)
+{
+	if (Value > 0.05f && !bHelpIsActive && OverlappingCandidates.Num() > 0)
+	{
+		OverlappingCandidates.Refresh(GetComponentLocation(), GetOwner()->GetVelocity().GetSafeNormal());
+	}
+}
+
 // Update the grasp
 void UMCGraspHelperController::UpdateHelp(float DeltaTime)
 {
-	if (GraspedObjectSMC)
+	if (bUsePID)
 	{
-		if (bUsePID)
+		if (GraspedObjects.Num() > 0)
 		{
 			Controller6DPID.UpdateController(DeltaTime);
 		}
-		else if (bUseAttractionForce)
+	}
+	else if (bUseAttractionForce)
+	{
+		for (const FMCGraspHelperObject& GraspedObject : GraspedObjects)
 		{
-			FVector Out = GetComponentLocation() - GraspedObject->GetActorLocation();
+			FVector Out = GetComponentLocation() - GraspedObject.Actor->GetActorLocation();
 			Out *= DeltaTime * AttractionForceFactor;
-			GraspedObjectSMC->AddForce(Out, NAME_None, true);
+			GraspedObject.SMC->AddForce(Out, NAME_None, true);
 		}
 	}
 }
@@ -287,101 +338,89 @@ void UMCGraspHelperController::UpdateHelp(float DeltaTime)
 // Setup object help properties
 bool UMCGraspHelperController::SetGraspedObjectProperties()
 {
-	if (GraspedObject)
+	if (GraspedObjects.Num() > 0)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Grasped object is already set, this should not happen.."), *FString(__FUNCTION__), __LINE__);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Grasped objects are already set, this should not happen.."), *FString(__FUNCTION__), __LINE__);
 	}
 
-	// Get the best candidate from the overlap pool
-	GraspedObject = GetBestCandidate();
-	if (GraspedObject && GraspedObject->IsValidLowLevel() && !GraspedObject->IsPendingKillOrUnreachable())
+	OverlappingCandidates.Refresh(GetComponentLocation(), GetOwner()->GetVelocity().GetSafeNormal());
+
+	// Take the best candidates from the overlap pool
+	while (GraspedObjects.Num() < MaxGraspedObjects && OverlappingCandidates.Num() > 0)
 	{
-		if (UStaticMeshComponent* SMC = GraspedObject->GetStaticMeshComponent())
+		AStaticMeshActor* Candidate = OverlappingCandidates.PopBest();
+		if (Candidate && Candidate->IsValidLowLevel() && !Candidate->IsPendingKillOrUnreachable())
 		{
-			GraspedObjectSMC = SMC;		
-
-			if (bDisableGravity)
+			if (UStaticMeshComponent* SMC = Candidate->GetStaticMeshComponent())
 			{
-				GraspedObjectSMC->SetEnableGravity(false);
-			}
-
-			if (bDecreaseMass)
-			{
-				GraspedObjectSMC->SetMassScale(NAME_None, MassScaleValue);
-			}
+				if (bDisableGravity)
+				{
+					SMC->SetEnableGravity(false);
+				}
 
-			// Pause candidate searches until object is released
-			SetGenerateOverlapEvents(false);
-			OverlappingCandidates.Empty();
+				if (bDecreaseMass)
+				{
+					SMC->SetMassScale(NAME_None, MassScaleValue);
+				}
 
-			return true;
+				GraspedObjects.Add({ Candidate, SMC, nullptr });
+			}
 		}
 	}
-	else
+
+	if (GraspedObjects.Num() > 0)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not find a grasp (best)candidate, this should not happen.."), *FString(__FUNCTION__), __LINE__);
+		// Pause candidate searches until the objects are released
+		SetGenerateOverlapEvents(false);
+		OverlappingCandidates.Empty();
+		return true;
 	}
+	
+	UE_LOG(LogTemp, Error, TEXT("%s::%d Could not find a grasp (best)candidate, this should not happen.."), *FString(__FUNCTION__), __LINE__);
 	return false;
 }
 
 // Clear object help properties
 bool UMCGraspHelperController::ResetGraspedObjectProperties()
 {
-	if (GraspedObject && GraspedObject->IsValidLowLevel() && !GraspedObject->IsPendingKillOrUnreachable())
+	if (GraspedObjects.Num() == 0)
 	{
-		if (GraspedObjectSMC)
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Object to help is not valid, this should not happen.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	for (const FMCGraspHelperObject& GraspedObject : GraspedObjects)
+	{
+		if (GraspedObject.Actor->IsValidLowLevel() && !GraspedObject.Actor->IsPendingKillOrUnreachable())
 		{
 			if (bDisableGravity)
 			{
-				GraspedObjectSMC->SetEnableGravity(true);
+				GraspedObject.SMC->SetEnableGravity(true);
 			}
 
 			if (bDecreaseMass)
 			{
-				GraspedObjectSMC->SetMassScale(NAME_None, 1.f);
+				GraspedObject.SMC->SetMassScale(NAME_None, 1.f);
 			}
-
-			GraspedObjectSMC = nullptr;			
 		}
-
-		GraspedObject = nullptr;
-
-		// Start searching for candidates againg
-		SetGenerateOverlapEvents(true);
-		UpdateOverlaps();
-
-		return true;
 	}
-	else
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Object to help is not valid, this should not happen.."), *FString(__FUNCTION__), __LINE__);
-	}
-	return false;
+	GraspedObjects.Reset();
+
+	// Start searching for candidates againg
+	SetGenerateOverlapEvents(true);
+	UpdateOverlaps();
+	return true;
 }
 
 // Check if the object can should be helped with grasping
 bool UMCGraspHelperController::IsAGoodCandidate(AStaticMeshActor* InObject)
 {
-#if ENGINE_MINOR_VERSION > 23 || ENGINE_MAJOR_VERSION > 4
-	TArray<UActorComponent*> Components;
-	InObject->GetComponents(UShapeComponent::StaticClass(), Components);
-	for (const auto C : Components)
-	{
-		if (C->GetName().StartsWith("SLContactMonitor"))
-		{
-			return true;
-		}
-	}
-#else
 	// Check if object has a contact area
-	for (const auto& C : InObject->GetComponentsByClass(UShapeComponent::StaticClass()))
+	if (FMCGraspCandidateCache::Get().GetInfo(InObject).bHasContactMonitor)
 	{
-		if (C->GetName().StartsWith("SLContactMonitor"))
-		{
-			return true;
-		}
+		return true;
 	}
-#endif
+
 	//// Check if the object is movable
 	//if (!InObject->IsRootComponentMovable())
 	//{
@@ -411,19 +450,8 @@ bool UMCGraspHelperController::IsAGoodCandidate(AStaticMeshActor* InObject)
 // Get the best candidate from the overlapp pool
 AStaticMeshActor* UMCGraspHelperController::GetBestCandidate()
 {
-	// Return candidate closest to the controller center
-	AStaticMeshActor* BestCandidate = nullptr;
-	float DistSQ = BIG_NUMBER;
-	for (const auto& Candidate : OverlappingCandidates)
-	{
-		float CurrDistSQ = FVector::DistSquared(Candidate->GetActorLocation(), GetComponentLocation());
-		if (CurrDistSQ < DistSQ)
-		{
-			BestCandidate = Candidate;
-			DistSQ = CurrDistSQ;
-		}
-	}
-	return BestCandidate;
+	OverlappingCandidates.Refresh(GetComponentLocation(), GetOwner()->GetVelocity().GetSafeNormal());
+	return OverlappingCandidates.GetBest();
 }
 
 // Called on overlap begin events
@@ -434,11 +462,11 @@ void UMCGraspHelperController::OnOverlapBegin(UPrimitiveComponent* OverlappedCom
 	bool bFromSweep,
 	const FHitResult& SweepResult)
 {
-	if (OtherComp->GetName().StartsWith("SLContactMonitor"))
+	if (FMCGraspCandidateCache::Get().IsContactMonitor(OtherComp))
 	{
 		if (AStaticMeshActor* OtherAsSMA = Cast<AStaticMeshActor>(OtherActor))
 		{
-			OverlappingCandidates.Emplace(OtherAsSMA);
+			OverlappingCandidates.Add(OtherAsSMA, GetComponentLocation(), GetOwner()->GetVelocity().GetSafeNormal());
 			//UE_LOG(LogTemp, Warning, TEXT("%s::%d *_* Added %s to OverlappingObjects (Num=%d).."),
 			//	*FString(__FUNCTION__), __LINE__, *OtherAsSMA->GetName(), OverlappingCandidates.Num());
 		}
@@ -460,16 +488,11 @@ void UMCGraspHelperController::OnOverlapEnd(UPrimitiveComponent* OverlappedComp,
 	UPrimitiveComponent* OtherComp,
 	int32 OtherBodyIndex)
 {
-	if (OtherComp->GetName().StartsWith("SLContactMonitor"))
+	if (FMCGraspCandidateCache::Get().IsContactMonitor(OtherComp))
 	{	
 		if (AStaticMeshActor* OtherAsSMA = Cast<AStaticMeshActor>(OtherActor))
 		{
-			int32 NumEl = OverlappingCandidates.Remove(OtherAsSMA);
-			//if (NumEl > 0)
-			//{
-			//	UE_LOG(LogTemp, Error, TEXT("%s::%d *_* Removed %s from OverlappingObjects (Num=%d).."),
-			//		*FString(__FUNCTION__), __LINE__, *OtherAsSMA->GetName(), OverlappingCandidates.Num());
-			//}
+			OverlappingCandidates.Remove(OtherAsSMA);
 		}
 	}
 }
\ No newline at end of file
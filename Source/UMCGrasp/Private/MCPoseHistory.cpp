@@ -0,0 +1,108 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCPoseHistory.h"
+
+// Default ctor
+FMCPoseHistory::FMCPoseHistory()
+{
+	Head = 0;
+	NumSamples = 0;
+}
+
+// Clear the samples and set the buffer size
+void FMCPoseHistory::Reset(int32 InCapacity)
+{
+	Samples.SetNum(FMath::Max(InCapacity, 2), false);
+	Head = 0;
+	NumSamples = 0;
+}
+
+// Add a sample, overwriting the oldest one if the buffer is full
+void FMCPoseHistory::Add(float InTime, const FTransform& InPose)
+{
+	if (Samples.Num() == 0)
+	{
+		return;
+	}
+
+	FSample& Sample = Samples[Head];
+	Sample.Time = InTime;
+	Sample.Location = InPose.GetLocation();
+	Sample.Rotation = InPose.GetRotation();
+
+	Head = (Head + 1) % Samples.Num();
+	NumSamples = FMath::Min(NumSamples + 1, Samples.Num());
+}
+
+// Estimate the linear (cm/s) and angular (rad/s) velocity from the samples of the last window (s),
+// return false if there are not enough samples
+bool FMCPoseHistory::EstimateVelocity(float InWindow, FVector& OutLinear, FVector& OutAngular) const
+{
+	if (NumSamples < 2)
+	{
+		return false;
+	}
+
+	// Number of samples within the window (at least two)
+	const float NewestTime = GetFromNewest(0).Time;
+	int32 NumInWindow = 2;
+	while (NumInWindow < NumSamples && NewestTime - GetFromNewest(NumInWindow).Time <= InWindow)
+	{
+		NumInWindow++;
+	}
+
+	// Iterate from the oldest to the newest sample, the rotations are unwrapped into
+	// an accumulated rotation vector so they can be fitted the same way as the locations
+	const float RefTime = GetFromNewest(NumInWindow - 1).Time;
+	FVector AccumRotVec = FVector::ZeroVector;
+	FQuat PrevRotation = GetFromNewest(NumInWindow - 1).Rotation;
+
+	float SumT = 0.f;
+	float SumTT = 0.f;
+	FVector SumLoc = FVector::ZeroVector;
+	FVector SumTLoc = FVector::ZeroVector;
+	FVector SumRot = FVector::ZeroVector;
+	FVector SumTRot = FVector::ZeroVector;
+	for (int32 AgeIdx = NumInWindow - 1; AgeIdx >= 0; --AgeIdx)
+	{
+		const FSample& Sample = GetFromNewest(AgeIdx);
+
+		// Delta rotation in world frame, shortest path
+		FQuat DeltaRot = Sample.Rotation * PrevRotation.Inverse();
+		if (DeltaRot.W < 0.f)
+		{
+			DeltaRot = DeltaRot * -1.f;
+		}
+		FVector Axis;
+		float Angle;
+		DeltaRot.ToAxisAndAngle(Axis, Angle);
+		AccumRotVec += Axis * Angle;
+		PrevRotation = Sample.Rotation;
+
+		const float T = Sample.Time - RefTime;
+		SumT += T;
+		SumTT += T * T;
+		SumLoc += Sample.Location;
+		SumTLoc += Sample.Location * T;
+		SumRot += AccumRotVec;
+		SumTRot += AccumRotVec * T;
+	}
+
+	// Slope of the least-squares line: (N*Sum(t*x) - Sum(t)*Sum(x)) / (N*Sum(t^2) - Sum(t)^2)
+	const float N = static_cast<float>(NumInWindow);
+	const float Denominator = N * SumTT - SumT * SumT;
+	if (Denominator < SMALL_NUMBER)
+	{
+		return false;
+	}
+	OutLinear = (SumTLoc * N - SumLoc * SumT) / Denominator;
+	OutAngular = (SumTRot * N - SumRot * SumT) / Denominator;
+	return true;
+}
+
+// Get the sample with the given age index (0 = newest)
+const FMCPoseHistory::FSample& FMCPoseHistory::GetFromNewest(int32 AgeIdx) const
+{
+	return Samples[(Head - 1 - AgeIdx + Samples.Num()) % Samples.Num()];
+}
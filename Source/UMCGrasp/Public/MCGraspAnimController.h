@@ -7,6 +7,7 @@
 #include "Components/ActorComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "MCGraspAnimDataAsset.h"
+#include "MCInputFilter.h"
 #include "MCGraspAnimController.generated.h"
 
 /**
@@ -38,6 +39,9 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 #if WITH_EDITOR
 	// Called when a property is changed in the editor
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -48,6 +52,19 @@ private:
 	typedef TMap<FConstraintInstance*, FRotator> FFrame;
 	typedef TArray<FFrame> FAnimation;
 
+	// Loaded animation, the compressed tracks are sampled at runtime, the frames are only cached for uncompressed assets
+	struct FLoadedAnimation
+	{
+		// Uncompressed frames
+		FAnimation Frames;
+
+		// Compressed tracks (owned by the data asset) with their constraints
+		TArray<TPair<FConstraintInstance*, const FMCGraspAnimCompressedTrack*>> Tracks;
+
+		// Number of frames of the animation
+		int32 NumFrames = 0;
+	};
+
 	// Init the component
 	void Init();
 
@@ -57,6 +74,12 @@ private:
 	// Load the data from the animation data assets in a more optimized form, return true if at least one animation is loaded
 	bool LoadAnimationData();
 
+	// Find the constraints of the compressed tracks, the tracks are sampled at runtime
+	void LoadCompressedAnimation(const FMCGraspAnimCompressedData& CompressedData, FLoadedAnimation& OutAnimation);
+
+	// Set the cached target to the (fractional) frame position of the active animation
+	void SetTargetAtFrame(float FramePos);
+
 	// Set the motors target value to the first frame
 	void DriveToFirstFrame();
 
@@ -136,6 +159,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Grasp Controller")
 	float ForceLimit;
 
+	// Skip the grasp updates if the input did not change enough
+	UPROPERTY(EditAnywhere, Category = "Grasp Controller")
+	FMCInputFilter InputFilter;
+
 	// An array the user can fill with grasps they want to use
 	UPROPERTY(EditAnywhere, Category = "Grasp Controller")
 	TArray<UMCGraspAnimDataAsset*> AnimationDataAssets;
@@ -162,11 +189,8 @@ private:
 	// Rotation where the motor will try to go to (map between the constraint instance and the target rotation)	
 	FFrame DriveTarget;
 
-	// Selected animation	
-	FAnimation ActiveAnimation;
-	
 	// Animation list
-	TArray<FAnimation> Animations;
+	TArray<FLoadedAnimation> Animations;
 
 	// Animation names
 	TArray<FString> AnimationNames;
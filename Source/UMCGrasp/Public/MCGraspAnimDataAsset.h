@@ -38,6 +38,77 @@ struct FMCGraspAnimFrameData
 	//FMCGraspAnimFrameData() {}
 };
 
+// Keyframe track of a bone angular drive target, the rotations are quantized to 16 bits per axis
+USTRUCT()
+struct UMCGRASP_API FMCGraspAnimCompressedTrack
+{
+	GENERATED_BODY()
+
+	// Name of the bone (constraint) driven by the track
+	UPROPERTY()
+	FString BoneName;
+
+	// Source frame index of every key, a single key means the bone is static
+	UPROPERTY()
+	TArray<uint16> KeyFrames;
+
+	// Quantized pitch, yaw and roll of every key
+	UPROPERTY()
+	TArray<uint16> KeyValues;
+
+	// Get the rotation of the given key
+	FRotator GetKey(int32 KeyIdx) const;
+
+	// Sample the track at the given (fractional) frame position by interpolating between the neighbouring keys
+	FRotator Sample(float FramePos) const;
+};
+
+// Compact runtime representation of the angular drive targets of a grasp animation
+USTRUCT()
+struct UMCGRASP_API FMCGraspAnimCompressedData
+{
+	GENERATED_BODY()
+
+	// Default ctor
+	FMCGraspAnimCompressedData() : NumFrames(0), NumStaticBones(0), NumKeys(0),
+		RawSize(0), CompressedSize(0), Tolerance(0.f), MaxError(0.f) {}
+
+	// True if the animation has been compressed
+	bool IsValid() const { return NumFrames > 1 && Tracks.Num() > 0; }
+
+	// Bone tracks
+	UPROPERTY()
+	TArray<FMCGraspAnimCompressedTrack> Tracks;
+
+	// Number of frames of the source animation
+	UPROPERTY(VisibleAnywhere, Category = "Compression")
+	int32 NumFrames;
+
+	// Bones which do not move during the animation (stored with a single key)
+	UPROPERTY(VisibleAnywhere, Category = "Compression")
+	int32 NumStaticBones;
+
+	// Total number of keys of all the tracks
+	UPROPERTY(VisibleAnywhere, Category = "Compression")
+	int32 NumKeys;
+
+	// Serialized size of the frames (bytes, without the property tags), kept by the editor asset only
+	UPROPERTY(VisibleAnywhere, Category = "Compression")
+	int32 RawSize;
+
+	// Serialized size of the tracks (bytes, without the property tags), the only animation data of the cooked asset
+	UPROPERTY(VisibleAnywhere, Category = "Compression")
+	int32 CompressedSize;
+
+	// Angular error threshold used for the compression (degrees)
+	UPROPERTY(VisibleAnywhere, Category = "Compression")
+	float Tolerance;
+
+	// Max angular error between the source and the compressed animation (degrees)
+	UPROPERTY(VisibleAnywhere, Category = "Compression")
+	float MaxError;
+};
+
 /**
  * Contains the data of a grasp animation
  */
@@ -51,7 +122,19 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Grasp Controller")
 	FString Name;
 
-	//All frames
+	//All frames (not cooked if the animation is compressed)
 	UPROPERTY(EditAnywhere, Category = "Grasp Controller")
 	TArray<FMCGraspAnimFrameData> Frames;
+
+	// Compressed drive targets, sampled at runtime instead of the frames if valid (written by the editor and the MCGraspAnim commandlet)
+	UPROPERTY(VisibleAnywhere, Category = "Grasp Controller")
+	FMCGraspAnimCompressedData CompressedData;
+
+	// Strip the frames of the compressed animations from the cooked asset
+	virtual void Serialize(FArchive& Ar) override;
+
+#if WITH_EDITOR
+	// Called when a property is changed in the editor
+	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif // WITH_EDITOR
 };
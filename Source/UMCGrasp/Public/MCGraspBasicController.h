@@ -7,6 +7,7 @@
 #include "Components/ActorComponent.h"
 #include "MCStructs.h"
 #include "PhysicsEngine/ConstraintDrives.h"
+#include "MCInputFilter.h"
 #include "MCGraspBasicController.generated.h"
 
 /**
@@ -25,6 +26,9 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 #if WITH_EDITOR
 	// Called when a property is changed in the editor
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -80,9 +84,14 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Grasp Controller", meta = (ClampMin = 0))
 	float ForceLimit;
 
+	// Don't iterate over the constraints if the input value did not change enough since last time
+	UPROPERTY(EditAnywhere, Category = "Grasp Controller")
+	FMCInputFilter InputFilter;
+
+	// Overwrite the input filter hysteresis with the default of the skeletal type (coarser for the genesis hands)
+	UPROPERTY(EditAnywhere, Category = "Grasp Controller")
+	bool bUseSkeletalTypeHysteresis;
+
 	// Skeletal mesh of the owner
 	class USkeletalMeshComponent* SkeletalMesh;
-
-	// Don't iterate over the constraints if the input value did not change since last time
-	float PrevInputVal;
 };
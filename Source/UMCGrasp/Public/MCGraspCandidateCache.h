@@ -0,0 +1,89 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+// Forward declaration
+class AStaticMeshActor;
+class UPrimitiveComponent;
+
+/**
+ * Grasp relevant data of a candidate actor, resolved when first seen (the mass is refreshed if the body mass settings change)
+ */
+struct FMCGraspCandidateInfo
+{
+	// Default ctor
+	FMCGraspCandidateInfo() : bHasStaticMesh(false), bIsMovable(false), bHasContactMonitor(false), Mass(0.f), BoundsVolume(0.f),
+		MassScale(-1.f), MassOverride(-1.f) {}
+
+	// The actor has a valid static mesh component
+	bool bHasStaticMesh;
+
+	// The root component is movable
+	bool bIsMovable;
+
+	// The actor has a semantic contact monitor area (SLContactMonitor*)
+	bool bHasContactMonitor;
+
+	// Mass of the static mesh component (kg)
+	float Mass;
+
+	// Volume of the components bounding box (cm^3)
+	float BoundsVolume;
+
+	// Mass scale and mass override (negative if not set) of the body when the mass was computed
+	float MassScale;
+	float MassOverride;
+
+	// True if the object can be moved and is within the given limits
+	bool IsGraspable(float WeightLimit, float VolumeLimit) const
+	{
+		return bHasStaticMesh && bIsMovable && Mass < WeightLimit && BoundsVolume < VolumeLimit;
+	}
+};
+
+/**
+ * Cache of the grasp candidate metadata shared by the grasp components, keyed by weak pointers,
+ * overlap events only need a hash lookup instead of name comparisons and component iterations (game thread only)
+ */
+class UMCGRASP_API FMCGraspCandidateCache
+{
+public:
+	// Get the shared cache
+	static FMCGraspCandidateCache& Get();
+
+	// Check if the component is a semantic contact monitor area of a static mesh actor
+	bool IsContactMonitor(UPrimitiveComponent* InComponent);
+
+	// Get the candidate data of the actor, computed on the first call, the mass is refreshed if the body mass settings changed
+	FMCGraspCandidateInfo GetInfo(AStaticMeshActor* InActor);
+
+	// Remove the cached data of the actor (e.g. if its components changed)
+	void Invalidate(AStaticMeshActor* InActor);
+
+private:
+	// Compute the candidate data of the actor
+	static FMCGraspCandidateInfo ComputeInfo(AStaticMeshActor* InActor);
+
+	// Recompute the mass if the mass scale or override of the body changed (they can be set at runtime)
+	static void UpdateMass(AStaticMeshActor* InActor, FMCGraspCandidateInfo& InOutInfo);
+
+	// Remove the entries of the destroyed objects, called periodically on inserts
+	void RemoveStaleEntries();
+
+private:
+	// Contact monitor flag of the overlapped components
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, bool> ContactMonitorFlags;
+
+	// Candidate data of the actors
+	TMap<TWeakObjectPtr<AStaticMeshActor>, FMCGraspCandidateInfo> CandidateInfos;
+
+	// Inserts since the last stale entries removal
+	int32 NumInsertsSinceCleanup = 0;
+
+	/* Constants */
+	constexpr static int32 CleanupInterval = 256;
+};
@@ -0,0 +1,79 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+// Forward declaration
+class AStaticMeshActor;
+
+/**
+ * Grasp candidates with their score kept in a binary min-heap updated from the overlap events,
+ * a lower score is better: distance to the grasp center, reduced for objects in the approach direction
+ */
+class UMCGRASP_API FMCGraspCandidates
+{
+public:
+	// Default ctor
+	FMCGraspCandidates();
+
+	// Add the candidate (no-op if already present)
+	void Add(AStaticMeshActor* InActor, const FVector& InCenter, const FVector& InApproachDir);
+
+	// Remove the candidate, return true if it was present
+	bool Remove(AStaticMeshActor* InActor);
+
+	// Remove all the candidates
+	void Empty();
+
+	// Number of candidates
+	int32 Num() const { return Entries.Num(); }
+
+	// Update the score of every candidate and rebuild the heap, at most once per frame (later calls in the same frame are skipped)
+	void Refresh(const FVector& InCenter, const FVector& InApproachDir);
+
+	// Get the best candidate, nullptr if there are no valid candidates
+	AStaticMeshActor* GetBest();
+
+	// Remove and return the best candidate
+	AStaticMeshActor* PopBest();
+
+	// Weight [0-1] of the approach direction in the score, 0 means distance only
+	float ApproachWeight;
+
+private:
+	// Compute the score of the actor (lower is better)
+	float ComputeScore(AStaticMeshActor* InActor, const FVector& InCenter, const FVector& InApproachDir) const;
+
+	// Remove the entry at the given heap index
+	void RemoveAt(int32 Idx);
+
+	// Move the entry towards the root until the heap order holds, return its new index
+	int32 SiftUp(int32 Idx);
+
+	// Move the entry towards the leaves until the heap order holds
+	void SiftDown(int32 Idx);
+
+	// Swap two entries and their indices
+	void SwapEntries(int32 A, int32 B);
+
+private:
+	// Candidate with its score
+	struct FEntry
+	{
+		TWeakObjectPtr<AStaticMeshActor> Actor;
+		AStaticMeshActor* Key; // only used for the index lookup, never dereferenced
+		float Score;
+	};
+
+	// Candidates as a binary min-heap on the score
+	TArray<FEntry> Entries;
+
+	// Index of the candidates in the entries array
+	TMap<AStaticMeshActor*, int32> EntryIndices;
+
+	// Frame of the last refresh
+	uint64 LastRefreshFrame;
+};
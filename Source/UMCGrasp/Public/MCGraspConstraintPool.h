@@ -0,0 +1,50 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PhysicsEngine/ConstraintInstance.h"
+#include "MCGraspConstraintPool.generated.h"
+
+// Forward declaration
+class UPhysicsConstraintComponent;
+
+/**
+ * World level pool of registered physics constraint components, borrowed and returned by the grasp helpers,
+ * components are only created when reserving, borrowing and returning does not allocate or register anything
+ */
+UCLASS(NotPlaceable, Transient)
+class UMCGRASP_API AMCGraspConstraintPool : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values
+	AMCGraspConstraintPool();
+
+	// Get the pool of the world, spawn it if it does not exist
+	static AMCGraspConstraintPool* Get(UWorld* InWorld);
+
+	// Make sure at least the given number of components are free (call at init time)
+	void Reserve(int32 NumFree);
+
+	// Borrow a component with the given profile, attached to the parent, nullptr if the pool is empty
+	UPhysicsConstraintComponent* Borrow(const FConstraintProfileProperties& InProfile, USceneComponent* InParent, FName InSocketName);
+
+	// Break the constraint and give the component back to the pool
+	void Return(UPhysicsConstraintComponent* InConstraintComp);
+
+	// Number of components that can be borrowed
+	int32 NumFree() const { return FreeComponents.Num(); }
+
+private:
+	// Components that can be borrowed
+	UPROPERTY()
+	TArray<UPhysicsConstraintComponent*> FreeComponents;
+
+	// All the created components
+	UPROPERTY()
+	TArray<UPhysicsConstraintComponent*> AllComponents;
+};
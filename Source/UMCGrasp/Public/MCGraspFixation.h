@@ -6,6 +6,8 @@
 #include "CoreMinimal.h"
 #include "Components/SphereComponent.h"
 #include "MCStructs.h"
+#include "MCGraspCandidates.h"
+#include "MCPoseHistory.h"
 #include "MCGraspFixation.generated.h"
 
 // Forward declaration
@@ -35,6 +37,9 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called every frame while an object is fixated, samples its pose for the release velocity
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
 #if WITH_EDITOR
 	// Called when a property is changed in the editor
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -53,6 +58,9 @@ private:
 	// Release the grasp (fixation)
 	void Release();
 
+	// Refresh the candidate scores while the trigger is pre-pressed
+	void PreGraspUpdateCallback(float Value);
+
 	// Check if the object can be grasped (not too heavy/large)
 	bool CanObjectBeGrasped(AStaticMeshActor* InObject);
 
@@ -97,6 +105,14 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Fixation Grasp")
 	FName InputActionName;
 
+	// Trigger axis, while pre-pressed the candidate scores are refreshed every frame
+	UPROPERTY(EditAnywhere, Category = "Fixation Grasp")
+	FName InputPreGraspAxisName;
+
+	// Weight [0-1] of the hand movement direction in the candidate selection, 0 means closest only
+	UPROPERTY(EditAnywhere, Category = "Fixation Grasp", meta = (ClampMin = 0, ClampMax = 1))
+	float CandidateApproachWeight;
+
 	// Weld bodies (meshes) on fixation
 	UPROPERTY(EditAnywhere, Category = "Fixation Grasp")
 	bool bWeldBodies;
@@ -121,8 +137,16 @@ private:
 	AStaticMeshActor* GraspedObject;
 
 	// Potential objects that can be grasped, currently overlapping the sphere
-	TArray<AStaticMeshActor*> ObjectsInSphereArea;
+	FMCGraspCandidates ObjectsInSphereArea;
+
+	// Number of grasped object poses kept for the release velocity estimation
+	UPROPERTY(EditAnywhere, Category = "Fixation Grasp|Release", meta = (ClampMin = 2))
+	int32 ReleasePoseHistorySize;
+
+	// Time window (s) of the poses used for the release velocity least-squares fit
+	UPROPERTY(EditAnywhere, Category = "Fixation Grasp|Release", meta = (ClampMin = 0))
+	float ReleaseVelocityWindow;
 
-	/* Constants */
-	constexpr static float VelocityBoostAtRelease = 1.5f;
+	// Pose history of the grasped object
+	FMCPoseHistory GraspedObjectPoseHistory;
 };
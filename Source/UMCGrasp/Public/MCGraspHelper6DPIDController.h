@@ -4,7 +4,8 @@
 #pragma once
 
 #include "EngineMinimal.h"
-#include "MCPIDController3D.h"
+#include "MCPIDControllerBatch3D.h"
+#include "MC6DPhysicsCommands.h"
 #include "MCGraspHelper6DPIDController.generated.h"
 
 // Forward declarations
@@ -31,7 +32,8 @@ enum class EMCGraspHelp6DControlType : uint8
 };
 
 /**
- * 6D controller update callbacks
+ * 6D controller update callbacks, every grasped object keeps its own offset and pid state,
+ * all the objects are updated in a single batched loop
  */
 USTRUCT(/*BlueprintType*/)
 struct FMCGraspHelper6DPIDController
@@ -45,16 +47,16 @@ public:
 	// Destructor
 	~FMCGraspHelper6DPIDController() = default;
 
-	// Init as static mesh with an offset
+	// Init with the static meshes to control and their offsets relative to the target
 	void Init(USceneComponent* InTarget,
-		UStaticMeshComponent* InSelfAsStaticMesh,
+		const TArray<UStaticMeshComponent*>& InSelfAsStaticMeshes,
 		EMCGraspHelp6DControlType LocControlType,
 		float PLoc, float ILoc, float DLoc, float MaxLoc,
 		EMCGraspHelp6DControlType RotControlType,
 		float PRot, float IRot, float DRot, float MaxRot,
 		FTransform InOffset);
 
-	// Clear the update function
+	// Clear the update functions and the controlled objects
 	void Clear();
 
 	// Reset the location pid controller
@@ -69,21 +71,39 @@ public:
 	// Get the location delta (error)
 	FVector GetRotationDelta(const FQuat& From, const FQuat& To);
 
+private:
+	// Compute the target transform of every object
+	void UpdateTargets();
+
+	// Compute the location errors of every object and run the pid batch
+	void UpdateLocPID(float DeltaTime);
+
+	// Compute the rotation errors of every object and run the pid batch
+	void UpdateRotPID(float DeltaTime);
+
 private:
 	// Target (goal) component (to which transform to move to)
 	USceneComponent* TargetSceneComp;
 
-	// Relative offset to target (goal)
-	FTransform LocalTargetOffset;
+	// Relative offset to target (goal) of every object
+	TArray<FTransform> LocalTargetOffsets;
+
+	// Self as static meshes (from which transform to move away)
+	TArray<UStaticMeshComponent*> SelfAsStaticMeshComps;
+
+	// Location pid controllers
+	FMCPIDControllerBatch3D PIDLoc;
 
-	// Self as static mesh (from which transform to move away)
-	UStaticMeshComponent* SelfAsStaticMeshComp;
+	// Rotation pid controllers
+	FMCPIDControllerBatch3D PIDRot;
 
-	// Location pid controller
-	FMCPIDController3D PIDLoc;
+	// Per frame buffers, kept to avoid reallocations
+	TArray<FTransform> CurrentTargets;
+	TArray<FVector> Errors;
+	TArray<FVector> Outputs;
 
-	// Rotation pid controller
-	FMCPIDController3D PIDRot;
+	// Physics writes list of the world (shared by all the controllers, submitted before the physics step)
+	FMC6DPhysicsCommandList* Commands = nullptr;
 
 	/* Update function bindings */
 	// Function pointer type for calling the correct update function
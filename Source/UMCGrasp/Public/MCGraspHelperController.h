@@ -7,6 +7,8 @@
 #include "Components/SphereComponent.h"
 #include "MCStructs.h"
 #include "MCGraspHelper6DPIDController.h"
+#include "MCGraspCandidates.h"
+#include "PhysicsEngine/ConstraintInstance.h"
 #include "MCGraspHelperController.generated.h"
 
 // Forward declaration
@@ -14,6 +16,20 @@ class AStaticMeshActor;
 class UStaticMeshComponent;
 class UPhysicsConstraintComponent;
 class USkeletalMeshComponent;
+class AMCGraspConstraintPool;
+
+// Object helped with grasping
+struct FMCGraspHelperObject
+{
+	// The helped object
+	AStaticMeshActor* Actor;
+
+	// The static mesh component of the object
+	UStaticMeshComponent* SMC;
+
+	// Constraint borrowed from the pool (nullptr if not constrained)
+	UPhysicsConstraintComponent* ConstraintComp;
+};
 
 /**
  * Grasp helper controller - applies various test forces to keep the graped objects in hand
@@ -56,6 +72,9 @@ private:
 	// Toggle help
 	void ToggleHelp();
 
+	// Refresh the candidate scores while the trigger is pre-pressed
+	void PreGraspUpdateCallback(float Value);
+
 	// Update the grasp
 	void UpdateHelp(float DeltaTime);
 
@@ -102,6 +121,14 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Grasp Helper")
 	FName InputActionName;
 
+	// Trigger axis, while pre-pressed the candidate scores are refreshed every frame
+	UPROPERTY(EditAnywhere, Category = "Grasp Helper")
+	FName InputPreGraspAxisName;
+
+	// Weight [0-1] of the hand movement direction in the candidate selection, 0 means closest only
+	UPROPERTY(EditAnywhere, Category = "Grasp Helper", meta = (ClampMin = 0, ClampMax = 1))
+	float CandidateApproachWeight;
+
 	// Attract bodies (meshes) on grasp
 	UPROPERTY(EditAnywhere, Category = "Grasp Helper|AttractionForce")
 	bool bUseAttractionForce;
@@ -177,6 +204,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Grasp Helper|Attachment", meta = (editcondition = "bUseAttachment"))
 	FName BoneName;
 
+	// Max number of objects helped at once (e.g. a tray with items)
+	UPROPERTY(EditAnywhere, Category = "Grasp Helper", meta = (ClampMin = 1))
+	int32 MaxGraspedObjects;
+
 	// Disable gravity on grasp
 	UPROPERTY(EditAnywhere, Category = "Grasp Helper")
 	bool bDisableGravity;
@@ -200,20 +231,20 @@ private:
 	// Keep track if the help is active or not
 	bool bHelpIsActive;
 
-	// Pointer to the object which should be helped (nullptr if no object is in the area)
-	AStaticMeshActor* GraspedObject;
+	// The objects which are helped (empty if no object is grasped)
+	TArray<FMCGraspHelperObject> GraspedObjects;
 
-	// The static mesh component of the object
-	UStaticMeshComponent* GraspedObjectSMC;
-
-	// Set of potential objects to be grasped (objects currently overlapping the area)
-	TSet<AStaticMeshActor*> OverlappingCandidates;
+	// Potential objects to be grasped (objects currently overlapping the area)
+	FMCGraspCandidates OverlappingCandidates;
 
 	// Owner skeletal mesh component
 	USkeletalMeshComponent* OwnerSkelMC;
 
-	// Constraint component
-	UPROPERTY(VisibleAnywhere, Category = "Grasp Helper")
-	UPhysicsConstraintComponent* ConstraintHelperComponent;
+	// Constraint profile built at init and copied to the borrowed constraint components
+	FConstraintProfileProperties ConstraintProfile;
+
+	// World pool of the constraint components
+	UPROPERTY()
+	AMCGraspConstraintPool* ConstraintPool;
 
 };
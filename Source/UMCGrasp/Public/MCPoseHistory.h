@@ -0,0 +1,51 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed size ring buffer of timestamped poses, used to estimate velocities with a least-squares fit
+ */
+class UMCGRASP_API FMCPoseHistory
+{
+public:
+	// Default ctor
+	FMCPoseHistory();
+
+	// Clear the samples and set the buffer size
+	void Reset(int32 InCapacity);
+
+	// Add a sample, overwriting the oldest one if the buffer is full
+	void Add(float InTime, const FTransform& InPose);
+
+	// Number of stored samples
+	int32 Num() const { return NumSamples; }
+
+	// Estimate the linear (cm/s) and angular (rad/s) velocity from the samples of the last window (s),
+	// return false if there are not enough samples
+	bool EstimateVelocity(float InWindow, FVector& OutLinear, FVector& OutAngular) const;
+
+private:
+	// Timestamped pose
+	struct FSample
+	{
+		float Time;
+		FVector Location;
+		FQuat Rotation;
+	};
+
+	// Get the sample with the given age index (0 = newest)
+	const FSample& GetFromNewest(int32 AgeIdx) const;
+
+private:
+	// Samples buffer
+	TArray<FSample> Samples;
+
+	// Index where the next sample will be written
+	int32 Head;
+
+	// Number of valid samples
+	int32 NumSamples;
+};
@@ -47,6 +47,7 @@ public class UMCGrasp : ModuleRules
 				"Slate",
 				"SlateCore",
 				"UMCPIDController", // grasp helper object tracking	
+				"UMC6DController", // grasp helper batched physics writes
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,442 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#include "MCGraspAnimCommandlet.h"
+#include "MCGraspAnimDataAsset.h"
+#include "MCGraspAnimCompressor.h"
+#include "Engine/SkeletalMesh.h"
+#include "AssetRegistryModule.h"
+#include "IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+// Default constructor
+UMCGraspAnimCommandlet::UMCGraspAnimCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	PackagePath = TEXT("/UPhysicsBasedMC/GraspAnimations");
+	bBinary = false;
+	Tolerance = FMCGraspAnimCompressor::DefaultTolerance;
+}
+
+// Commandlet entry point
+int32 UMCGraspAnimCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	const FString Mode = ParamVals.FindRef(TEXT("mode"));
+	Dir = ParamVals.FindRef(TEXT("dir"));
+	MeshPath = ParamVals.FindRef(TEXT("mesh"));
+	bBinary = ParamVals.FindRef(TEXT("format")).Equals(TEXT("bin"), ESearchCase::IgnoreCase);
+	if (const FString* InPackagePath = ParamVals.Find(TEXT("path")))
+	{
+		PackagePath = *InPackagePath;
+	}
+	if (const FString* InTolerance = ParamVals.Find(TEXT("tolerance")))
+	{
+		Tolerance = FCString::Atof(**InTolerance);
+	}
+
+	// Make sure the registry knows about all the assets when running headless
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(FName("AssetRegistry"));
+	AssetRegistryModule.Get().SearchAllAssets(true);
+
+	if (!MeshPath.IsEmpty() && !LoadBoneNames())
+	{
+		return 1;
+	}
+
+	bool bSuccess = false;
+	if (Mode.Equals(TEXT("export"), ESearchCase::IgnoreCase))
+	{
+		bSuccess = Export();
+	}
+	else if (Mode.Equals(TEXT("import"), ESearchCase::IgnoreCase))
+	{
+		bSuccess = Import();
+	}
+	else if (Mode.Equals(TEXT("validate"), ESearchCase::IgnoreCase))
+	{
+		bSuccess = Validate();
+	}
+	else if (Mode.Equals(TEXT("compress"), ESearchCase::IgnoreCase))
+	{
+		bSuccess = Compress();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Unknown mode '%s', use -mode=<export|import|validate|compress>.."),
+			*FString(__func__), __LINE__, *Mode);
+	}
+	return bSuccess ? 0 : 1;
+}
+
+// Write the data assets to interchange files
+bool UMCGraspAnimCommandlet::Export()
+{
+	if (Dir.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d No output folder given (-dir=).."), *FString(__func__), __LINE__);
+		return false;
+	}
+
+	TArray<FMCGraspAnimFileData> AnimsData;
+	LoadDataAssets(AnimsData);
+
+	// The files are named after the asset objects, assets with the same name in different sub folders would overwrite each other
+	TArray<FString> AssetNames;
+	for (const FMCGraspAnimFileData& Data : AnimsData)
+	{
+		AssetNames.Add(Data.AssetName);
+	}
+	if (!ValidateAssetNames(AssetNames))
+	{
+		return false;
+	}
+
+	if (BoneNames.Num() > 0 && !ValidateAll(AnimsData))
+	{
+		return false;
+	}
+
+	IFileManager::Get().MakeDirectory(*Dir, true);
+
+	// Serialize and write the files in parallel, the data is no longer tied to any UObject
+	TArray<bool> Results;
+	Results.SetNumZeroed(AnimsData.Num());
+	ParallelFor(AnimsData.Num(), [&](int32 Idx)
+	{
+		const FMCGraspAnimFileData& Data = AnimsData[Idx];
+		const FString BaseName = Dir / FPaths::MakeValidFileName(Data.AssetName);
+		if (bBinary)
+		{
+			TArray<uint8> Bytes;
+			FMCGraspAnimIO::ToBinary(Data, Bytes);
+			Results[Idx] = FFileHelper::SaveArrayToFile(Bytes, *(BaseName + FMCGraspAnimIO::BinaryExtension));
+		}
+		else
+		{
+			Results[Idx] = FFileHelper::SaveStringToFile(FMCGraspAnimIO::ToJsonString(Data),
+				*(BaseName + FMCGraspAnimIO::JsonExtension));
+		}
+	});
+
+	int32 NumFailed = 0;
+	for (int32 Idx = 0; Idx < Results.Num(); ++Idx)
+	{
+		if (!Results[Idx])
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %s.."), *FString(__func__), __LINE__, *AnimsData[Idx].AssetName);
+			NumFailed++;
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Exported %d/%d grasp animations to %s.."),
+		*FString(__func__), __LINE__, AnimsData.Num() - NumFailed, AnimsData.Num(), *Dir);
+	return NumFailed == 0;
+}
+
+// Create or update the data assets from the interchange files
+bool UMCGraspAnimCommandlet::Import()
+{
+	if (Dir.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d No input folder given (-dir=).."), *FString(__func__), __LINE__);
+		return false;
+	}
+
+	const TCHAR* Extension = bBinary ? FMCGraspAnimIO::BinaryExtension : FMCGraspAnimIO::JsonExtension;
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *Dir, Extension);
+
+	// The asset object names come from the file names, not from the user editable name stored in the files
+	TArray<FString> AssetNames;
+	for (const FString& FileName : FileNames)
+	{
+		AssetNames.Add(FPaths::GetBaseFilename(FileName));
+	}
+	if (!ValidateAssetNames(AssetNames))
+	{
+		return false;
+	}
+
+	// Read and parse the files in parallel
+	TArray<FMCGraspAnimFileData> AnimsData;
+	AnimsData.SetNum(FileNames.Num());
+	TArray<bool> Results;
+	Results.SetNumZeroed(FileNames.Num());
+	ParallelFor(FileNames.Num(), [&](int32 Idx)
+	{
+		const FString FilePath = Dir / FileNames[Idx];
+		AnimsData[Idx].Source = FilePath;
+		AnimsData[Idx].AssetName = AssetNames[Idx];
+		if (bBinary)
+		{
+			TArray<uint8> Bytes;
+			Results[Idx] = FFileHelper::LoadFileToArray(Bytes, *FilePath)
+				&& FMCGraspAnimIO::FromBinary(Bytes, AnimsData[Idx]);
+		}
+		else
+		{
+			FString JsonString;
+			Results[Idx] = FFileHelper::LoadFileToString(JsonString, *FilePath)
+				&& FMCGraspAnimIO::FromJsonString(JsonString, AnimsData[Idx]);
+		}
+	});
+
+	// Keep only the correctly parsed files
+	int32 NumFailed = 0;
+	for (int32 Idx = Results.Num() - 1; Idx >= 0; --Idx)
+	{
+		if (!Results[Idx])
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not parse %s.."), *FString(__func__), __LINE__, *AnimsData[Idx].Source);
+			AnimsData.RemoveAt(Idx);
+			NumFailed++;
+		}
+	}
+
+	if (BoneNames.Num() > 0 && !ValidateAll(AnimsData))
+	{
+		return false;
+	}
+
+	// Existing assets are updated in place (they can be in sub folders), the new ones are created in the package path
+	TArray<FAssetData> AssetList;
+	GetDataAssetList(AssetList);
+	TMap<FString, FString> ExistingPackages;
+	for (const FAssetData& AssetData : AssetList)
+	{
+		ExistingPackages.Add(AssetData.AssetName.ToString(), AssetData.PackageName.ToString());
+	}
+
+	// Asset creation and saving has to happen on the game thread
+	for (const FMCGraspAnimFileData& Data : AnimsData)
+	{
+		const FString* ExistingPackage = ExistingPackages.Find(Data.AssetName);
+		if (!WriteDataAsset(Data, ExistingPackage ? *ExistingPackage : PackagePath / Data.AssetName))
+		{
+			NumFailed++;
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Imported %d/%d grasp animations to %s.."),
+		*FString(__func__), __LINE__, FileNames.Num() - NumFailed, FileNames.Num(), *PackagePath);
+	return NumFailed == 0;
+}
+
+// Validate the data assets bone names against the skeletal mesh
+bool UMCGraspAnimCommandlet::Validate()
+{
+	if (BoneNames.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d No skeletal mesh given (-mesh=).."), *FString(__func__), __LINE__);
+		return false;
+	}
+
+	TArray<FMCGraspAnimFileData> AnimsData;
+	LoadDataAssets(AnimsData);
+	const bool bValid = ValidateAll(AnimsData);
+
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Validated %d grasp animations against %s.."),
+		*FString(__func__), __LINE__, AnimsData.Num(), *MeshPath);
+	return bValid;
+}
+
+// Compress the data assets and report the statistics
+bool UMCGraspAnimCommandlet::Compress()
+{
+	TArray<FMCGraspAnimFileData> AnimsData;
+	TArray<UMCGraspAnimDataAsset*> DataAssets;
+	LoadDataAssets(AnimsData, &DataAssets);
+
+	// Compress the copies in parallel, the results are written back to the assets on the game thread
+	TArray<FMCGraspAnimCompressedData> CompressedData;
+	CompressedData.SetNum(AnimsData.Num());
+	ParallelFor(AnimsData.Num(), [&](int32 Idx)
+	{
+		FMCGraspAnimCompressor::Compress(AnimsData[Idx].Frames, Tolerance, CompressedData[Idx]);
+	});
+
+	int32 NumFailed = 0;
+	int32 TotalRawSize = 0;
+	int32 TotalCompressedSize = 0;
+	int64 TotalFileSize = 0;
+	float MaxError = 0.f;
+	for (int32 Idx = 0; Idx < DataAssets.Num(); ++Idx)
+	{
+		UMCGraspAnimDataAsset* DataAsset = DataAssets[Idx];
+		DataAsset->CompressedData = CompressedData[Idx];
+		DataAsset->MarkPackageDirty();
+
+		UPackage* AssetPackage = DataAsset->GetOutermost();
+		const FString PackageFileName = FPackageName::LongPackageNameToFilename(AssetPackage->GetName(), FPackageName::GetAssetPackageExtension());
+		if (!UPackage::SavePackage(AssetPackage, DataAsset, RF_Public | RF_Standalone, *PackageFileName))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Failed to save %s to %s.."), *FString(__func__), __LINE__, *AnimsData[Idx].Name, *PackageFileName);
+			NumFailed++;
+			continue;
+		}
+
+		// The editor package keeps the frames, report its actual size next to the payload sizes
+		const int64 FileSize = IFileManager::Get().FileSize(*PackageFileName);
+		UE_LOG(LogTemp, Display, TEXT("%s::%d %s: %s; Package=%lld bytes on disk"), *FString(__func__), __LINE__,
+			*AnimsData[Idx].Name, *FMCGraspAnimCompressor::GetStatsString(CompressedData[Idx]), FileSize);
+		TotalFileSize += FMath::Max<int64>(FileSize, 0);
+		TotalRawSize += CompressedData[Idx].RawSize;
+		TotalCompressedSize += CompressedData[Idx].CompressedSize;
+		MaxError = FMath::Max(MaxError, CompressedData[Idx].MaxError);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Compressed %d/%d grasp animations; Cooked size=%d->%d bytes; Editor packages=%lld bytes on disk; MaxError=%.3f deg (tolerance=%.3f).."),
+		*FString(__func__), __LINE__, DataAssets.Num() - NumFailed, DataAssets.Num(), TotalRawSize, TotalCompressedSize, TotalFileSize, MaxError, Tolerance);
+	return NumFailed == 0;
+}
+
+// Load and copy the data of all the data assets from the package path
+void UMCGraspAnimCommandlet::LoadDataAssets(TArray<FMCGraspAnimFileData>& OutData, TArray<UMCGraspAnimDataAsset*>* OutAssets)
+{
+	TArray<FAssetData> AssetList;
+	GetDataAssetList(AssetList);
+
+	OutData.Reserve(AssetList.Num());
+	for (const FAssetData& AssetData : AssetList)
+	{
+		if (UMCGraspAnimDataAsset* DataAsset = Cast<UMCGraspAnimDataAsset>(AssetData.GetAsset()))
+		{
+			FMCGraspAnimFileData& Data = OutData.AddDefaulted_GetRef();
+			Data.AssetName = AssetData.AssetName.ToString();
+			Data.Name = DataAsset->Name.IsEmpty() ? Data.AssetName : DataAsset->Name;
+			Data.Frames = DataAsset->Frames;
+			Data.Source = AssetData.ObjectPath.ToString();
+			if (OutAssets)
+			{
+				OutAssets->Add(DataAsset);
+			}
+		}
+	}
+}
+
+// Get the registry data of all the data assets from the package path
+void UMCGraspAnimCommandlet::GetDataAssetList(TArray<FAssetData>& OutAssetList) const
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(FName("AssetRegistry"));
+	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+
+	FARFilter Filter;
+	Filter.ClassNames = { TEXT("MCGraspAnimDataAsset") };
+	Filter.PackagePaths.Add(FName(*PackagePath));
+	Filter.bRecursivePaths = true;
+
+	AssetRegistry.GetAssets(Filter, OutAssetList);
+}
+
+// Check that the asset names are valid and unique, return false otherwise
+bool UMCGraspAnimCommandlet::ValidateAssetNames(const TArray<FString>& InAssetNames) const
+{
+	bool bValid = true;
+	// FString keys are case insensitive, same as the file system and the package names
+	TSet<FString> UsedNames;
+	for (const FString& AssetName : InAssetNames)
+	{
+		FText Reason;
+		if (AssetName.IsEmpty())
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Empty asset name.."), *FString(__func__), __LINE__);
+			bValid = false;
+		}
+		else if (!FName::IsValidXName(AssetName, INVALID_OBJECTNAME_CHARACTERS INVALID_LONGPACKAGE_CHARACTERS, &Reason)
+			|| FPaths::MakeValidFileName(AssetName) != AssetName)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Invalid asset name '%s': %s"),
+				*FString(__func__), __LINE__, *AssetName, *Reason.ToString());
+			bValid = false;
+		}
+		else if (UsedNames.Contains(AssetName))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Duplicate asset name '%s'.."), *FString(__func__), __LINE__, *AssetName);
+			bValid = false;
+		}
+		UsedNames.Add(AssetName);
+	}
+	return bValid;
+}
+
+// Load the bone names of the validation skeletal mesh, return false if the mesh cannot be loaded
+bool UMCGraspAnimCommandlet::LoadBoneNames()
+{
+	USkeletalMesh* SkelMesh = LoadObject<USkeletalMesh>(nullptr, *MeshPath);
+	if (!SkelMesh)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not load skeletal mesh %s.."), *FString(__func__), __LINE__, *MeshPath);
+		return false;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = SkelMesh->RefSkeleton;
+	for (int32 BoneIdx = 0; BoneIdx < RefSkeleton.GetNum(); ++BoneIdx)
+	{
+		BoneNames.Add(RefSkeleton.GetBoneName(BoneIdx).ToString());
+	}
+	return true;
+}
+
+// Validate the bone names of the data in parallel, return false if any bone is missing
+bool UMCGraspAnimCommandlet::ValidateAll(const TArray<FMCGraspAnimFileData>& InData) const
+{
+	TArray<TArray<FString>> MissingBones;
+	MissingBones.SetNum(InData.Num());
+	ParallelFor(InData.Num(), [&](int32 Idx)
+	{
+		FMCGraspAnimIO::ValidateBoneNames(InData[Idx], BoneNames, MissingBones[Idx]);
+	});
+
+	bool bValid = true;
+	for (int32 Idx = 0; Idx < InData.Num(); ++Idx)
+	{
+		if (MissingBones[Idx].Num() > 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d %s (%s) has bones missing from %s: %s"),
+				*FString(__func__), __LINE__, *InData[Idx].Name, *InData[Idx].Source, *MeshPath,
+				*FString::Join(MissingBones[Idx], TEXT(", ")));
+			bValid = false;
+		}
+	}
+	return bValid;
+}
+
+// Create or update the data asset and save its package
+bool UMCGraspAnimCommandlet::WriteDataAsset(const FMCGraspAnimFileData& InData, const FString& PackageName) const
+{
+	UPackage* AssetPackage = CreatePackage(nullptr, *PackageName);
+	AssetPackage->FullyLoad();
+
+	UMCGraspAnimDataAsset* DataAsset = FindObject<UMCGraspAnimDataAsset>(AssetPackage, *InData.AssetName);
+	if (!DataAsset)
+	{
+		DataAsset = NewObject<UMCGraspAnimDataAsset>(AssetPackage, FName(*InData.AssetName), RF_Standalone | RF_Public);
+		FAssetRegistryModule::AssetCreated(DataAsset);
+	}
+	DataAsset->Name = InData.Name;
+	DataAsset->Frames = InData.Frames;
+	FMCGraspAnimCompressor::Compress(DataAsset, Tolerance);
+	UE_LOG(LogTemp, Display, TEXT("%s::%d %s: %s"), *FString(__func__), __LINE__,
+		*InData.AssetName, *FMCGraspAnimCompressor::GetStatsString(DataAsset->CompressedData));
+
+	const FString PackageFileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+	if (!UPackage::SavePackage(AssetPackage, DataAsset, RF_Public | RF_Standalone, *PackageFileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Failed to save %s to %s.."), *FString(__func__), __LINE__, *InData.AssetName, *PackageFileName);
+		return false;
+	}
+	return true;
+}
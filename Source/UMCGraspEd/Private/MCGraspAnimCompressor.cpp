@@ -0,0 +1,184 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#include "MCGraspAnimCompressor.h"
+
+const float FMCGraspAnimCompressor::DefaultTolerance = 0.5f;
+
+// Serialized size of the string (length and characters with the terminator)
+static int32 GetSerializedSize(const FString& InString)
+{
+	const int32 CharSize = FCString::IsPureAnsi(*InString) ? sizeof(ANSICHAR) : sizeof(UCS2CHAR);
+	return sizeof(int32) + (InString.Len() > 0 ? (InString.Len() + 1) * CharSize : 0);
+}
+
+// Compress the frames, return false if there is nothing to compress
+bool FMCGraspAnimCompressor::Compress(const TArray<FMCGraspAnimFrameData>& InFrames, float InTolerance, FMCGraspAnimCompressedData& OutData)
+{
+	OutData = FMCGraspAnimCompressedData();
+	if (InFrames.Num() < 2 || InFrames.Num() > MAX_uint16)
+	{
+		return false;
+	}
+
+	// Bone names in the order of their first appearance, the frames size counts the names and both rotations of every entry
+	TArray<FString> BoneNames;
+	int32 FramesSize = sizeof(int32);
+	for (const FMCGraspAnimFrameData& Frame : InFrames)
+	{
+		FramesSize += sizeof(int32);
+		for (const auto& BoneData : Frame.BonesData)
+		{
+			BoneNames.AddUnique(BoneData.Key);
+			FramesSize += GetSerializedSize(BoneData.Key) + sizeof(FMCGraspAnimBoneOrientation);
+		}
+	}
+	if (BoneNames.Num() == 0)
+	{
+		return false;
+	}
+
+	OutData.NumFrames = InFrames.Num();
+	OutData.Tolerance = InTolerance;
+	OutData.RawSize = FramesSize;
+	OutData.Tracks.SetNum(BoneNames.Num());
+
+	// Tracks array and the scalar stats
+	OutData.CompressedSize = sizeof(int32) + 4 * sizeof(int32) + 4 * sizeof(float);
+
+	TArray<FRotator> Values;
+	for (int32 BoneIdx = 0; BoneIdx < BoneNames.Num(); ++BoneIdx)
+	{
+		// Gather the values of the bone, frames missing the bone keep the previous value
+		Values.Reset(InFrames.Num());
+		FRotator LastValue = FRotator::ZeroRotator;
+		bool bHasValue = false;
+		for (const FMCGraspAnimFrameData& Frame : InFrames)
+		{
+			if (const FMCGraspAnimBoneOrientation* BoneData = Frame.BonesData.Find(BoneNames[BoneIdx]))
+			{
+				LastValue = BoneData->AngularOrientationTarget;
+				if (!bHasValue)
+				{
+					// Backfill the frames before the first appearance
+					for (FRotator& Value : Values)
+					{
+						Value = LastValue;
+					}
+					bHasValue = true;
+				}
+			}
+			Values.Add(LastValue);
+		}
+
+		FMCGraspAnimCompressedTrack& Track = OutData.Tracks[BoneIdx];
+		Track.BoneName = BoneNames[BoneIdx];
+		CompressTrack(Values, InTolerance, Track);
+
+		// Stats
+		if (Track.KeyFrames.Num() == 1)
+		{
+			OutData.NumStaticBones++;
+		}
+		OutData.NumKeys += Track.KeyFrames.Num();
+		OutData.CompressedSize += GetSerializedSize(Track.BoneName) + 2 * sizeof(int32) +
+			Track.KeyFrames.Num() * sizeof(uint16) + Track.KeyValues.Num() * sizeof(uint16);
+		for (int32 FrameIdx = 0; FrameIdx < Values.Num(); ++FrameIdx)
+		{
+			OutData.MaxError = FMath::Max(OutData.MaxError, AngularError(Values[FrameIdx], Track.Sample(FrameIdx)));
+		}
+	}
+	return true;
+}
+
+// Compress the frames of the data asset and store the result in it
+bool FMCGraspAnimCompressor::Compress(UMCGraspAnimDataAsset* DataAsset, float InTolerance)
+{
+	if (!DataAsset)
+	{
+		return false;
+	}
+
+	FMCGraspAnimCompressedData CompressedData;
+	const bool bCompressed = Compress(DataAsset->Frames, InTolerance, CompressedData);
+	DataAsset->CompressedData = CompressedData;
+	DataAsset->MarkPackageDirty();
+	return bCompressed;
+}
+
+// Get the compression statistics as a readable string
+FString FMCGraspAnimCompressor::GetStatsString(const FMCGraspAnimCompressedData& InData)
+{
+	const float Ratio = InData.CompressedSize > 0 ? static_cast<float>(InData.RawSize) / InData.CompressedSize : 0.f;
+	return FString::Printf(TEXT("Frames=%d; Bones=%d (static=%d); Keys=%d; Cooked size=%d->%d bytes (%.1fx); Editor size=%d bytes (frames and tracks); MaxError=%.3f deg (tolerance=%.3f)"),
+		InData.NumFrames, InData.Tracks.Num(), InData.NumStaticBones, InData.NumKeys,
+		InData.RawSize, InData.CompressedSize, Ratio, InData.RawSize + InData.CompressedSize, InData.MaxError, InData.Tolerance);
+}
+
+// Compress the values of a single bone
+void FMCGraspAnimCompressor::CompressTrack(const TArray<FRotator>& InValues, float InTolerance, FMCGraspAnimCompressedTrack& OutTrack)
+{
+	const int32 LastIdx = InValues.Num() - 1;
+
+	// Static bone, a single key covers every frame
+	const FRotator FirstKey = Quantize(InValues[0]);
+	bool bIsStatic = true;
+	for (int32 FrameIdx = 1; FrameIdx <= LastIdx && bIsStatic; ++FrameIdx)
+	{
+		bIsStatic = AngularError(InValues[FrameIdx], FirstKey) <= InTolerance;
+	}
+	AddKey(OutTrack, 0, InValues[0]);
+	if (bIsStatic)
+	{
+		return;
+	}
+
+	// Greedily extend every segment as far as the interpolated values stay under the error threshold
+	int32 AnchorIdx = 0;
+	FRotator AnchorKey = FirstKey;
+	while (AnchorIdx < LastIdx)
+	{
+		int32 EndIdx = AnchorIdx + 1;
+		for (int32 CandidateIdx = AnchorIdx + 2; CandidateIdx <= LastIdx; ++CandidateIdx)
+		{
+			const FRotator CandidateKey = Quantize(InValues[CandidateIdx]);
+			bool bWithinTolerance = true;
+			for (int32 FrameIdx = AnchorIdx + 1; FrameIdx < CandidateIdx && bWithinTolerance; ++FrameIdx)
+			{
+				const float Alpha = static_cast<float>(FrameIdx - AnchorIdx) / (CandidateIdx - AnchorIdx);
+				bWithinTolerance = AngularError(InValues[FrameIdx], FMath::LerpRange(AnchorKey, CandidateKey, Alpha)) <= InTolerance;
+			}
+			if (!bWithinTolerance)
+			{
+				break;
+			}
+			EndIdx = CandidateIdx;
+		}
+
+		AddKey(OutTrack, EndIdx, InValues[EndIdx]);
+		AnchorIdx = EndIdx;
+		AnchorKey = Quantize(InValues[EndIdx]);
+	}
+}
+
+// Add a quantized key to the track
+void FMCGraspAnimCompressor::AddKey(FMCGraspAnimCompressedTrack& OutTrack, int32 FrameIdx, const FRotator& InValue)
+{
+	OutTrack.KeyFrames.Add(static_cast<uint16>(FrameIdx));
+	OutTrack.KeyValues.Add(FRotator::CompressAxisToShort(InValue.Pitch));
+	OutTrack.KeyValues.Add(FRotator::CompressAxisToShort(InValue.Yaw));
+	OutTrack.KeyValues.Add(FRotator::CompressAxisToShort(InValue.Roll));
+}
+
+// Quantize the rotation the same way as the stored keys
+FRotator FMCGraspAnimCompressor::Quantize(const FRotator& InValue)
+{
+	return FRotator(FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(InValue.Pitch)),
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(InValue.Yaw)),
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(InValue.Roll)));
+}
+
+// Angle between the two rotations (degrees)
+float FMCGraspAnimCompressor::AngularError(const FRotator& A, const FRotator& B)
+{
+	return FMath::RadiansToDegrees(A.Quaternion().AngularDistance(B.Quaternion()));
+}
@@ -0,0 +1,229 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#include "MCGraspAnimIO.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+const TCHAR* FMCGraspAnimIO::JsonExtension = TEXT(".json");
+const TCHAR* FMCGraspAnimIO::BinaryExtension = TEXT(".mcga");
+const uint32 FMCGraspAnimIO::BinaryMagic = 0x4147434D; // 'MCGA'
+const int32 FMCGraspAnimIO::BinaryVersion = 1;
+
+// Helpers for writing/reading rotators as json objects
+static TSharedRef<FJsonObject> RotatorToJson(const FRotator& InRotator)
+{
+	TSharedRef<FJsonObject> JsonRotator = MakeShared<FJsonObject>();
+	JsonRotator->SetNumberField(TEXT("Pitch"), InRotator.Pitch);
+	JsonRotator->SetNumberField(TEXT("Yaw"), InRotator.Yaw);
+	JsonRotator->SetNumberField(TEXT("Roll"), InRotator.Roll);
+	return JsonRotator;
+}
+
+static bool JsonToRotator(const TSharedPtr<FJsonObject>& InJsonParent, const TCHAR* InFieldName, FRotator& OutRotator)
+{
+	const TSharedPtr<FJsonObject>* JsonRotator;
+	double Pitch, Yaw, Roll;
+	if (InJsonParent->TryGetObjectField(InFieldName, JsonRotator)
+		&& (*JsonRotator)->TryGetNumberField(TEXT("Pitch"), Pitch)
+		&& (*JsonRotator)->TryGetNumberField(TEXT("Yaw"), Yaw)
+		&& (*JsonRotator)->TryGetNumberField(TEXT("Roll"), Roll))
+	{
+		OutRotator = FRotator(Pitch, Yaw, Roll);
+		return true;
+	}
+	return false;
+}
+
+// Write the animation as a json string
+FString FMCGraspAnimIO::ToJsonString(const FMCGraspAnimFileData& InData)
+{
+	TSharedRef<FJsonObject> JsonAnim = MakeShared<FJsonObject>();
+	JsonAnim->SetStringField(TEXT("Name"), InData.Name);
+
+	TArray<TSharedPtr<FJsonValue>> JsonFrames;
+	JsonFrames.Reserve(InData.Frames.Num());
+	for (const FMCGraspAnimFrameData& Frame : InData.Frames)
+	{
+		TSharedRef<FJsonObject> JsonBones = MakeShared<FJsonObject>();
+		for (const auto& BoneData : Frame.BonesData)
+		{
+			TSharedRef<FJsonObject> JsonBone = MakeShared<FJsonObject>();
+			JsonBone->SetObjectField(TEXT("AngularOrientationTarget"), RotatorToJson(BoneData.Value.AngularOrientationTarget));
+			JsonBone->SetObjectField(TEXT("BoneSpaceRotation"), RotatorToJson(BoneData.Value.BoneSpaceRotation));
+			JsonBones->SetObjectField(BoneData.Key, JsonBone);
+		}
+
+		TSharedRef<FJsonObject> JsonFrame = MakeShared<FJsonObject>();
+		JsonFrame->SetObjectField(TEXT("BonesData"), JsonBones);
+		JsonFrames.Add(MakeShared<FJsonValueObject>(JsonFrame));
+	}
+	JsonAnim->SetArrayField(TEXT("Frames"), JsonFrames);
+
+	FString OutString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutString);
+	FJsonSerializer::Serialize(JsonAnim, Writer);
+	return OutString;
+}
+
+// Read the animation from a json string, return false on parsing errors
+bool FMCGraspAnimIO::FromJsonString(const FString& InJsonString, FMCGraspAnimFileData& OutData)
+{
+	TSharedPtr<FJsonObject> JsonAnim;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(InJsonString);
+	if (!FJsonSerializer::Deserialize(Reader, JsonAnim) || !JsonAnim.IsValid())
+	{
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* JsonFrames;
+	if (!JsonAnim->TryGetStringField(TEXT("Name"), OutData.Name)
+		|| !JsonAnim->TryGetArrayField(TEXT("Frames"), JsonFrames))
+	{
+		return false;
+	}
+
+	OutData.Frames.Empty(JsonFrames->Num());
+	for (const TSharedPtr<FJsonValue>& JsonFrameValue : *JsonFrames)
+	{
+		const TSharedPtr<FJsonObject>* JsonFrame;
+		const TSharedPtr<FJsonObject>* JsonBones;
+		if (!JsonFrameValue->TryGetObject(JsonFrame)
+			|| !(*JsonFrame)->TryGetObjectField(TEXT("BonesData"), JsonBones))
+		{
+			return false;
+		}
+
+		FMCGraspAnimFrameData& Frame = OutData.Frames.AddDefaulted_GetRef();
+		for (const auto& JsonBone : (*JsonBones)->Values)
+		{
+			const TSharedPtr<FJsonObject>* JsonBoneObj;
+			if (!JsonBone.Value->TryGetObject(JsonBoneObj))
+			{
+				return false;
+			}
+
+			FMCGraspAnimBoneOrientation BoneData;
+			if (!JsonToRotator(*JsonBoneObj, TEXT("AngularOrientationTarget"), BoneData.AngularOrientationTarget)
+				|| !JsonToRotator(*JsonBoneObj, TEXT("BoneSpaceRotation"), BoneData.BoneSpaceRotation))
+			{
+				return false;
+			}
+			Frame.BonesData.Add(JsonBone.Key, BoneData);
+		}
+	}
+	return true;
+}
+
+// Write the animation in the packed binary format (bone name table + indexed rotations)
+void FMCGraspAnimIO::ToBinary(const FMCGraspAnimFileData& InData, TArray<uint8>& OutBytes)
+{
+	// Every frame usually references the same bones, store their names only once
+	TArray<FString> BoneNames;
+	TMap<FString, uint16> BoneNameToIndex;
+	for (const FMCGraspAnimFrameData& Frame : InData.Frames)
+	{
+		for (const auto& BoneData : Frame.BonesData)
+		{
+			if (!BoneNameToIndex.Contains(BoneData.Key))
+			{
+				BoneNameToIndex.Add(BoneData.Key, static_cast<uint16>(BoneNames.Add(BoneData.Key)));
+			}
+		}
+	}
+
+	FMemoryWriter Ar(OutBytes);
+	uint32 Magic = BinaryMagic;
+	int32 Version = BinaryVersion;
+	FString Name = InData.Name;
+	int32 NumFrames = InData.Frames.Num();
+	Ar << Magic << Version << Name << BoneNames << NumFrames;
+
+	for (const FMCGraspAnimFrameData& Frame : InData.Frames)
+	{
+		uint16 NumBones = static_cast<uint16>(Frame.BonesData.Num());
+		Ar << NumBones;
+		for (const auto& BoneData : Frame.BonesData)
+		{
+			uint16 BoneIndex = BoneNameToIndex[BoneData.Key];
+			FRotator Target = BoneData.Value.AngularOrientationTarget;
+			FRotator BoneSpace = BoneData.Value.BoneSpaceRotation;
+			Ar << BoneIndex << Target << BoneSpace;
+		}
+	}
+}
+
+// Read the animation from the packed binary format, return false if the data is corrupt
+bool FMCGraspAnimIO::FromBinary(const TArray<uint8>& InBytes, FMCGraspAnimFileData& OutData)
+{
+	FMemoryReader Ar(InBytes);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Ar << Magic << Version;
+	if (Ar.IsError() || Magic != BinaryMagic || Version != BinaryVersion)
+	{
+		return false;
+	}
+
+	// The counts come from the file, reject the ones the remaining bytes can not hold before allocating
+	// (every bone name stores at least its length, every frame at least its bone count)
+	int32 NumBoneNames = 0;
+	Ar << OutData.Name << NumBoneNames;
+	if (Ar.IsError() || NumBoneNames < 0 || NumBoneNames > (Ar.TotalSize() - Ar.Tell()) / static_cast<int64>(sizeof(int32)))
+	{
+		return false;
+	}
+	TArray<FString> BoneNames;
+	BoneNames.SetNum(NumBoneNames);
+	for (FString& BoneName : BoneNames)
+	{
+		Ar << BoneName;
+	}
+
+	int32 NumFrames = 0;
+	Ar << NumFrames;
+	if (Ar.IsError() || NumFrames < 0 || NumFrames > (Ar.TotalSize() - Ar.Tell()) / static_cast<int64>(sizeof(uint16)))
+	{
+		return false;
+	}
+
+	OutData.Frames.Empty(NumFrames);
+	for (int32 FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx)
+	{
+		uint16 NumBones = 0;
+		Ar << NumBones;
+
+		FMCGraspAnimFrameData& Frame = OutData.Frames.AddDefaulted_GetRef();
+		for (int32 BoneIdx = 0; BoneIdx < NumBones; ++BoneIdx)
+		{
+			uint16 BoneIndex = 0;
+			FMCGraspAnimBoneOrientation BoneData;
+			Ar << BoneIndex << BoneData.AngularOrientationTarget << BoneData.BoneSpaceRotation;
+			if (Ar.IsError() || !BoneNames.IsValidIndex(BoneIndex))
+			{
+				return false;
+			}
+			Frame.BonesData.Add(BoneNames[BoneIndex], BoneData);
+		}
+	}
+	return !Ar.IsError();
+}
+
+// Check that every bone from the animation exists in the given bone names, return false if any is missing
+bool FMCGraspAnimIO::ValidateBoneNames(const FMCGraspAnimFileData& InData, const TSet<FString>& InBoneNames, TArray<FString>& OutMissingBones)
+{
+	for (const FMCGraspAnimFrameData& Frame : InData.Frames)
+	{
+		for (const auto& BoneData : Frame.BonesData)
+		{
+			if (!InBoneNames.Contains(BoneData.Key))
+			{
+				OutMissingBones.AddUnique(BoneData.Key);
+			}
+		}
+	}
+	return OutMissingBones.Num() == 0;
+}
@@ -1,6 +1,7 @@
 // Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
 
 #include "MCGraspEdUtils.h"
+#include "MCGraspAnimCompressor.h"
 #include "Animation/DebugSkelMeshComponent.h"
 #include "AnimPreviewInstance.h"
 #include "Interfaces/IMainFrameModule.h"
@@ -13,16 +14,27 @@
 
 #define LOCTEXT_NAMESPACE "FMCGraspEdModule"
 
+// Folder and class of the grasp animation data assets
+static const FName GraspAnimPackagePath = TEXT("/UPhysicsBasedMC/GraspAnimations");
+static const FName GraspAnimClassName = TEXT("MCGraspAnimDataAsset");
+
 // Default ctor
 FMCGraspEdUtils::FMCGraspEdUtils()
 {
 	bInitialStateCached = false;
 	bIsInit = false;
+	bDataAssetCacheDirty = true;
 
 	CurrEditFrameIndex = 0;
 	CurrEditGraspName = "";
 }
 
+// Dtor
+FMCGraspEdUtils::~FMCGraspEdUtils()
+{
+	UnbindAssetRegistryEvents();
+}
+
 // Init component
 void FMCGraspEdUtils::Init(UDebugSkelMeshComponent* InDebugMeshComponent)
 {
@@ -32,6 +44,7 @@ void FMCGraspEdUtils::Init(UDebugSkelMeshComponent* InDebugMeshComponent)
 
 		if (DebugMeshComponent)
 		{
+			BindAssetRegistryEvents();
 			bIsInit = true;
 		}
 	}
@@ -312,36 +325,28 @@ void FMCGraspEdUtils::UpdateFrame()
 	}
 
 	GraspDataAssetToEdit->Frames[CurrEditFrameIndex] = NewFrameData;
+	FMCGraspAnimCompressor::Compress(GraspDataAssetToEdit);
 
 	// Reloads the saved step.
 	// TODO Load frame could be switched with: 
 	// ApplyFrame(NewFrameData);
 	LoadFrame(CurrEditGraspName, CurrEditFrameIndex);
 
-	ShowMessageBox(FText::FromString("Load Frame"), FText::FromString("The grasp was successfully edited. (TODO test this)"));
+	ShowMessageBox(FText::FromString("Load Frame"), FText::FromString(FString::Printf(TEXT("The grasp was successfully edited. (TODO test this)\n\nCompression: %s"),
+		*FMCGraspAnimCompressor::GetStatsString(GraspDataAssetToEdit->CompressedData))));
 }
 
 // Loads the next frame
 void FMCGraspEdUtils::ShowNextFrame()
 {
-	TArray<FMCGraspAnimFrameData> Frames;
-	GetFramesFromAssetName(CurrEditGraspName, Frames);
-
-	int32 LastFrameIndex = Frames.Num() - 1;
-	DebugMeshComponent->SkeletalMesh->Modify();
-	int32 BoneNamesIndex = 0;
-	TArray<FName> BoneNames;
-	DebugMeshComponent->GetBoneNames(BoneNames);
-	TArray<FTransform> BoneSpaceTransforms = DebugMeshComponent->BoneSpaceTransforms;
-	TMap<FString, FVector> BoneStartLocations;
-	//Gets the current locations of all bones
-	for (FTransform BoneTransform : BoneSpaceTransforms)
+	const TArray<FMCGraspAnimFrameData>* Frames = GetFramesFromAssetName(CurrEditGraspName);
+	if (!Frames || Frames->Num() == 0)
 	{
-		BoneStartLocations.Add(BoneNames[BoneNamesIndex].ToString(), BoneTransform.GetTranslation());
-		BoneNamesIndex++;
+		return;
 	}
 
-	if (CurrEditFrameIndex == LastFrameIndex)
+	const int32 LastFrameIndex = Frames->Num() - 1;
+	if (CurrEditFrameIndex >= LastFrameIndex)
 	{
 		CurrEditFrameIndex = 0;
 	}
@@ -350,30 +355,20 @@ void FMCGraspEdUtils::ShowNextFrame()
 		CurrEditFrameIndex++;
 	}
 
-	ShowFrame(BoneStartLocations, Frames, CurrEditFrameIndex);
+	ShowFrame(*Frames, CurrEditFrameIndex);
 }
 
 // Loads the previous frame
 void FMCGraspEdUtils::ShowPreviousFrame()
 {
-	TArray<FMCGraspAnimFrameData> Frames;
-	GetFramesFromAssetName(CurrEditGraspName, Frames);
-
-	int32 LastFrameIndex = Frames.Num() - 1;
-	DebugMeshComponent->SkeletalMesh->Modify();
-	int32 BoneNamesIndex = 0;
-	TArray<FName> BoneNames;
-	DebugMeshComponent->GetBoneNames(BoneNames);
-	TArray<FTransform> BoneSpaceTransforms = DebugMeshComponent->BoneSpaceTransforms;
-	TMap<FString, FVector> BoneStartLocations;
-	//Gets the current locations of all bones
-	for (FTransform BoneTransform : BoneSpaceTransforms)
+	const TArray<FMCGraspAnimFrameData>* Frames = GetFramesFromAssetName(CurrEditGraspName);
+	if (!Frames || Frames->Num() == 0)
 	{
-		BoneStartLocations.Add(BoneNames[BoneNamesIndex].ToString(), BoneTransform.GetTranslation());
-		BoneNamesIndex++;
+		return;
 	}
 
-	if (CurrEditFrameIndex == 0)
+	const int32 LastFrameIndex = Frames->Num() - 1;
+	if (CurrEditFrameIndex <= 0 || CurrEditFrameIndex > LastFrameIndex)
 	{
 		CurrEditFrameIndex = LastFrameIndex;
 	}
@@ -382,9 +377,8 @@ void FMCGraspEdUtils::ShowPreviousFrame()
 		CurrEditFrameIndex--;
 	}
 
-
-	//Show next step.
-	ShowFrame(BoneStartLocations, Frames, CurrEditFrameIndex);
+	//Show previous step.
+	ShowFrame(*Frames, CurrEditFrameIndex);
 }
 
 // Creates a message box with instructions on how to create a new grasp
@@ -433,6 +427,7 @@ void FMCGraspEdUtils::WriteToAsset(const FString& InAssetName)
 	{
 		ExistingDataAsset->Name = InAssetName;
 		ExistingDataAsset->Frames = AnimFrames;
+		FMCGraspAnimCompressor::Compress(ExistingDataAsset);
 	}
 	else
 	{
@@ -444,10 +439,12 @@ void FMCGraspEdUtils::WriteToAsset(const FString& InAssetName)
 			AssetPackage->GetOutermost(), FName(*InAssetName), RF_Standalone | RF_Public);
 		NewDataAsset->Name = InAssetName;
 		NewDataAsset->Frames = AnimFrames;
+		FMCGraspAnimCompressor::Compress(NewDataAsset);
 
 		FAssetRegistryModule::AssetCreated(NewDataAsset);
 		NewDataAsset->MarkPackageDirty();
-		FString Msg = FString::Printf(TEXT("Data asset %s created in %s"), *InAssetName, *FolderPath);
+		FString Msg = FString::Printf(TEXT("Data asset %s created in %s\n\nCompression: %s"), *InAssetName, *FolderPath,
+			*FMCGraspAnimCompressor::GetStatsString(NewDataAsset->CompressedData));
 		ShowMessageBox(FText::FromString("Save"), FText::FromString(Msg));
 
 		//if (UPackage::SavePackage(AssetPackage, NewDataAsset, EObjectFlags::RF_Public | EObjectFlags::RF_Standalone, *InAssetName))
@@ -466,15 +463,16 @@ void FMCGraspEdUtils::WriteToAsset(const FString& InAssetName)
 // Apply animation frame using the asset name and frame index
 void FMCGraspEdUtils::LoadFrame(const FString& GraspAnimName, int32 FrameIndex)
 {
-	TArray<FMCGraspAnimFrameData> Frames;
-	if (GetFramesFromAssetName(GraspAnimName, Frames))
+	if (const TArray<FMCGraspAnimFrameData>* Frames = GetFramesFromAssetName(GraspAnimName))
 	{
-		if (Frames.IsValidIndex(FrameIndex))
+		if (Frames->IsValidIndex(FrameIndex))
 		{
+			CurrEditFrameIndex = FrameIndex;
+
 			DebugMeshComponent->SkeletalMesh->Modify();
 			DebugMeshComponent->PreviewInstance->ResetModifiedBone();
 
-			ApplyFrame(Frames[FrameIndex]);
+			ApplyFrame((*Frames)[FrameIndex]);
 
 			DebugMeshComponent->PreviewInstance->SetForceRetargetBasePose(true);
 		}
@@ -491,7 +489,7 @@ void FMCGraspEdUtils::LoadFrame(const FString& GraspAnimName, int32 FrameIndex)
 }
 
 // Shows the frame at the given index for the given HandAnimationData in the preview scene
-void FMCGraspEdUtils::ShowFrame(TMap<FString, FVector> BoneStartLocations, TArray<FMCGraspAnimFrameData> Frames, int32 Index)
+void FMCGraspEdUtils::ShowFrame(const TArray<FMCGraspAnimFrameData>& Frames, int32 Index)
 {
 	DebugMeshComponent->SkeletalMesh->Modify();
 
@@ -519,56 +517,119 @@ void FMCGraspEdUtils::ApplyFrame(const FMCGraspAnimFrameData& Frame)
 	}
 }
 
-// Read frames from the data asset file
-bool FMCGraspEdUtils::GetFramesFromAssetName(const FString& InName, TArray<FMCGraspAnimFrameData>& OutFrames)
+// Get the frames from the data asset (no copy), return nullptr if not found
+const TArray<FMCGraspAnimFrameData>* FMCGraspEdUtils::GetFramesFromAssetName(const FString& InName)
 {
-	for (UMCGraspAnimDataAsset* DataAsset : GetAllDataAssets())
+	if (UMCGraspAnimDataAsset* DataAsset = GetDataAsset(InName))
 	{
-		if (DataAsset->Name.Equals(InName))
-		{
-			OutFrames = DataAsset->Frames;
-			return true;
-		}
+		return &DataAsset->Frames;
 	}
-	return false;
+	return nullptr;
 }
 
 // Get data asset, returns nullptr if not found
 UMCGraspAnimDataAsset* FMCGraspEdUtils::GetDataAsset(const FString& Name)
 {
-	for (UMCGraspAnimDataAsset* DataAsset : GetAllDataAssets())
+	if (bDataAssetCacheDirty)
+	{
+		RebuildDataAssetCache();
+	}
+
+	if (TWeakObjectPtr<UMCGraspAnimDataAsset>* CachedAsset = DataAssetCache.Find(Name))
 	{
-		if (DataAsset->Name.Equals(Name))
+		if (CachedAsset->IsValid())
 		{
-			return DataAsset;
+			return CachedAsset->Get();
+		}
+
+		// The asset was unloaded/deleted without a registry event, rebuild once and retry
+		RebuildDataAssetCache();
+		if (TWeakObjectPtr<UMCGraspAnimDataAsset>* RebuiltAsset = DataAssetCache.Find(Name))
+		{
+			return RebuiltAsset->Get();
 		}
 	}
 	return nullptr;
 }
 
-// Finds all the GraspDataAssets in a hardcoded folder
-TArray<UMCGraspAnimDataAsset*> FMCGraspEdUtils::GetAllDataAssets()
+// Finds all the GraspDataAssets in a hardcoded folder and index them by their object name
+void FMCGraspEdUtils::RebuildDataAssetCache()
 {
+	DataAssetCache.Reset();
+
 	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(FName("AssetRegistry"));
 	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
 
 	FARFilter Filter;
-	Filter.ClassNames = { TEXT("MCGraspAnimDataAsset") };
-	Filter.PackagePaths.Add("/UPhysicsBasedMC/GraspAnimations");	
+	Filter.ClassNames = { GraspAnimClassName };
+	Filter.PackagePaths.Add(GraspAnimPackagePath);
 
 	TArray<FAssetData> AssetList;
 	AssetRegistry.GetAssets(Filter, AssetList);
 
-	TArray<UMCGraspAnimDataAsset*> GraspAssets;
 	for (const FAssetData& DataAsset : AssetList)
 	{
-		UObject* Obj = DataAsset.GetAsset();
-		if (Obj->GetClass()->IsChildOf(UMCGraspAnimDataAsset::StaticClass())) 
+		if (UMCGraspAnimDataAsset* GraspAsset = Cast<UMCGraspAnimDataAsset>(DataAsset.GetAsset()))
 		{
-			GraspAssets.Add(Cast<UMCGraspAnimDataAsset>(Obj));
+			DataAssetCache.Add(DataAsset.AssetName.ToString(), GraspAsset);
 		}
 	}
-	return GraspAssets;
+
+	bDataAssetCacheDirty = false;
+}
+
+// Bind the cache invalidation to the asset registry events
+void FMCGraspEdUtils::BindAssetRegistryEvents()
+{
+	if (AssetAddedHandle.IsValid())
+	{
+		return;
+	}
+
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(FName("AssetRegistry"));
+	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FMCGraspEdUtils::OnAssetAddedOrRemoved);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FMCGraspEdUtils::OnAssetAddedOrRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FMCGraspEdUtils::OnAssetRenamed);
+}
+
+// Unbind the cache invalidation from the asset registry events
+void FMCGraspEdUtils::UnbindAssetRegistryEvents()
+{
+	if (!AssetAddedHandle.IsValid())
+	{
+		return;
+	}
+
+	// The registry might already be unloaded on editor shutdown
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(FName("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+	AssetAddedHandle.Reset();
+	AssetRemovedHandle.Reset();
+	AssetRenamedHandle.Reset();
+}
+
+// Asset added/removed from the registry
+void FMCGraspEdUtils::OnAssetAddedOrRemoved(const FAssetData& InAssetData)
+{
+	if (InAssetData.AssetClass == GraspAnimClassName)
+	{
+		bDataAssetCacheDirty = true;
+	}
+}
+
+// Asset renamed or moved in the registry
+void FMCGraspEdUtils::OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath)
+{
+	if (InAssetData.AssetClass == GraspAnimClassName)
+	{
+		bDataAssetCacheDirty = true;
+	}
 }
 
 // Creates a message dialog box
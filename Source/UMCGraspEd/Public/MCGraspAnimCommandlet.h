@@ -0,0 +1,84 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MCGraspAnimIO.h"
+#include "MCGraspAnimCommandlet.generated.h"
+
+/**
+ * Headless batch conversion of the grasp animation data assets
+ *
+ * Usage:
+ *	UE4Editor-Cmd <Project> -run=MCGraspAnim -mode=<export|import|validate|compress> [options]
+ *
+ * Options:
+ *	-dir=<path>			folder of the interchange files (export/import)
+ *	-format=<json|bin>	interchange format (default json)
+ *	-path=<path>		package path of the data assets (default /UPhysicsBasedMC/GraspAnimations)
+ *	-mesh=<object path>	skeletal mesh to validate the bone names against (mandatory for validate)
+ *	-tolerance=<degrees>	angular error threshold of the compression (import/compress)
+ */
+UCLASS()
+class UMCGraspAnimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Default constructor
+	UMCGraspAnimCommandlet();
+
+	// Commandlet entry point
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Write the data assets to interchange files
+	bool Export();
+
+	// Create or update the data assets from the interchange files
+	bool Import();
+
+	// Validate the data assets bone names against the skeletal mesh
+	bool Validate();
+
+	// Compress the data assets and report the statistics
+	bool Compress();
+
+	// Load and copy the data of all the data assets from the package path
+	void LoadDataAssets(TArray<FMCGraspAnimFileData>& OutData, TArray<class UMCGraspAnimDataAsset*>* OutAssets = nullptr);
+
+	// Get the registry data of all the data assets from the package path
+	void GetDataAssetList(TArray<struct FAssetData>& OutAssetList) const;
+
+	// Check that the asset names are valid and unique, return false otherwise
+	bool ValidateAssetNames(const TArray<FString>& InAssetNames) const;
+
+	// Load the bone names of the validation skeletal mesh, return false if the mesh cannot be loaded
+	bool LoadBoneNames();
+
+	// Validate the bone names of the data in parallel, return false if any bone is missing
+	bool ValidateAll(const TArray<FMCGraspAnimFileData>& InData) const;
+
+	// Create or update the data asset and save its package
+	bool WriteDataAsset(const FMCGraspAnimFileData& InData, const FString& PackageName) const;
+
+private:
+	// Folder of the interchange files
+	FString Dir;
+
+	// Package path of the data assets
+	FString PackagePath;
+
+	// Skeletal mesh used for validation (optional for export/import)
+	FString MeshPath;
+
+	// Use the packed binary format instead of json
+	bool bBinary;
+
+	// Angular error threshold of the compression (degrees)
+	float Tolerance;
+
+	// Bone names of the validation mesh
+	TSet<FString> BoneNames;
+};
@@ -0,0 +1,41 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCGraspAnimDataAsset.h"
+
+/**
+ * Offline compression of the grasp animation drive targets:
+ *  - bones which stay static across all frames are stored with a single key
+ *  - keyframes are removed as long as the interpolated value stays under the angular error threshold
+ *  - the remaining keys are quantized to 16 bits per axis
+ */
+class FMCGraspAnimCompressor
+{
+public:
+	// Default angular error threshold (degrees)
+	static const float DefaultTolerance;
+
+	// Compress the frames, return false if there is nothing to compress
+	static bool Compress(const TArray<FMCGraspAnimFrameData>& InFrames, float InTolerance, FMCGraspAnimCompressedData& OutData);
+
+	// Compress the frames of the data asset and store the result in it
+	static bool Compress(UMCGraspAnimDataAsset* DataAsset, float InTolerance = DefaultTolerance);
+
+	// Get the compression statistics as a readable string
+	static FString GetStatsString(const FMCGraspAnimCompressedData& InData);
+
+private:
+	// Compress the values of a single bone
+	static void CompressTrack(const TArray<FRotator>& InValues, float InTolerance, FMCGraspAnimCompressedTrack& OutTrack);
+
+	// Add a quantized key to the track
+	static void AddKey(FMCGraspAnimCompressedTrack& OutTrack, int32 FrameIdx, const FRotator& InValue);
+
+	// Quantize the rotation the same way as the stored keys
+	static FRotator Quantize(const FRotator& InValue);
+
+	// Angle between the two rotations (degrees)
+	static float AngularError(const FRotator& A, const FRotator& B);
+};
@@ -0,0 +1,56 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCGraspAnimDataAsset.h"
+
+/**
+ * Engine independent copy of a grasp animation, used when converting to/from the interchange formats
+ */
+struct FMCGraspAnimFileData
+{
+	// Name of the animation (UMCGraspAnimDataAsset::Name)
+	FString Name;
+
+	// Object name of the data asset, also the base name of the interchange file
+	FString AssetName;
+
+	// Animation frames
+	TArray<FMCGraspAnimFrameData> Frames;
+
+	// File or package the data was read from (used for reporting)
+	FString Source;
+};
+
+/**
+ * Conversion of the grasp animations to/from json and a packed binary format,
+ * the functions do not touch any UObject, so they can be called from worker threads
+ */
+class FMCGraspAnimIO
+{
+public:
+	// File extensions of the interchange formats
+	static const TCHAR* JsonExtension;
+	static const TCHAR* BinaryExtension;
+
+	// Write the animation as a json string
+	static FString ToJsonString(const FMCGraspAnimFileData& InData);
+
+	// Read the animation from a json string, return false on parsing errors
+	static bool FromJsonString(const FString& InJsonString, FMCGraspAnimFileData& OutData);
+
+	// Write the animation in the packed binary format (bone name table + indexed rotations)
+	static void ToBinary(const FMCGraspAnimFileData& InData, TArray<uint8>& OutBytes);
+
+	// Read the animation from the packed binary format, return false if the data is corrupt
+	static bool FromBinary(const TArray<uint8>& InBytes, FMCGraspAnimFileData& OutData);
+
+	// Check that every bone from the animation exists in the given bone names, return false if any is missing
+	static bool ValidateBoneNames(const FMCGraspAnimFileData& InData, const TSet<FString>& InBoneNames, TArray<FString>& OutMissingBones);
+
+private:
+	// Binary header values
+	static const uint32 BinaryMagic;
+	static const int32 BinaryVersion;
+};
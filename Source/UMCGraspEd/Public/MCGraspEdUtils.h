@@ -7,6 +7,7 @@
 
 // Forward declarations
 class UDebugSkelMeshComponent;
+struct FAssetData;
 
 /**
  * Callbacks for creating the data assets. Binding happens in UMCGraspEd
@@ -17,6 +18,9 @@ public:
 	// Default ctor
 	FMCGraspEdUtils();
 
+	// Dtor, unbinds from the asset registry events
+	~FMCGraspEdUtils();
+
 	// Init the helper functions
 	void Init(UDebugSkelMeshComponent* DebugMeshComponent);
 
@@ -70,19 +74,27 @@ private:
 	void LoadFrame(const FString& GraspAnimName, int32 FrameIndex);
 
 	// Shows the frame at the given index for the given HandAnimationData in the preview scene
-	void ShowFrame(TMap<FString, FVector> BoneStartLocations, TArray<FMCGraspAnimFrameData> Frames, int32 Index);
+	void ShowFrame(const TArray<FMCGraspAnimFrameData>& Frames, int32 Index);
 
 	// Apply the given frame to the debug mesh
 	void ApplyFrame(const FMCGraspAnimFrameData& Frame);
 
-	// Read frames from the data asset file
-	bool GetFramesFromAssetName(const FString& Name, TArray<FMCGraspAnimFrameData>& OutFrames);
+	// Get the frames from the data asset (no copy), return nullptr if not found
+	const TArray<FMCGraspAnimFrameData>* GetFramesFromAssetName(const FString& Name);
 
 	// Find the grasp animation data asset, return nullptr if not found
 	UMCGraspAnimDataAsset* GetDataAsset(const FString& Name);
 
-	// Finds all the GraspDataAssets in a hardcoded folder
-	TArray<UMCGraspAnimDataAsset*> GetAllDataAssets();
+	// Finds all the GraspDataAssets in a hardcoded folder and index them by their object name
+	void RebuildDataAssetCache();
+
+	// Bind / unbind the cache invalidation to the asset registry events
+	void BindAssetRegistryEvents();
+	void UnbindAssetRegistryEvents();
+
+	// Asset registry callbacks, mark the cache as dirty if a grasp animation asset changed
+	void OnAssetAddedOrRemoved(const FAssetData& InAssetData);
+	void OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath);
 
 	// Creates a message dialog box
 	void ShowMessageBox(FText Title, FText Message);
@@ -121,4 +133,15 @@ private:
 	// TODO The currently loaded data asset for editing
 	UMCGraspAnimDataAsset* CurrEditDataAsset;
 
+	// Grasp animation data assets indexed by their object name (the editable animation name can change without a registry event)
+	TMap<FString, TWeakObjectPtr<UMCGraspAnimDataAsset>> DataAssetCache;
+
+	// True if the cache needs to be rebuilt before the next lookup
+	bool bDataAssetCacheDirty;
+
+	// Asset registry event handles
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+
 };
\ No newline at end of file
@@ -60,6 +60,7 @@ public class UMCGraspEd : ModuleRules
 			"HeadMountedDisplay",
 			"Core",
 			"AnimGraph",
+			"Json",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,89 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCInputFilter.h"
+
+// Filter the value, return true (and set the output) if the controller should be updated
+bool FMCInputFilter::Filter(float InValue, float InDeltaTime, float& OutValue)
+{
+	NumInputs++;
+
+	float Value = InValue;
+	if (bUseOneEuro)
+	{
+		// The smoothed value only converges towards the bounds, snap to them once close enough
+		Value = FMCInputFilter::OneEuro(InValue, InDeltaTime);
+		if ((InValue <= 0.f || InValue >= 1.f) && FMath::Abs(InValue - Value) <= Hysteresis)
+		{
+			Value = InValue;
+		}
+	}
+	if (Quantization > 0.f)
+	{
+		Value = FMath::GridSnap(Value, Quantization);
+	}
+
+	if (bHasOutput)
+	{
+		// Always report reaching the bounds, otherwise the hysteresis could stop short of fully open / closed
+		const bool bReachedBound = Value != LastOutput &&
+			(FMath::IsNearlyZero(Value) || FMath::IsNearlyEqual(Value, 1.f));
+		if (!bReachedBound && FMath::Abs(Value - LastOutput) <= Hysteresis)
+		{
+			NumSkipped++;
+			return false;
+		}
+	}
+
+	bHasOutput = true;
+	LastOutput = Value;
+	OutValue = Value;
+	return true;
+}
+
+// Clear the filter state and the statistics
+void FMCInputFilter::Reset()
+{
+	LastOutput = 0.f;
+	bHasOutput = false;
+	PrevSmoothed = 0.f;
+	PrevSpeed = 0.f;
+	bHasSmoothed = false;
+	NumInputs = 0;
+	NumSkipped = 0;
+}
+
+// Get the statistics as string
+FString FMCInputFilter::GetStatsString() const
+{
+	const float SkippedPercent = NumInputs > 0 ? 100.f * NumSkipped / NumInputs : 0.f;
+	return FString::Printf(TEXT("Inputs=%d; Updates=%d; Skipped=%d (%.1f%%);"),
+		NumInputs, NumInputs - NumSkipped, NumSkipped, SkippedPercent);
+}
+
+// Smooth the value with the One-Euro filter
+float FMCInputFilter::OneEuro(float InValue, float InDeltaTime)
+{
+	if (!bHasSmoothed || InDeltaTime <= 0.f)
+	{
+		bHasSmoothed = true;
+		PrevSmoothed = InValue;
+		PrevSpeed = 0.f;
+		return InValue;
+	}
+
+	// Smoothed speed, used to adapt the cutoff frequency
+	const float Speed = (InValue - PrevSmoothed) / InDeltaTime;
+	PrevSpeed = FMath::Lerp(PrevSpeed, Speed, LowPassAlpha(DerivativeCutoff, InDeltaTime));
+
+	const float Cutoff = MinCutoff + Beta * FMath::Abs(PrevSpeed);
+	PrevSmoothed = FMath::Lerp(PrevSmoothed, InValue, LowPassAlpha(Cutoff, InDeltaTime));
+	return PrevSmoothed;
+}
+
+// Smoothing factor of an exponential low-pass filter
+float FMCInputFilter::LowPassAlpha(float InCutoff, float InDeltaTime)
+{
+	const float Tau = 1.f / (2.f * PI * FMath::Max(InCutoff, KINDA_SMALL_NUMBER));
+	return 1.f / (1.f + Tau / InDeltaTime);
+}
@@ -29,10 +29,20 @@ void FMCPIDController::Init(bool bClearErrors /*= true*/)
 	{
 		PrevErr = 0.f;
 		IErr = 0.f;
+		Meas = 0.f;
+		PrevMeas = 0.f;
+		DFiltered = 0.f;
+		PrevOut = 0.f;
+		bHasPrev = false;
 	}
+	bHasMeas = false;
 
 	// Bind the update type function ptr
-	if (P > 0.f && I > 0.f && D > 0.f)
+	if (!Settings.IsDefault())
+	{
+		UpdateFunctionPtr = &FMCPIDController::UpdateWithSettings;
+	}
+	else if (P > 0.f && I > 0.f && D > 0.f)
 	{
 		UpdateFunctionPtr = &FMCPIDController::UpdateAsPID;
 	}
@@ -58,9 +68,128 @@ void FMCPIDController::Init(bool bClearErrors /*= true*/)
 // Call the update function pointer
 /*FORCEINLINE*/ float FMCPIDController::Update(const float InError, const float InDeltaTime)
 {
+	// Normal frames only pay for the checks, the update functions stay unguarded
+	if (UNLIKELY(!FMath::IsFinite(InError) || !Guard.IsValidDeltaTime(InDeltaTime)))
+	{
+		return UpdateGuarded(InError, InDeltaTime);
+	}
 	return (this->*UpdateFunctionPtr)(InError, InDeltaTime);
 }
 
+// Set the measurement and call the update function pointer
+float FMCPIDController::Update(const float InError, const float InMeasurement, const float InDeltaTime)
+{
+	// A non finite measurement keeps the previous one (the derivative falls back to the error)
+	if (UNLIKELY(!FMath::IsFinite(InMeasurement)))
+	{
+		GuardCounters.NonFiniteErrors++;
+		bHasMeas = false;
+	}
+	else
+	{
+		Meas = InMeasurement;
+		bHasMeas = true;
+	}
+	return FMCPIDController::Update(InError, InDeltaTime);
+}
+
+// Sanitize the error and the time step before calling the update function pointer
+float FMCPIDController::UpdateGuarded(const float InError, const float InDeltaTime)
+{
+	// Replace a non finite error with the previous (finite) one
+	float Error = InError;
+	if (!FMath::IsFinite(Error))
+	{
+		GuardCounters.NonFiniteErrors++;
+		Error = PrevErr;
+	}
+
+	// No (or too little) time passed, hold the integral and skip the derivative
+	if (!(InDeltaTime >= Guard.MinDeltaTime))
+	{
+		GuardCounters.SmallDeltaTimes++;
+		bHasMeas = false;
+		if (UpdateFunctionPtr == &FMCPIDController::UpdateWithSettings)
+		{
+			// Hold the output, a new one could exceed the slew limit
+			return PrevOut;
+		}
+		return FMath::Clamp(P * Error + I * IErr, -MaxOutAbs, MaxOutAbs);
+	}
+
+	if (!Guard.IsValidDeltaTime(InDeltaTime))
+	{
+		GuardCounters.ClampedDeltaTimes++;
+	}
+	return (this->*UpdateFunctionPtr)(Error, Guard.ClampDeltaTime(InDeltaTime));
+}
+
+// Update with the optional settings (anti-windup, derivative filter, slew limit)
+float FMCPIDController::UpdateWithSettings(const float InError, const float InDeltaTime)
+{
+	if (InDeltaTime <= 0.f)
+	{
+		return PrevOut;
+	}
+
+	// Calculate proportional output
+	const float POut = P * InError;
+
+	// Calculate the (filtered) derivative error / output, the measurement avoids kicks on target jumps
+	const bool bUseMeas = Settings.bDerivativeOnMeasurement && bHasMeas;
+	if (bHasPrev)
+	{
+		const float DErr = bUseMeas ? -(Meas - PrevMeas) / InDeltaTime : (InError - PrevErr) / InDeltaTime;
+		DFiltered += Settings.GetDerivativeAlpha(InDeltaTime) * (DErr - DFiltered);
+	}
+	const float DOut = D * DFiltered;
+
+	// Calculate integral error / output
+	if (I > 0.f)
+	{
+		if (Settings.AntiWindup == EMCPIDAntiWindup::Clamping)
+		{
+			// Integrate only if the output is not saturated in the direction of the error
+			const float UnsatOut = POut + I * (IErr + InDeltaTime * InError) + DOut;
+			if (FMath::Abs(UnsatOut) < MaxOutAbs || UnsatOut * InError < 0.f)
+			{
+				IErr += InDeltaTime * InError;
+			}
+		}
+		else if (Settings.AntiWindup == EMCPIDAntiWindup::BackCalculation)
+		{
+			// Feed the saturation excess back into the integral
+			IErr += InDeltaTime * InError;
+			const float UnsatOut = POut + I * IErr + DOut;
+			const float SatOut = FMath::Clamp(UnsatOut, -MaxOutAbs, MaxOutAbs);
+			IErr += InDeltaTime * Settings.BackCalculationGain * (SatOut - UnsatOut) / I;
+		}
+		else
+		{
+			IErr += InDeltaTime * InError;
+		}
+	}
+	const float IOut = I * IErr;
+
+	// Calculate and clamp the output
+	float Out = FMath::Clamp(POut + IOut + DOut, -MaxOutAbs, MaxOutAbs);
+
+	// Limit the output change
+	if (Settings.MaxOutRate > 0.f)
+	{
+		const float MaxStep = Settings.MaxOutRate * InDeltaTime;
+		Out = PrevOut + FMath::Clamp(Out - PrevOut, -MaxStep, MaxStep);
+	}
+
+	// Set previous values
+	PrevErr = InError;
+	PrevMeas = Meas;
+	PrevOut = Out;
+	bHasMeas = false;
+	bHasPrev = true;
+	return Out;
+}
+
 
 /*FORCEINLINE*/ float FMCPIDController::UpdateAsPID(const float InError, const float InDeltaTime)
 {
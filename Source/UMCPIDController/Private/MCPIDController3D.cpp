@@ -29,10 +29,21 @@ void FMCPIDController3D::Init(bool bClearErrors /*= true*/)
 	{
 		PrevErr = FVector(0.f);
 		IErr = FVector(0.f);
+		LastErr = FVector(0.f);
+		Meas = FVector(0.f);
+		PrevMeas = FVector(0.f);
+		DFiltered = FVector(0.f);
+		PrevOut = FVector(0.f);
+		bHasPrev = false;
 	}
+	bHasMeas = false;
 
 	// Bind the update type function ptr
-	if (P > 0.f && I > 0.f && D > 0.f)
+	if (!Settings.IsDefault())
+	{
+		UpdateFunctionPtr = &FMCPIDController3D::UpdateWithSettings;
+	}
+	else if (P > 0.f && I > 0.f && D > 0.f)
 	{
 		UpdateFunctionPtr = &FMCPIDController3D::UpdateAsPID;
 	}
@@ -55,13 +66,155 @@ void FMCPIDController3D::Init(bool bClearErrors /*= true*/)
 	}
 }
 
+// Reset error values, bind the relay update (until the next Init)
+void FMCPIDController3D::InitAsRelay(float InAmplitude, float InBand)
+{
+	P = 0.f;
+	I = 0.f;
+	D = 0.f;
+	MaxOutAbs = InAmplitude;
+	RelayBand = InBand;
+	FMCPIDController3D::Init(true);
+	UpdateFunctionPtr = &FMCPIDController3D::UpdateAsRelay;
+}
+
 
 // Call the update function pointer
 /*FORCEINLINE*/ FVector FMCPIDController3D::Update(const FVector InError, const float InDeltaTime)
 {
+	// Normal frames only pay for the checks, the update functions stay unguarded
+	if (UNLIKELY(InError.ContainsNaN() || !Guard.IsValidDeltaTime(InDeltaTime)))
+	{
+		return UpdateGuarded(InError, InDeltaTime);
+	}
+	LastErr = InError;
 	return (this->*UpdateFunctionPtr)(InError, InDeltaTime);
 }
 
+// Set the measurement and call the update function pointer
+FVector FMCPIDController3D::Update(const FVector InError, const FVector InMeasurement, const float InDeltaTime)
+{
+	// A non finite measurement keeps the previous one (the derivative falls back to the error)
+	if (UNLIKELY(InMeasurement.ContainsNaN()))
+	{
+		GuardCounters.NonFiniteErrors++;
+		bHasMeas = false;
+	}
+	else
+	{
+		Meas = InMeasurement;
+		bHasMeas = true;
+	}
+	return FMCPIDController3D::Update(InError, InDeltaTime);
+}
+
+// Sanitize the error and the time step before calling the update function pointer
+FVector FMCPIDController3D::UpdateGuarded(const FVector InError, const float InDeltaTime)
+{
+	// Replace the non finite components with the previous (finite) error
+	FVector Error = InError;
+	if (Error.ContainsNaN())
+	{
+		GuardCounters.NonFiniteErrors++;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (!FMath::IsFinite(Error[Axis]))
+			{
+				Error[Axis] = PrevErr[Axis];
+			}
+		}
+	}
+	LastErr = Error;
+
+	// No (or too little) time passed, hold the integral and skip the derivative
+	if (!(InDeltaTime >= Guard.MinDeltaTime))
+	{
+		GuardCounters.SmallDeltaTimes++;
+		bHasMeas = false;
+		if (UpdateFunctionPtr == &FMCPIDController3D::UpdateWithSettings
+			|| UpdateFunctionPtr == &FMCPIDController3D::UpdateAsRelay)
+		{
+			// Hold the output, a new one could exceed the slew limit (or switch the relay early)
+			return PrevOut;
+		}
+		return (P * Error + I * IErr).BoundToCube(MaxOutAbs);
+	}
+
+	if (!Guard.IsValidDeltaTime(InDeltaTime))
+	{
+		GuardCounters.ClampedDeltaTimes++;
+	}
+	return (this->*UpdateFunctionPtr)(Error, Guard.ClampDeltaTime(InDeltaTime));
+}
+
+// Update with the optional settings (anti-windup, derivative filter, slew limit)
+FVector FMCPIDController3D::UpdateWithSettings(const FVector InError, const float InDeltaTime)
+{
+	if (InDeltaTime <= 0.f)
+	{
+		return PrevOut;
+	}
+
+	// Calculate proportional output
+	const FVector POut = P * InError;
+
+	// Calculate the (filtered) derivative error / output, the measurement avoids kicks on target jumps
+	const bool bUseMeas = Settings.bDerivativeOnMeasurement && bHasMeas;
+	if (bHasPrev)
+	{
+		const FVector DErr = bUseMeas ? -(Meas - PrevMeas) / InDeltaTime : (InError - PrevErr) / InDeltaTime;
+		DFiltered += Settings.GetDerivativeAlpha(InDeltaTime) * (DErr - DFiltered);
+	}
+	const FVector DOut = D * DFiltered;
+
+	// Calculate integral error / output
+	if (I > 0.f)
+	{
+		if (Settings.AntiWindup == EMCPIDAntiWindup::Clamping)
+		{
+			// Integrate only the components whose output is not saturated in the direction of the error
+			const FVector UnsatOut = POut + I * (IErr + InDeltaTime * InError) + DOut;
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				if (FMath::Abs(UnsatOut[Axis]) < MaxOutAbs || UnsatOut[Axis] * InError[Axis] < 0.f)
+				{
+					IErr[Axis] += InDeltaTime * InError[Axis];
+				}
+			}
+		}
+		else if (Settings.AntiWindup == EMCPIDAntiWindup::BackCalculation)
+		{
+			// Feed the saturation excess back into the integral
+			IErr += InDeltaTime * InError;
+			const FVector UnsatOut = POut + I * IErr + DOut;
+			const FVector SatOut = UnsatOut.BoundToCube(MaxOutAbs);
+			IErr += (InDeltaTime * Settings.BackCalculationGain / I) * (SatOut - UnsatOut);
+		}
+		else
+		{
+			IErr += InDeltaTime * InError;
+		}
+	}
+	const FVector IOut = I * IErr;
+
+	// Calculate and clamp the output
+	FVector Out = (POut + IOut + DOut).BoundToCube(MaxOutAbs);
+
+	// Limit the output change
+	if (Settings.MaxOutRate > 0.f)
+	{
+		Out = PrevOut + (Out - PrevOut).BoundToCube(Settings.MaxOutRate * InDeltaTime);
+	}
+
+	// Set previous values
+	PrevErr = InError;
+	PrevMeas = Meas;
+	PrevOut = Out;
+	bHasMeas = false;
+	bHasPrev = true;
+	return Out;
+}
+
 /*FORCEINLINE*/ FVector FMCPIDController3D::UpdateAsPID(const FVector InError, const float InDeltaTime)
 {
 	//if (InDeltaTime == 0.0f || InError.ContainsNaN())
@@ -147,4 +300,34 @@ void FMCPIDController3D::Init(bool bClearErrors /*= true*/)
 
 	// Clamp output
 	return Out.BoundToCube(MaxOutAbs);
-}
\ No newline at end of file
+}
+
+// Update as a relay with hysteresis (+/-MaxOutAbs, switched when the error leaves the band)
+FVector FMCPIDController3D::UpdateAsRelay(const FVector InError, const float /*InDeltaTime*/)
+{
+	FVector Out;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (InError[Axis] > RelayBand)
+		{
+			Out[Axis] = MaxOutAbs;
+		}
+		else if (InError[Axis] < -RelayBand)
+		{
+			Out[Axis] = -MaxOutAbs;
+		}
+		else if (PrevOut[Axis] != 0.f)
+		{
+			// Inside the band, keep the side
+			Out[Axis] = PrevOut[Axis];
+		}
+		else
+		{
+			// First step inside the band (settled), kick in the direction of the error to start the limit cycle
+			Out[Axis] = InError[Axis] < 0.f ? -MaxOutAbs : MaxOutAbs;
+		}
+	}
+	PrevErr = InError;
+	PrevOut = Out;
+	return Out;
+}
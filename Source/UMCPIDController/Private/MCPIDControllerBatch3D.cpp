@@ -0,0 +1,119 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCPIDControllerBatch3D.h"
+
+// Set PID values and the number of controllers, reset error values
+void FMCPIDControllerBatch3D::Init(float InP, float InI, float InD, float InMaxOutAbs, int32 InNum /*= 0*/)
+{
+	SetGains(InP, InI, InD, InMaxOutAbs);
+	PrevErr.Init(FVector(0.f), InNum);
+	IErr.Init(FVector(0.f), InNum);
+}
+
+// Set PID values, keep the error values
+void FMCPIDControllerBatch3D::SetGains(float InP, float InI, float InD, float InMaxOutAbs)
+{
+	P = InP;
+	I = InI;
+	D = InD;
+	MaxOutAbs = InMaxOutAbs;
+}
+
+// Add a controller with cleared errors, return its index
+int32 FMCPIDControllerBatch3D::Add()
+{
+	IErr.Add(FVector(0.f));
+	return PrevErr.Add(FVector(0.f));
+}
+
+// Remove the controller by moving the last one in its place
+void FMCPIDControllerBatch3D::RemoveAtSwap(int32 Index)
+{
+	PrevErr.RemoveAtSwap(Index, 1, false);
+	IErr.RemoveAtSwap(Index, 1, false);
+}
+
+// Remove all the controllers
+void FMCPIDControllerBatch3D::Empty()
+{
+	PrevErr.Reset();
+	IErr.Reset();
+}
+
+// Update every controller, the errors and the outputs are indexed the same as the controllers
+void FMCPIDControllerBatch3D::Update(const TArray<FVector>& InErrors, const float InDeltaTime, TArray<FVector>& OutValues)
+{
+	const int32 NumControllers = PrevErr.Num();
+	check(InErrors.Num() == NumControllers);
+	OutValues.SetNumUninitialized(NumControllers, false);
+
+	// The time step is guarded once for the whole batch: no time passed holds the integral and skips the derivative
+	float DeltaTime = InDeltaTime;
+	if (UNLIKELY(!Guard.IsValidDeltaTime(InDeltaTime)))
+	{
+		if (!(InDeltaTime >= Guard.MinDeltaTime))
+		{
+			GuardCounters.SmallDeltaTimes++;
+			DeltaTime = 0.f;
+		}
+		else
+		{
+			GuardCounters.ClampedDeltaTimes++;
+			DeltaTime = Guard.ClampDeltaTime(InDeltaTime);
+		}
+	}
+
+	// Gains and time step are loaded once for the whole batch,
+	// unused terms have a zero gain so the loop does not branch
+	const float InvDeltaTime = DeltaTime > 0.f ? 1.f / DeltaTime : 0.f;
+	const FVector* RESTRICT Errors = InErrors.GetData();
+	FVector* RESTRICT Prev = PrevErr.GetData();
+	FVector* RESTRICT Integral = IErr.GetData();
+	FVector* RESTRICT Out = OutValues.GetData();
+
+	// Branch free finiteness check of all the errors on the exponent bits
+	uint32 NonFinite = 0;
+	for (int32 Idx = 0; Idx < NumControllers; ++Idx)
+	{
+		NonFinite |= FMCPIDGuard::NonFiniteBit(Errors[Idx].X)
+			| FMCPIDGuard::NonFiniteBit(Errors[Idx].Y)
+			| FMCPIDGuard::NonFiniteBit(Errors[Idx].Z);
+	}
+	if (UNLIKELY(NonFinite != 0))
+	{
+		GuardCounters.NonFiniteErrors++;
+		UpdateGuarded(Errors, DeltaTime, InvDeltaTime, Out);
+		return;
+	}
+
+	for (int32 Idx = 0; Idx < NumControllers; ++Idx)
+	{
+		Integral[Idx] += DeltaTime * Errors[Idx];
+		const FVector DErr = (Errors[Idx] - Prev[Idx]) * InvDeltaTime;
+		Prev[Idx] = Errors[Idx];
+
+		// Calculate and clamp the output
+		Out[Idx] = (P * Errors[Idx] + I * Integral[Idx] + D * DErr).BoundToCube(MaxOutAbs);
+	}
+}
+
+// Update with the non finite error components replaced by the previous ones
+void FMCPIDControllerBatch3D::UpdateGuarded(const FVector* InErrors, const float InDeltaTime, const float InInvDeltaTime, FVector* OutValues)
+{
+	for (int32 Idx = 0; Idx < PrevErr.Num(); ++Idx)
+	{
+		FVector Error = InErrors[Idx];
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (FMCPIDGuard::NonFiniteBit(Error[Axis]))
+			{
+				Error[Axis] = PrevErr[Idx][Axis];
+			}
+		}
+		IErr[Idx] += InDeltaTime * Error;
+		const FVector DErr = (Error - PrevErr[Idx]) * InInvDeltaTime;
+		PrevErr[Idx] = Error;
+		OutValues[Idx] = (P * Error + I * IErr[Idx] + D * DErr).BoundToCube(MaxOutAbs);
+	}
+}
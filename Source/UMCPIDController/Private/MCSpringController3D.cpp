@@ -0,0 +1,91 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCSpringController3D.h"
+
+// Init ctor
+FMCSpringController3D::FMCSpringController3D(float InHalfLife, float InDampingRatio, float InMaxOutAbs)
+{
+	FMCSpringController3D::Init(InHalfLife, InDampingRatio, InMaxOutAbs);
+}
+
+// Set the spring parameters, reset the spring velocity
+void FMCSpringController3D::Init(float InHalfLife, float InDampingRatio /*= 1.f*/, float InMaxOutAbs /*= 0.f*/)
+{
+	HalfLife = InHalfLife;
+	DampingRatio = InDampingRatio;
+	MaxOutAbs = InMaxOutAbs;
+	FMCSpringController3D::Init();
+}
+
+// Reset the spring velocity and the cached coefficients
+void FMCSpringController3D::Init(const FVector& InVelocity /*= FVector::ZeroVector*/)
+{
+	Velocity = InVelocity;
+	CachedDeltaTime = -1.f;
+}
+
+// Get the average velocity of the spring over the step
+FVector FMCSpringController3D::Update(const FVector InError, const float InDeltaTime)
+{
+	if (InDeltaTime <= 0.f)
+	{
+		return Velocity;
+	}
+
+	// The coefficients only depend on the time step, which rarely changes
+	if (InDeltaTime != CachedDeltaTime)
+	{
+		UpdateCoefficients(InDeltaTime);
+	}
+
+	// Displacement of the step over the time step, and the spring velocity at the end of the step
+	const FVector Out = ErrorCoeff * InError + VelocityCoeff * Velocity;
+	Velocity = NextErrorCoeff * InError + NextVelocityCoeff * Velocity;
+	return MaxOutAbs > 0.f ? Out.BoundToCube(MaxOutAbs) : Out;
+}
+
+// Compute the step coefficients for the time step
+void FMCSpringController3D::UpdateCoefficients(const float InDeltaTime)
+{
+	CachedDeltaTime = InDeltaTime;
+
+	// Decay rate of the envelope
+	const float Y = 0.69314718f / FMath::Max(HalfLife, KINDA_SMALL_NUMBER);
+	const float Decay = FMath::Exp(-Y * InDeltaTime);
+
+	// With the offset to the target (-Error) the next state is:
+	//	Offset' = A * Offset + B * Velocity
+	//	Velocity' = C * Offset + D * Velocity
+	float A;
+	float B;
+	float C;
+	float D;
+	if (DampingRatio >= 1.f)
+	{
+		// Critically damped
+		A = Decay * (1.f + Y * InDeltaTime);
+		B = Decay * InDeltaTime;
+		C = -Decay * Y * Y * InDeltaTime;
+		D = Decay * (1.f - Y * InDeltaTime);
+	}
+	else
+	{
+		// Under damped, oscillation frequency from the decay rate and the damping ratio
+		const float Zeta = FMath::Max(DampingRatio, 0.05f);
+		const float W = Y * FMath::Sqrt(1.f - Zeta * Zeta) / Zeta;
+		float Sin;
+		float Cos;
+		FMath::SinCos(&Sin, &Cos, W * InDeltaTime);
+		A = Decay * (Cos + Y * Sin / W);
+		B = Decay * Sin / W;
+		C = -Decay * (W + Y * Y / W) * Sin;
+		D = Decay * (Cos - Y * Sin / W);
+	}
+
+	// The output is the average velocity of the step: ((1 - A) * Error + B * Velocity) / dt
+	ErrorCoeff = (1.f - A) / InDeltaTime;
+	VelocityCoeff = B / InDeltaTime;
+	NextErrorCoeff = -C;
+	NextVelocityCoeff = D;
+}
@@ -0,0 +1,91 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "EngineMinimal.h"
+#include "MCInputFilter.generated.h"
+
+/**
+* Normalized input (0 - 1) filter, reports a new value only if it changed enough to be worth an update
+*	One-Euro - optional adaptive low-pass smoothing (little lag on fast movements, little jitter on slow ones)
+*	Quantization - snap the value to a grid
+*	Hysteresis - minimal change from the last reported value (the bounds 0 and 1 are always reported)
+*/
+USTRUCT(/*BlueprintType*/)
+struct UMCPIDCONTROLLER_API FMCInputFilter
+{
+	GENERATED_BODY()
+
+public:
+	// Grid size of the value, 0 = no quantization
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float Quantization = 0.f;
+
+	// Minimal change from the last reported value
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float Hysteresis = 0.025f;
+
+	// Smooth the input with a One-Euro filter
+	UPROPERTY(EditAnywhere)
+	bool bUseOneEuro = false;
+
+	// One-Euro minimal cutoff frequency (Hz), lower values remove more jitter
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0", editcondition = "bUseOneEuro"))
+	float MinCutoff = 1.f;
+
+	// One-Euro speed coefficient, higher values reduce the lag on fast movements
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0", editcondition = "bUseOneEuro"))
+	float Beta = 0.f;
+
+	// One-Euro cutoff frequency (Hz) of the speed estimate
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0", editcondition = "bUseOneEuro"))
+	float DerivativeCutoff = 1.f;
+
+	// Default constructor
+	FMCInputFilter() { }
+
+	// Filter the value, return true (and set the output) if the controller should be updated
+	bool Filter(float InValue, float InDeltaTime, float& OutValue);
+
+	// Clear the filter state and the statistics
+	void Reset();
+
+	// Number of filtered values
+	int32 GetNumInputs() const { return NumInputs; };
+
+	// Number of values that did not trigger an update
+	int32 GetNumSkipped() const { return NumSkipped; };
+
+	// Get the statistics as string
+	FString GetStatsString() const;
+
+private:
+	// Smooth the value with the One-Euro filter
+	float OneEuro(float InValue, float InDeltaTime);
+
+	// Smoothing factor of an exponential low-pass filter
+	static float LowPassAlpha(float InCutoff, float InDeltaTime);
+
+private:
+	// Last reported value
+	float LastOutput = 0.f;
+
+	// True if a value was reported since the last reset
+	bool bHasOutput = false;
+
+	// Previous smoothed value
+	float PrevSmoothed = 0.f;
+
+	// Previous smoothed speed
+	float PrevSpeed = 0.f;
+
+	// True if the One-Euro filter has a previous value
+	bool bHasSmoothed = false;
+
+	// Number of filtered values
+	int32 NumInputs = 0;
+
+	// Number of values that did not trigger an update
+	int32 NumSkipped = 0;
+};
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "EngineMinimal.h"
+#include "MCPIDSettings.h"
 #include "MCPIDController.generated.h"
 
 /**
@@ -34,6 +35,14 @@ public:
 	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
 	float MaxOutAbs = 0.f;;
 
+	// Anti-windup, derivative filtering and output slew limiting
+	UPROPERTY(EditAnywhere)
+	FMCPIDSettings Settings;
+
+	// Time step range and non finite error handling
+	UPROPERTY(EditAnywhere)
+	FMCPIDGuard Guard;
+
 	// Default constructor (no initialization)
 	FMCPIDController() { }
 
@@ -55,6 +64,12 @@ public:
 	// Update the PID loop
 	float Update(const float InError, const float InDeltaTime);
 
+	// Update the PID loop, the measurement is used by the derivative on measurement setting
+	float Update(const float InError, const float InMeasurement, const float InDeltaTime);
+
+	// Update with the optional settings (anti-windup, derivative filter, slew limit)
+	float UpdateWithSettings(const float InError, const float InDeltaTime);
+
 	// Update as a PID controller
 	float UpdateAsPID(const float InError, const float InDeltaTime);
 
@@ -66,12 +81,41 @@ public:
 
 	// Update as a PI controller
 	float UpdateAsPI(const float InError, const float InDeltaTime);
+
+	// Number of times the update guards fired
+	const FMCPIDGuardCounters& GetGuardCounters() const { return GuardCounters; };
+
+	// Reset the guard counters
+	void ResetGuardCounters() { GuardCounters = FMCPIDGuardCounters(); };
+
+private:
+	// Sanitize the error and the time step before calling the update function pointer
+	float UpdateGuarded(const float InError, const float InDeltaTime);
 	
 private:
+	// Number of times the update guards fired
+	FMCPIDGuardCounters GuardCounters;
+
 	// Previous step error value
 	float PrevErr;
 
 	// Integral error
 	float IErr;
+
+	// Measurement of the current and previous step (derivative on measurement)
+	float Meas;
+	float PrevMeas;
+
+	// Low-pass filtered derivative
+	float DFiltered;
+
+	// Previous step output (slew limiting)
+	float PrevOut;
+
+	// True if the current measurement was set in this step
+	bool bHasMeas;
+
+	// True once a step was done since the errors were cleared
+	bool bHasPrev;
 };
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "EngineMinimal.h"
+#include "MCPIDSettings.h"
 #include "MCPIDController3D.generated.h"
 
 /**
@@ -34,6 +35,14 @@ public:
 	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
 	float MaxOutAbs = 0.f;
 
+	// Anti-windup, derivative filtering and output slew limiting
+	UPROPERTY(EditAnywhere)
+	FMCPIDSettings Settings;
+
+	// Time step range and non finite error handling
+	UPROPERTY(EditAnywhere)
+	FMCPIDGuard Guard;
+
 	// Default constructor (no initialization)
 	FMCPIDController3D() { }
 
@@ -52,9 +61,18 @@ public:
 	// Reset error values, bind update function ptr
 	void Init(bool bClearErrors = true);
 
+	// Reset error values, bind the relay update (until the next Init)
+	void InitAsRelay(float InAmplitude, float InBand);
+
 	// Update the PID loop
 	/*FORCEINLINE*/ FVector Update(const FVector InError, const float InDeltaTime);
 
+	// Update the PID loop, the measurement is used by the derivative on measurement setting
+	FVector Update(const FVector InError, const FVector InMeasurement, const float InDeltaTime);
+
+	// Update with the optional settings (anti-windup, derivative filter, slew limit)
+	FVector UpdateWithSettings(const FVector InError, const float InDeltaTime);
+
 	// Update as a PID controller
 	/*FORCEINLINE*/ FVector UpdateAsPID(const FVector InError, const float InDeltaTime);
 
@@ -67,11 +85,52 @@ public:
 	// Update as a PI controller
 	/*FORCEINLINE*/ FVector UpdateAsPI(const FVector InError, const float InDeltaTime);
 
+	// Update as a relay with hysteresis (+/-MaxOutAbs, switched when the error leaves the band)
+	FVector UpdateAsRelay(const FVector InError, const float InDeltaTime = 0.f);
+
+	// Get the error of the last update
+	FVector GetLastError() const { return LastErr; };
+
+	// Number of times the update guards fired
+	const FMCPIDGuardCounters& GetGuardCounters() const { return GuardCounters; };
+
+	// Reset the guard counters
+	void ResetGuardCounters() { GuardCounters = FMCPIDGuardCounters(); };
+
 private:
+	// Sanitize the error and the time step before calling the update function pointer
+	FVector UpdateGuarded(const FVector InError, const float InDeltaTime);
+
+private:
+	// Number of times the update guards fired
+	FMCPIDGuardCounters GuardCounters;
+
+	// Error of the last update (independent of the update type)
+	FVector LastErr;
+
 	// Previous step error value
 	FVector PrevErr;
 
 	// Integral error
 	FVector IErr;
+
+	// Measurement of the current and previous step (derivative on measurement)
+	FVector Meas;
+	FVector PrevMeas;
+
+	// Low-pass filtered derivative
+	FVector DFiltered;
+
+	// Previous step output (slew limiting, relay side)
+	FVector PrevOut;
+
+	// Error band of the relay switching
+	float RelayBand = 0.f;
+
+	// True if the current measurement was set in this step
+	bool bHasMeas;
+
+	// True once a step was done since the errors were cleared
+	bool bHasPrev;
 };
 
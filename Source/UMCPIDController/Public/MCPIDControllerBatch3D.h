@@ -0,0 +1,80 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "EngineMinimal.h"
+#include "MCPIDSettings.h"
+#include "MCPIDControllerBatch3D.generated.h"
+
+/**
+* Batch of FVector PID controllers sharing the same gains,
+* the errors are stored as structure of arrays and updated in a single loop
+*/
+USTRUCT(/*BlueprintType*/)
+struct UMCPIDCONTROLLER_API FMCPIDControllerBatch3D
+{
+	GENERATED_BODY()
+
+public:
+	// Proportional gain
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float P = 0.f;
+
+	// Integral gain
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float I = 0.f;
+
+	// Derivative gain
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float D = 0.f;
+
+	// Max output (as absolute value)
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float MaxOutAbs = 0.f;
+
+	// Time step range and non finite error handling
+	UPROPERTY(EditAnywhere)
+	FMCPIDGuard Guard;
+
+	// Set PID values and the number of controllers, reset error values
+	void Init(float InP, float InI, float InD, float InMaxOutAbs, int32 InNum = 0);
+
+	// Set PID values, keep the error values
+	void SetGains(float InP, float InI, float InD, float InMaxOutAbs);
+
+	// Add a controller with cleared errors, return its index
+	int32 Add();
+
+	// Remove the controller by moving the last one in its place
+	void RemoveAtSwap(int32 Index);
+
+	// Remove all the controllers
+	void Empty();
+
+	// Number of controllers
+	int32 Num() const { return PrevErr.Num(); }
+
+	// Update every controller, the errors and the outputs are indexed the same as the controllers
+	void Update(const TArray<FVector>& InErrors, const float InDeltaTime, TArray<FVector>& OutValues);
+
+	// Number of times the update guards fired
+	const FMCPIDGuardCounters& GetGuardCounters() const { return GuardCounters; };
+
+	// Reset the guard counters
+	void ResetGuardCounters() { GuardCounters = FMCPIDGuardCounters(); };
+
+private:
+	// Update with the non finite error components replaced by the previous ones
+	void UpdateGuarded(const FVector* InErrors, const float InDeltaTime, const float InInvDeltaTime, FVector* OutValues);
+
+private:
+	// Number of times the update guards fired
+	FMCPIDGuardCounters GuardCounters;
+
+	// Previous step error values
+	TArray<FVector> PrevErr;
+
+	// Integral error values
+	TArray<FVector> IErr;
+};
@@ -0,0 +1,130 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "EngineMinimal.h"
+#include "MCPIDSettings.generated.h"
+
+/**
+* Integral anti-windup strategy
+*/
+UENUM()
+enum class EMCPIDAntiWindup : uint8
+{
+	None					UMETA(DisplayName = "None"),
+	Clamping				UMETA(DisplayName = "Clamping (conditional integration)"),
+	BackCalculation			UMETA(DisplayName = "Back-calculation"),
+};
+
+/**
+* Optional PID behaviour, with the default values the controllers use the plain update functions
+*/
+USTRUCT()
+struct UMCPIDCONTROLLER_API FMCPIDSettings
+{
+	GENERATED_BODY()
+
+public:
+	// Limit the integral error while the output is saturated
+	UPROPERTY(EditAnywhere)
+	EMCPIDAntiWindup AntiWindup = EMCPIDAntiWindup::None;
+
+	// Back-calculation tracking gain (1/s), how fast the integral unwinds when the output is saturated
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float BackCalculationGain = 1.f;
+
+	// Differentiate the measurement instead of the error (no derivative kicks on target jumps),
+	// only when the measurement is passed to the update, otherwise the error is used
+	UPROPERTY(EditAnywhere)
+	bool bDerivativeOnMeasurement = false;
+
+	// Time constant of the first order low-pass filter on the derivative (s), 0 = unfiltered
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float DerivativeFilterTime = 0.f;
+
+	// Max change of the output per second, 0 = unlimited
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float MaxOutRate = 0.f;
+
+	// True if no optional behaviour is enabled
+	bool IsDefault() const
+	{
+		return AntiWindup == EMCPIDAntiWindup::None && !bDerivativeOnMeasurement
+			&& DerivativeFilterTime <= 0.f && MaxOutRate <= 0.f;
+	}
+
+	// Smoothing factor of the derivative filter for the given step
+	float GetDerivativeAlpha(float InDeltaTime) const
+	{
+		return DerivativeFilterTime > 0.f ? InDeltaTime / (DerivativeFilterTime + InDeltaTime) : 1.f;
+	}
+};
+
+/**
+* Time step range of the PID updates, outside of it (or with non finite errors) the guarded update is used:
+* below the min (e.g. paused or zero length frames) only the proportional and the held integral output is applied,
+* above the max (hitches) the time step is clamped, non finite error components are replaced by the previous ones
+*/
+USTRUCT()
+struct UMCPIDCONTROLLER_API FMCPIDGuard
+{
+	GENERATED_BODY()
+
+public:
+	// Smallest time step (s) the integral and derivative are updated with
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float MinDeltaTime = 0.0001f;
+
+	// Largest time step (s), larger ones are clamped, 0 = unlimited
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float MaxDeltaTime = 0.1f;
+
+	// True if the time step can be used as is (false for NaN)
+	FORCEINLINE bool IsValidDeltaTime(float InDeltaTime) const
+	{
+		return InDeltaTime >= MinDeltaTime && (MaxDeltaTime <= 0.f || InDeltaTime <= MaxDeltaTime);
+	}
+
+	// Clamp the (valid or too large) time step to the range
+	FORCEINLINE float ClampDeltaTime(float InDeltaTime) const
+	{
+		return MaxDeltaTime > 0.f ? FMath::Min(InDeltaTime, MaxDeltaTime) : InDeltaTime;
+	}
+
+	// 1 if the value is NaN or infinite (all exponent bits set), 0 otherwise,
+	// tests the bits so fast floating point math can not fold the check away
+	static FORCEINLINE uint32 NonFiniteBit(float InValue)
+	{
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, &InValue, sizeof(Bits));
+		return (Bits & 0x7F800000u) == 0x7F800000u;
+	}
+};
+
+/**
+* Number of times the update guards fired
+*/
+struct FMCPIDGuardCounters
+{
+	// Updates with non finite error (or measurement) components
+	uint32 NonFiniteErrors = 0;
+
+	// Updates with a time step below the min (or NaN)
+	uint32 SmallDeltaTimes = 0;
+
+	// Updates with a clamped time step
+	uint32 ClampedDeltaTimes = 0;
+
+	// Sum of all the counters
+	uint32 Total() const { return NonFiniteErrors + SmallDeltaTimes + ClampedDeltaTimes; }
+
+	// Add the counters of another controller
+	FMCPIDGuardCounters& operator+=(const FMCPIDGuardCounters& Other)
+	{
+		NonFiniteErrors += Other.NonFiniteErrors;
+		SmallDeltaTimes += Other.SmallDeltaTimes;
+		ClampedDeltaTimes += Other.ClampedDeltaTimes;
+		return *this;
+	}
+};
@@ -0,0 +1,66 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "EngineMinimal.h"
+#include "MCSpringController3D.generated.h"
+
+/**
+* Closed form damped spring for FVector
+* Moves the current value towards the target (error) without overshoot (critically damped)
+* or with a given damping ratio (under damped), exact for any time step
+* Output: the average velocity of the step which reaches the next spring state
+*/
+USTRUCT(/*BlueprintType*/)
+struct UMCPIDCONTROLLER_API FMCSpringController3D
+{
+	GENERATED_BODY()
+
+public:
+	// Time (s) in which the distance envelope to the target halves
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.001", UIMin = "0.001"))
+	float HalfLife = 0.05f;
+
+	// Damping ratio, 1 = critically damped (no overshoot), smaller values oscillate
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.05", ClampMax = "1.0", UIMin = "0.05", UIMax = "1.0"))
+	float DampingRatio = 1.f;
+
+	// Max output (as absolute value), 0 = unlimited
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float MaxOutAbs = 0.f;
+
+	// Default constructor
+	FMCSpringController3D() { }
+
+	// Constructor with the spring parameters
+	FMCSpringController3D(float InHalfLife, float InDampingRatio = 1.f, float InMaxOutAbs = 0.f);
+
+	// Set the spring parameters, reset the spring velocity
+	void Init(float InHalfLife, float InDampingRatio = 1.f, float InMaxOutAbs = 0.f);
+
+	// Reset the spring velocity (e.g. to the current velocity of the body) and the cached coefficients
+	void Init(const FVector& InVelocity = FVector::ZeroVector);
+
+	// Get the average velocity of the spring over the step (error: target - current)
+	FVector Update(const FVector InError, const float InDeltaTime);
+
+private:
+	// Compute the step coefficients for the time step
+	void UpdateCoefficients(const float InDeltaTime);
+
+private:
+	// Time step of the cached coefficients
+	float CachedDeltaTime = -1.f;
+
+	// Step coefficients of the error and of the velocity in the output
+	float ErrorCoeff = 0.f;
+	float VelocityCoeff = 0.f;
+
+	// Step coefficients of the error and of the velocity in the next spring velocity
+	float NextErrorCoeff = 0.f;
+	float NextVelocityCoeff = 0.f;
+
+	// Spring velocity at the end of the last step
+	FVector Velocity = FVector::ZeroVector;
+};
@@ -0,0 +1,51 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+/**
+* Parallel gripper grasp state
+*	Free - no finger is touching anything
+*	Contact - at least one finger is touching an object, without holding it
+*	Stable - both fingers are pressing the same object with enough force and it does not slide
+*	Slipping - the held object slides relative to the fingers
+*/
+UENUM()
+enum class EMCGripperGraspState : uint8
+{
+	Free					UMETA(DisplayName = "Free"),
+	Contact					UMETA(DisplayName = "Contact"),
+	Stable					UMETA(DisplayName = "Stable"),
+	Slipping				UMETA(DisplayName = "Slipping"),
+};
+
+/**
+* Contacts of a finger aggregated over one physics frame,
+* the rigid body hit events of all the substeps are summed (the contact modify callbacks are engine global and not used)
+*/
+struct FMCGripperFingerContact
+{
+	// Touched object with the largest normal force
+	TWeakObjectPtr<AActor> Object;
+
+	// Sum of the normal forces (the hit impulses over the frame time)
+	float NormalForce = 0.f;
+
+	// Number of hit events (one per touched component and substep, not per contact point)
+	int32 NumHits = 0;
+
+	// Largest tangential speed between the finger and the touched object at the impact points
+	float SlipSpeed = 0.f;
+
+	// Normal force of the current object (used to select the object)
+	float ObjectNormalForce = 0.f;
+
+	// True if the finger touched anything during the frame
+	bool IsInContact() const { return NumHits > 0; };
+
+	// Clear the aggregated values
+	void Reset() { *this = FMCGripperFingerContact(); };
+};
@@ -6,9 +6,61 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "Components/StaticMeshComponent.h"
 #include "MCGripperControlType.h"
+#include "MCPIDController.h"
+#include "MCInputFilter.h"
 #include "MCParallelGripperController.generated.h"
 
+/**
+* Finger state of the PID control types (values along the constraint linear axis, relative to the gripper body)
+*/
+struct FMCParallelGripperFinger
+{
+	// Finger static mesh
+	UStaticMeshComponent* Mesh = nullptr;
+
+	// Position controller along the axis
+	FMCPIDController PID;
+
+	// Constraint linear axis in the gripper body frame
+	FVector Axis = FVector::ZeroVector;
+
+	// Constraint location in the gripper body frame (zero position)
+	FVector RestLocation = FVector::ZeroVector;
+
+	// Direction of the closing movement along the axis (+1/-1)
+	float ClosingSign = 1.f;
+
+	// Movement limit
+	float Limit = 0.f;
+
+	// Target position
+	float Target = 0.f;
+
+	// Measured position
+	float Position = 0.f;
+
+	// Measured velocity relative to the gripper body
+	float Velocity = 0.f;
+
+	// Consecutive substeps without movement while the target is not reached
+	int32 StallCount = 0;
+
+	// Position where the current closing movement started
+	float TravelStart = 0.f;
+
+	// True once the finger moved enough since the closing movement started (a finger starting from rest is not stalled)
+	bool bHasTraveled = false;
+
+	// True if the finger touches an object (set by the owner, optional)
+	bool bInContact = false;
+
+	// True if the finger is blocked by an object and the grip force is applied instead of the PID output
+	bool bIsHolding = false;
+};
+
 /**
  * Controller mapping the input from the user to the parallel gripper
  */
@@ -26,7 +78,36 @@ public:
 		const FName& InputAxisName,
 		UPhysicsConstraintComponent* LeftFingerConstraint,
 		UPhysicsConstraintComponent* RightFingerConstraint,
-		float InP, float InI, float InD, float InMax);
+		float InP, float InI, float InD, float InMax,
+		float InGripForce = 0.f,
+		bool bBindInput = true);
+
+	// Set the input filter (call before init)
+	void SetInputFilter(const FMCInputFilter& InInputFilter) { InputFilter = InInputFilter; };
+
+	// Set the anti-windup, derivative filtering and slew limiting of the finger PIDs (call before init)
+	void SetPIDSettings(const FMCPIDSettings& InPIDSettings) { PIDSettings = InPIDSettings; };
+
+	// Get the input filter (statistics)
+	const FMCInputFilter& GetInputFilter() const { return InputFilter; };
+
+	// Set the normalized target (0 open - 1 closed), same as the input value
+	void SetTarget(float Value);
+
+	// Set the grip force (acceleration / force control types) or the drive force limit (linear drive)
+	void SetForce(float Force);
+
+	// True if the control type runs in the physics substeps and the substep update needs to be registered every frame
+	bool IsSubstepped() const { return bIsSubstepped; };
+
+	// Register the substep update for the next physics frame (the callback is consumed every frame)
+	void RegisterSubstepUpdate();
+
+	// Set the finger contacts, a touching finger can switch to the grip force without moving first (optional)
+	void SetFingerContacts(bool bInLeftContact, bool bInRightContact);
+
+	// Get the measured gap between the fingers along the constraint axis (PID control types)
+	float GetFingerGap() const;
 
 private:
 	// Bind user inputs
@@ -36,7 +117,29 @@ private:
 	// force = spring * (targetPosition - position) + damping * (targetVelocity - velocity)
 	void SetupLinearDrive(float Spring, float Damping, float ForceLimit);
 
-	// Update function bound to the input
+	// Setup the fingers for the position / acceleration / force control types, return false if no limited axis is found
+	bool SetupFingers();
+
+	// Setup the per finger PID controllers, the output is applied in the physics substeps
+	void SetupPIDControl(float InP, float InI, float InD, float InMax, bool bInAccelChange, float InGripForce);
+
+	// Set the finger target positions from the normalized input value
+	void SetFingerTargets(float Value);
+
+	// Update the fingers in the physics substep
+	void SubstepUpdate(float DeltaTime, FBodyInstance* BodyInstance);
+
+	// Measure the finger state and apply the controller output towards the target
+	void UpdateFinger(FMCParallelGripperFinger& Finger, float InTarget, float InInputValue, float InGripForce,
+		const FTransform& ParentTransform, const FVector& ParentVelocity, float DeltaTime);
+
+	// Switch between PID tracking and applying the grip force, return true if the finger is holding an object
+	bool UpdateHoldState(FMCParallelGripperFinger& Finger, float Error, float InGripForce);
+
+	// Filter the input, update only if the value changed enough
+	void OnInput(float Value);
+
+	// Update with the new target value
 	void Update(float Value);
 
 	/* Update function bindings */
@@ -54,6 +157,12 @@ private:
 	void Update_LinearDriver_Y(float Value);
 	void Update_LinearDriver_Z(float Value);
 
+	/* Update function for the position control (teleport) */
+	void Update_Position(float Value);
+
+	/* Update function for the acceleration and force control (targets are tracked in the physics substeps) */
+	void Update_PID(float Value);
+
 private:
 	// Left finger constraint
 	UPhysicsConstraintComponent* LeftConstraint;
@@ -66,4 +175,55 @@ private:
 
 	// Right finger movement limit
 	float RightLimit;
+
+	// Gripper body mesh (parent of the constraints)
+	UPROPERTY() // Avoid GC
+	UStaticMeshComponent* ParentMesh;
+
+	// Left finger state
+	FMCParallelGripperFinger LeftFinger;
+
+	// Right finger state
+	FMCParallelGripperFinger RightFinger;
+
+	// Physics substep callback
+	FCalculateCustomPhysics OnCalculateCustomPhysics;
+
+	// True if the finger PID controllers are updated in the physics substeps
+	bool bIsSubstepped;
+
+	// Apply the controller output as acceleration (true) or as force (false)
+	bool bAccelChange;
+
+	// Linear drive spring
+	float DriveSpring;
+
+	// Linear drive damping
+	float DriveDamping;
+
+	// Grip force applied while holding an object (scaled by the input value), 0 disables the hold state
+	float GripForce;
+
+	// Skips the updates if the input did not change enough
+	FMCInputFilter InputFilter;
+
+	// Anti-windup, derivative filtering and slew limiting of the finger PIDs
+	FMCPIDSettings PIDSettings;
+
+	// Last input value
+	float InputValue;
+
+	// Copy of the input value, finger targets, grip force and contacts read by the physics substeps (guarded by the lock)
+	float SubstepInputValue;
+	float SubstepLeftTarget;
+	float SubstepRightTarget;
+	float SubstepGripForce;
+	bool bSubstepLeftContact;
+	bool bSubstepRightContact;
+
+	// Guards the values shared with the physics thread
+	mutable FCriticalSection SubstepLock;
+
+	// Measured gap between the fingers (guarded by the lock, written by the physics substeps)
+	float FingerGap;
 };
@@ -2,6 +2,7 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "MCParallelGripper.h"
+#include "MCParallelGripperFleet.h"
 #include "GameFramework/PlayerController.h"
 #include "Components/InputComponent.h"
 #include "Components/StaticMeshComponent.h"
@@ -11,7 +12,10 @@ UMCParallelGripper::UMCParallelGripper()
 {
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = false;
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	// Register the substep update before the physics simulation (Acceleration / Force control types)
+	PrimaryComponentTick.TickGroup = ETickingGroup::TG_PrePhysics;
 
 	// Create the constraints
 	LeftFingerConstraint = CreateDefaultSubobject<UPhysicsConstraintComponent>(TEXT("LeftFingerConstraint"));
@@ -32,12 +36,23 @@ UMCParallelGripper::UMCParallelGripper()
 	// Default values
 	InputAxisName = "LeftGrasp";
 	ControlType = EMCGripperControlType::LinearDrive;
+	bUseFleet = false;
+	FleetHandle = INDEX_NONE;
 
 	// Linear driver default values
 	P = 5000.f;
 	I = 0.f;
 	D = 200.f;
 	Max = 15000.f;
+	GripForce = 0.f;
+
+	// Grasp state default values
+	bDetectGraspState = false;
+	MinGraspForce = 100.f;
+	SlipSpeedThreshold = 1.f;
+	GraspLossSteps = 2;
+	GraspState = EMCGripperGraspState::Free;
+	NumLostSteps = 0;
 }
 
 // Called when the game starts
@@ -75,17 +90,63 @@ void UMCParallelGripper::BeginPlay()
 			UMCParallelGripper::SetupPhysics(OwnerSM);
 			UMCParallelGripper::SetupPhysics(LeftSM);
 			UMCParallelGripper::SetupPhysics(RightSM);
-			//SetComponentTickEnabled(true);
 
 			// Create the controller
 			PGController = NewObject<UMCParallelGripperController>(this);
 
 			// Init controller
-			PGController->Init(ControlType, InputAxisName, LeftFingerConstraint, RightFingerConstraint, P, I, D, Max);
+			PGController->SetInputFilter(InputFilter);
+			PGController->SetPIDSettings(PIDSettings);
+			PGController->Init(ControlType, InputAxisName, LeftFingerConstraint, RightFingerConstraint, P, I, D, Max, GripForce, !bUseFleet);
+
+			// Listen to the finger contacts
+			if (bDetectGraspState)
+			{
+				LeftSM->SetNotifyRigidBodyCollision(true);
+				RightSM->SetNotifyRigidBodyCollision(true);
+				LeftSM->OnComponentHit.AddDynamic(this, &UMCParallelGripper::OnFingerHit);
+				RightSM->OnComponentHit.AddDynamic(this, &UMCParallelGripper::OnFingerHit);
+			}
+
+			if (bUseFleet)
+			{
+				// The fleet updates all its grippers in one pass
+				if (AMCParallelGripperFleet* Fleet = AMCParallelGripperFleet::Get(GetWorld()))
+				{
+					FleetHandle = Fleet->Register(this);
+				}
+			}
+			else
+			{
+				// Tick only if the controller updates in the physics substeps or the grasp state is detected
+				SetComponentTickEnabled(PGController->IsSubstepped() || bDetectGraspState);
+			}
 		}
 	}	
 }
 
+// Called when the game ends
+void UMCParallelGripper::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (PGController && FleetHandle == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d [%s] Input filter: %s"),
+			*FString(__func__), __LINE__, *InputAxisName.ToString(), *PGController->GetInputFilter().GetStatsString());
+	}
+
+	if (FleetHandle != INDEX_NONE)
+	{
+		// Do not spawn a fleet while the world is torn down
+		if (AMCParallelGripperFleet* Fleet = AMCParallelGripperFleet::Find(GetWorld()))
+		{
+			Fleet->Unregister(FleetHandle);
+		}
+		FleetHandle = INDEX_NONE;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 #if WITH_EDITOR
 // Called when a property is changed in the editor
 void UMCParallelGripper::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
@@ -167,6 +228,34 @@ void UMCParallelGripper::PostEditChangeProperty(struct FPropertyChangedEvent& Pr
 void UMCParallelGripper::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UMCParallelGripper::UpdateGripper();
+}
+
+// Set the normalized opening (0 closed - 1 open) and the force, a negative force keeps the current one
+void UMCParallelGripper::SetCommand(float Opening, float Force)
+{
+	if (PGController)
+	{
+		PGController->SetTarget(1.f - Opening);
+		if (Force >= 0.f)
+		{
+			PGController->SetForce(Force);
+		}
+	}
+}
+
+// Register the substep update and detect the grasp state (called by the tick or by the fleet)
+void UMCParallelGripper::UpdateGripper()
+{
+	PGController->RegisterSubstepUpdate();
+
+	// The hit events of the last physics frame have been dispatched
+	if (bDetectGraspState)
+	{
+		UMCParallelGripper::UpdateGraspState();
+		PGController->SetFingerContacts(LeftFingerContact.IsInContact(), RightFingerContact.IsInContact());
+	}
 }
 
 // Set default values to the constraints
@@ -187,4 +276,107 @@ void UMCParallelGripper::SetupPhysics(UStaticMeshComponent* StaticMeshComponent)
 	StaticMeshComponent->SetMobility(EComponentMobility::Movable);
 	StaticMeshComponent->SetSimulatePhysics(true);
 	StaticMeshComponent->SetEnableGravity(false);
-}
\ No newline at end of file
+}
+
+// Aggregate the finger contacts of the last physics frame and broadcast the grasp state changes
+void UMCParallelGripper::UpdateGraspState()
+{
+	LeftFingerContact = PendingLeftContact;
+	RightFingerContact = PendingRightContact;
+	PendingLeftContact.Reset();
+	PendingRightContact.Reset();
+
+	// Compute the state from the contacts
+	AActor* LeftObject = LeftFingerContact.Object.Get();
+	AActor* RightObject = RightFingerContact.Object.Get();
+	EMCGripperGraspState NewState = EMCGripperGraspState::Free;
+	AActor* NewObject = nullptr;
+	if (LeftObject && LeftObject == RightObject &&
+		FMath::Min(LeftFingerContact.NormalForce, RightFingerContact.NormalForce) >= MinGraspForce)
+	{
+		NewObject = LeftObject;
+		NewState = FMath::Max(LeftFingerContact.SlipSpeed, RightFingerContact.SlipSpeed) > SlipSpeedThreshold ?
+			EMCGripperGraspState::Slipping : EMCGripperGraspState::Stable;
+	}
+	else if (LeftObject || RightObject)
+	{
+		NewObject = LeftObject ? LeftObject : RightObject;
+		NewState = EMCGripperGraspState::Contact;
+	}
+
+	// Ignore short contact losses
+	const bool bWasGrasping = IsGrasping();
+	const bool bIsGrasping = NewState == EMCGripperGraspState::Stable || NewState == EMCGripperGraspState::Slipping;
+	if ((bWasGrasping && !bIsGrasping) || (GraspState != EMCGripperGraspState::Free && NewState == EMCGripperGraspState::Free))
+	{
+		if (++NumLostSteps < GraspLossSteps)
+		{
+			return;
+		}
+	}
+	NumLostSteps = 0;
+
+	if (NewState == GraspState && NewObject == GraspedObject.Get())
+	{
+		return;
+	}
+
+	// Broadcast the changes
+	const float Time = GetWorld()->GetTimeSeconds();
+	if (bWasGrasping && (!bIsGrasping || NewObject != GraspedObject.Get()))
+	{
+		OnGraspRelease.Broadcast(GetOwner(), GraspedObject.Get(), Time);
+	}
+	if (GraspState == EMCGripperGraspState::Free && NewState != EMCGripperGraspState::Free)
+	{
+		OnGripperContact.Broadcast(GetOwner(), NewObject, Time);
+	}
+	if (NewState == EMCGripperGraspState::Stable && (GraspState != EMCGripperGraspState::Stable || NewObject != GraspedObject.Get()))
+	{
+		OnGraspStable.Broadcast(GetOwner(), NewObject, Time);
+	}
+	if (NewState == EMCGripperGraspState::Slipping && (GraspState != EMCGripperGraspState::Slipping || NewObject != GraspedObject.Get()))
+	{
+		OnGraspSlip.Broadcast(GetOwner(), NewObject, Time,
+			FMath::Max(LeftFingerContact.SlipSpeed, RightFingerContact.SlipSpeed));
+	}
+
+	GraspState = NewState;
+	GraspedObject = NewObject;
+}
+
+// Called when a finger collides with an object
+void UMCParallelGripper::OnFingerHit(UPrimitiveComponent* HitComponent,
+	AActor* OtherActor,
+	UPrimitiveComponent* OtherComp,
+	FVector NormalImpulse,
+	const FHitResult& Hit)
+{
+	// Ignore the gripper itself
+	if (OtherActor == nullptr || OtherActor == GetOwner() || OtherActor == LeftFinger || OtherActor == RightFinger)
+	{
+		return;
+	}
+
+	FMCGripperFingerContact& Contact = HitComponent->GetOwner() == LeftFinger ? PendingLeftContact : PendingRightContact;
+
+	// The impulses of the substeps are summed, the frame time gives the mean force
+	const float DeltaTime = GetWorld()->GetDeltaSeconds();
+	const float NormalForce = DeltaTime > SMALL_NUMBER ? NormalImpulse.Size() / DeltaTime : 0.f;
+	Contact.NormalForce += NormalForce;
+	Contact.NumHits++;
+	if (NormalForce >= Contact.ObjectNormalForce)
+	{
+		Contact.Object = OtherActor;
+		Contact.ObjectNormalForce = NormalForce;
+	}
+
+	// Tangential component of the relative velocity at the contact point
+	if (OtherComp)
+	{
+		const FVector RelVelocity = OtherComp->GetPhysicsLinearVelocityAtPoint(Hit.ImpactPoint) -
+			HitComponent->GetPhysicsLinearVelocityAtPoint(Hit.ImpactPoint);
+		const FVector TangentVelocity = RelVelocity - FVector::DotProduct(RelVelocity, Hit.ImpactNormal) * Hit.ImpactNormal;
+		Contact.SlipSpeed = FMath::Max(Contact.SlipSpeed, TangentVelocity.Size());
+	}
+}
@@ -2,12 +2,40 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "MCParallelGripperController.h"
+#include "Engine/StaticMeshActor.h"
+
+// Finger distance to the target (cm) under which the finger is considered free
+static constexpr float GripperContactTolerance = 0.1f;
+
+// Finger speed (cm/s) under which a finger that did not reach its target is considered blocked
+static constexpr float GripperStallSpeed = 0.5f;
+
+// Number of consecutive blocked substeps before switching to the grip force
+static constexpr int32 GripperStallSubsteps = 4;
+
+// Finger travel (cm) since the closing movement started before the stall is counted (without a contact)
+static constexpr float GripperStallMinTravel = 0.2f;
 
 // Default constructor
 UMCParallelGripperController::UMCParallelGripperController()
 {
 	// Bind update function pointer  with default
 	UpdateFunctionPointer = &UMCParallelGripperController::Update_NONE;
+
+	ParentMesh = nullptr;
+	bIsSubstepped = false;
+	bAccelChange = false;
+	DriveSpring = 0.f;
+	DriveDamping = 0.f;
+	GripForce = 0.f;
+	InputValue = 0.f;
+	SubstepInputValue = 0.f;
+	SubstepLeftTarget = 0.f;
+	SubstepRightTarget = 0.f;
+	SubstepGripForce = 0.f;
+	bSubstepLeftContact = false;
+	bSubstepRightContact = false;
+	FingerGap = 0.f;
 }
 
 // Init controller
@@ -15,7 +43,9 @@ void UMCParallelGripperController::Init(EMCGripperControlType ControlType,
 	const FName& InputAxisName,
 	UPhysicsConstraintComponent* LeftFingerConstraint,
 	UPhysicsConstraintComponent* RightFingerConstraint,
-	float InP, float InI, float InD, float InMax)
+	float InP, float InI, float InD, float InMax,
+	float InGripForce,
+	bool bBindInput)
 {
 	if (LeftFingerConstraint == nullptr || RightFingerConstraint == nullptr)
 	{
@@ -28,27 +58,95 @@ void UMCParallelGripperController::Init(EMCGripperControlType ControlType,
 	LeftLimit = LeftConstraint->ConstraintInstance.GetLinearLimit();
 	RightLimit = RightConstraint->ConstraintInstance.GetLinearLimit();
 
-	// Set the user input bindings
-	UMCParallelGripperController::SetupInputBindings(InputAxisName);
+	// Set the user input bindings (programmatically controlled grippers use SetTarget)
+	if (bBindInput)
+	{
+		UMCParallelGripperController::SetupInputBindings(InputAxisName);
+	}
 
 	// Initialize control types
 	switch (ControlType)
 	{
 	case EMCGripperControlType::Position:
-		// TODO not implemented
+		if (UMCParallelGripperController::SetupFingers())
+		{
+			UpdateFunctionPointer = &UMCParallelGripperController::Update_Position;
+		}
 		break;
 	case EMCGripperControlType::LinearDrive:
+		if (InI > 0.f)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d The linear drive is a PD drive, the I gain is ignored (use the Acceleration or Force control types).."),
+				*FString(__func__), __LINE__);
+		}
 		UMCParallelGripperController::SetupLinearDrive(InP, InD, InMax);
 		break;
 	case EMCGripperControlType::Acceleration:
-		// TODO not implemented
+		if (UMCParallelGripperController::SetupFingers())
+		{
+			UMCParallelGripperController::SetupPIDControl(InP, InI, InD, InMax, true, InGripForce);
+		}
 		break;
 	case EMCGripperControlType::Force:
-		// TODO not implemented
+		if (UMCParallelGripperController::SetupFingers())
+		{
+			UMCParallelGripperController::SetupPIDControl(InP, InI, InD, InMax, false, InGripForce);
+		}
 		break;
 	}
 }
 
+// Register the substep update for the next physics frame (the callback is consumed every frame)
+void UMCParallelGripperController::RegisterSubstepUpdate()
+{
+	if (bIsSubstepped)
+	{
+		if (FBodyInstance* BI = LeftFinger.Mesh->GetBodyInstance())
+		{
+			BI->AddCustomPhysics(OnCalculateCustomPhysics);
+		}
+	}
+}
+
+// Set the normalized target (0 open - 1 closed), same as the input value
+void UMCParallelGripperController::SetTarget(float Value)
+{
+	UMCParallelGripperController::Update(FMath::Clamp(Value, 0.f, 1.f));
+}
+
+// Set the grip force (acceleration / force control types) or the drive force limit (linear drive)
+void UMCParallelGripperController::SetForce(float Force)
+{
+	if (bIsSubstepped)
+	{
+		GripForce = Force;
+		FScopeLock Lock(&SubstepLock);
+		SubstepGripForce = GripForce;
+	}
+	else if (UpdateFunctionPointer == &UMCParallelGripperController::Update_LinearDriver_X ||
+		UpdateFunctionPointer == &UMCParallelGripperController::Update_LinearDriver_Y ||
+		UpdateFunctionPointer == &UMCParallelGripperController::Update_LinearDriver_Z)
+	{
+		LeftConstraint->SetLinearDriveParams(DriveSpring, DriveDamping, Force);
+		RightConstraint->SetLinearDriveParams(DriveSpring, DriveDamping, Force);
+	}
+}
+
+// Set the finger contacts, a touching finger can switch to the grip force without moving first (optional)
+void UMCParallelGripperController::SetFingerContacts(bool bInLeftContact, bool bInRightContact)
+{
+	FScopeLock Lock(&SubstepLock);
+	bSubstepLeftContact = bInLeftContact;
+	bSubstepRightContact = bInRightContact;
+}
+
+// Get the measured gap between the fingers along the constraint axis (PID control types)
+float UMCParallelGripperController::GetFingerGap() const
+{
+	FScopeLock Lock(&SubstepLock);
+	return FingerGap;
+}
+
 // Bind user input to function
 void UMCParallelGripperController::SetupInputBindings(const FName& InputAxisName)
 {
@@ -57,7 +155,7 @@ void UMCParallelGripperController::SetupInputBindings(const FName& InputAxisName
 	{
 		if (UInputComponent* IC = PC->InputComponent)
 		{
-			IC->BindAxis(InputAxisName, this, &UMCParallelGripperController::Update);
+			IC->BindAxis(InputAxisName, this, &UMCParallelGripperController::OnInput);
 		}
 	}
 }
@@ -68,6 +166,8 @@ void UMCParallelGripperController::SetupLinearDrive(float Spring, float Damping,
 {
 	// Set linear driver parameters, it is a proportional derivative (PD) drive, 
 	// where force = spring * (targetPosition - position) + damping * (targetVelocity - velocity)
+	DriveSpring = Spring;
+	DriveDamping = Damping;
 	LeftConstraint->SetLinearDriveParams(Spring, Damping, ForceLimit);
 	RightConstraint->SetLinearDriveParams(Spring, Damping, ForceLimit);
 
@@ -95,7 +195,248 @@ void UMCParallelGripperController::SetupLinearDrive(float Spring, float Damping,
 	}
 }
 
-// Update function bound to the input
+// Setup the fingers for the position / acceleration / force control types, return false if no limited axis is found
+bool UMCParallelGripperController::SetupFingers()
+{
+	AStaticMeshActor* ParentActor = Cast<AStaticMeshActor>(LeftConstraint->ConstraintActor1);
+	AStaticMeshActor* LeftActor = Cast<AStaticMeshActor>(LeftConstraint->ConstraintActor2);
+	AStaticMeshActor* RightActor = Cast<AStaticMeshActor>(RightConstraint->ConstraintActor2);
+	if (ParentActor == nullptr || LeftActor == nullptr || RightActor == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d The finger constraints are not set up between static mesh actors.."), *FString(__func__), __LINE__);
+		return false;
+	}
+	ParentMesh = ParentActor->GetStaticMeshComponent();
+	LeftFinger.Mesh = LeftActor->GetStaticMeshComponent();
+	RightFinger.Mesh = RightActor->GetStaticMeshComponent();
+	if (ParentMesh == nullptr || LeftFinger.Mesh == nullptr || RightFinger.Mesh == nullptr)
+	{
+		return false;
+	}
+
+	// Same axis and target mapping as the linear driver (the Y axis is mirrored)
+	EAxis::Type LimitedAxis;
+	if (LeftConstraint->ConstraintInstance.GetLinearXMotion() == ELinearConstraintMotion::LCM_Limited &&
+		RightConstraint->ConstraintInstance.GetLinearXMotion() == ELinearConstraintMotion::LCM_Limited)
+	{
+		LimitedAxis = EAxis::X;
+		LeftFinger.ClosingSign = 1.f;
+	}
+	else if (LeftConstraint->ConstraintInstance.GetLinearYMotion() == ELinearConstraintMotion::LCM_Limited &&
+		RightConstraint->ConstraintInstance.GetLinearYMotion() == ELinearConstraintMotion::LCM_Limited)
+	{
+		LimitedAxis = EAxis::Y;
+		LeftFinger.ClosingSign = -1.f;
+	}
+	else if (LeftConstraint->ConstraintInstance.GetLinearZMotion() == ELinearConstraintMotion::LCM_Limited &&
+		RightConstraint->ConstraintInstance.GetLinearZMotion() == ELinearConstraintMotion::LCM_Limited)
+	{
+		LimitedAxis = EAxis::Z;
+		LeftFinger.ClosingSign = 1.f;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d No limited linear axis found on the finger constraints.."), *FString(__func__), __LINE__);
+		return false;
+	}
+	RightFinger.ClosingSign = -LeftFinger.ClosingSign;
+
+	// Express the constraint frames relative to the gripper body
+	const FTransform ParentTransform = ParentMesh->GetComponentTransform();
+	const FTransform LeftFrame = LeftConstraint->GetComponentTransform();
+	const FTransform RightFrame = RightConstraint->GetComponentTransform();
+	LeftFinger.Axis = ParentTransform.InverseTransformVectorNoScale(LeftFrame.GetUnitAxis(LimitedAxis));
+	RightFinger.Axis = ParentTransform.InverseTransformVectorNoScale(RightFrame.GetUnitAxis(LimitedAxis));
+	LeftFinger.RestLocation = ParentTransform.InverseTransformPositionNoScale(LeftFrame.GetLocation());
+	RightFinger.RestLocation = ParentTransform.InverseTransformPositionNoScale(RightFrame.GetLocation());
+	LeftFinger.Limit = LeftLimit;
+	RightFinger.Limit = RightLimit;
+
+	// Start from the open position
+	UMCParallelGripperController::SetFingerTargets(0.f);
+	return true;
+}
+
+// Setup the per finger PID controllers, the output is applied in the physics substeps
+void UMCParallelGripperController::SetupPIDControl(float InP, float InI, float InD, float InMax, bool bInAccelChange, float InGripForce)
+{
+	LeftFinger.PID.Settings = PIDSettings;
+	RightFinger.PID.Settings = PIDSettings;
+	LeftFinger.PID.Init(InP, InI, InD, InMax);
+	RightFinger.PID.Init(InP, InI, InD, InMax);
+	bAccelChange = bInAccelChange;
+	GripForce = InGripForce;
+	{
+		FScopeLock Lock(&SubstepLock);
+		SubstepGripForce = GripForce;
+	}
+
+	// The drives would fight the controller
+	LeftConstraint->SetLinearPositionDrive(false, false, false);
+	RightConstraint->SetLinearPositionDrive(false, false, false);
+
+	OnCalculateCustomPhysics.BindUObject(this, &UMCParallelGripperController::SubstepUpdate);
+	bIsSubstepped = true;
+	UpdateFunctionPointer = &UMCParallelGripperController::Update_PID;
+}
+
+// Set the finger target positions from the normalized input value
+void UMCParallelGripperController::SetFingerTargets(float Value)
+{
+	// Symmetrical limits, f(x) = (2x-1)*MaxLim, mirrored for the closing direction
+	InputValue = Value;
+	LeftFinger.Target = LeftFinger.ClosingSign * (2.f * Value - 1.f) * LeftFinger.Limit;
+	RightFinger.Target = RightFinger.ClosingSign * (2.f * Value - 1.f) * RightFinger.Limit;
+
+	// Hand over to the physics substeps
+	FScopeLock Lock(&SubstepLock);
+	SubstepInputValue = InputValue;
+	SubstepLeftTarget = LeftFinger.Target;
+	SubstepRightTarget = RightFinger.Target;
+}
+
+// Update the fingers in the physics substep
+void UMCParallelGripperController::SubstepUpdate(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	FBodyInstance* ParentBI = ParentMesh->GetBodyInstance();
+	if (ParentBI == nullptr || DeltaTime < SMALL_NUMBER)
+	{
+		return;
+	}
+
+	const FTransform ParentTransform = ParentBI->GetUnrealWorldTransform_AssumesLocked();
+	const FVector ParentVelocity = ParentBI->GetUnrealWorldVelocity_AssumesLocked();
+
+	// Snapshot of the values written by the game thread
+	float Input;
+	float LeftTarget;
+	float RightTarget;
+	float Force;
+	{
+		FScopeLock Lock(&SubstepLock);
+		Input = SubstepInputValue;
+		LeftTarget = SubstepLeftTarget;
+		RightTarget = SubstepRightTarget;
+		Force = SubstepGripForce;
+		LeftFinger.bInContact = bSubstepLeftContact;
+		RightFinger.bInContact = bSubstepRightContact;
+	}
+
+	UMCParallelGripperController::UpdateFinger(LeftFinger, LeftTarget, Input, Force, ParentTransform, ParentVelocity, DeltaTime);
+	UMCParallelGripperController::UpdateFinger(RightFinger, RightTarget, Input, Force, ParentTransform, ParentVelocity, DeltaTime);
+
+	// Both fingers move along the same axis
+	const float Gap = FVector::Dist(LeftFinger.RestLocation + LeftFinger.Axis * LeftFinger.Position,
+		RightFinger.RestLocation + RightFinger.Axis * RightFinger.Position);
+	FScopeLock Lock(&SubstepLock);
+	FingerGap = Gap;
+}
+
+// Measure the finger state and apply the controller output towards the target
+void UMCParallelGripperController::UpdateFinger(FMCParallelGripperFinger& Finger, float InTarget, float InInputValue, float InGripForce,
+	const FTransform& ParentTransform, const FVector& ParentVelocity, float DeltaTime)
+{
+	FBodyInstance* BI = Finger.Mesh->GetBodyInstance();
+	if (BI == nullptr)
+	{
+		return;
+	}
+
+	const FVector WorldAxis = ParentTransform.TransformVectorNoScale(Finger.Axis);
+	const FVector Location = ParentTransform.InverseTransformPositionNoScale(BI->GetUnrealWorldTransform_AssumesLocked().GetLocation());
+	Finger.Position = FVector::DotProduct(Location - Finger.RestLocation, Finger.Axis);
+	Finger.Velocity = FVector::DotProduct(BI->GetUnrealWorldVelocity_AssumesLocked() - ParentVelocity, WorldAxis);
+	const float Error = InTarget - Finger.Position;
+
+	float Output;
+	if (UMCParallelGripperController::UpdateHoldState(Finger, Error, InGripForce))
+	{
+		// Constant grip instead of the (saturated) position error output
+		Output = Finger.ClosingSign * InGripForce * InInputValue;
+		if (bAccelChange)
+		{
+			Output /= BI->GetBodyMass();
+		}
+	}
+	else
+	{
+		Output = Finger.PID.Update(Error, Finger.Position, DeltaTime);
+	}
+
+	BI->AddForce(WorldAxis * Output, false, bAccelChange);
+	if (!bAccelChange)
+	{
+		// Reaction on the gripper body
+		if (FBodyInstance* ParentBI = ParentMesh->GetBodyInstance())
+		{
+			ParentBI->AddForce(-WorldAxis * Output, false, false);
+		}
+	}
+}
+
+// Switch between PID tracking and applying the grip force, return true if the finger is holding an object
+bool UMCParallelGripperController::UpdateHoldState(FMCParallelGripperFinger& Finger, float Error, float InGripForce)
+{
+	if (InGripForce <= 0.f)
+	{
+		return false;
+	}
+
+	const float ClosingError = Error * Finger.ClosingSign;
+	if (Finger.bIsHolding)
+	{
+		// The object slipped out or the gripper is opening, track the target again
+		if (ClosingError < GripperContactTolerance)
+		{
+			Finger.bIsHolding = false;
+			Finger.TravelStart = Finger.Position;
+			Finger.bHasTraveled = false;
+			Finger.PID.Init();
+		}
+	}
+	else if (ClosingError > GripperContactTolerance)
+	{
+		// A finger starting to close from rest is slow but not blocked, count only after it moved or touched something
+		if (!Finger.bHasTraveled && FMath::Abs(Finger.Position - Finger.TravelStart) >= GripperStallMinTravel)
+		{
+			Finger.bHasTraveled = true;
+		}
+
+		if ((Finger.bHasTraveled || Finger.bInContact) && FMath::Abs(Finger.Velocity) < GripperStallSpeed)
+		{
+			if (++Finger.StallCount >= GripperStallSubsteps)
+			{
+				// Clear the accumulated error, it would otherwise wind up against the object
+				Finger.bIsHolding = true;
+				Finger.StallCount = 0;
+				Finger.PID.Init();
+			}
+		}
+		else
+		{
+			Finger.StallCount = 0;
+		}
+	}
+	else
+	{
+		// Target reached (or opening), the next closing movement starts from here
+		Finger.StallCount = 0;
+		Finger.TravelStart = Finger.Position;
+		Finger.bHasTraveled = false;
+	}
+	return Finger.bIsHolding;
+}
+
+// Filter the input, update only if the value changed enough
+void UMCParallelGripperController::OnInput(float Value)
+{
+	if (InputFilter.Filter(Value, GetWorld()->GetDeltaSeconds(), Value))
+	{
+		UMCParallelGripperController::Update(Value);
+	}
+}
+
+// Update with the new target value
 void UMCParallelGripperController::Update(float Value)
 {
 	(this->*UpdateFunctionPointer)(Value);
@@ -163,3 +504,24 @@ void UMCParallelGripperController::Update_LinearDriver_Z(float Value)
 	LeftConstraint->SetLinearPositionTarget(FVector(0.f, 0.f, LeftTarget));
 	RightConstraint->SetLinearPositionTarget(FVector(0.f, 0.f, RightTarget));
 }
+
+/* Update function for the position control (teleport) */
+void UMCParallelGripperController::Update_Position(float Value)
+{
+	UMCParallelGripperController::SetFingerTargets(Value);
+
+	const FTransform ParentTransform = ParentMesh->GetComponentTransform();
+	LeftFinger.Mesh->SetWorldLocation(ParentTransform.TransformPositionNoScale(
+		LeftFinger.RestLocation + LeftFinger.Axis * LeftFinger.Target), false, nullptr, ETeleportType::TeleportPhysics);
+	RightFinger.Mesh->SetWorldLocation(ParentTransform.TransformPositionNoScale(
+		RightFinger.RestLocation + RightFinger.Axis * RightFinger.Target), false, nullptr, ETeleportType::TeleportPhysics);
+	FScopeLock Lock(&SubstepLock);
+	FingerGap = FVector::Dist(LeftFinger.RestLocation + LeftFinger.Axis * LeftFinger.Target,
+		RightFinger.RestLocation + RightFinger.Axis * RightFinger.Target);
+}
+
+/* Update function for the acceleration and force control (targets are tracked in the physics substeps) */
+void UMCParallelGripperController::Update_PID(float Value)
+{
+	UMCParallelGripperController::SetFingerTargets(Value);
+}
@@ -0,0 +1,161 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "MCParallelGripperFleet.h"
+#include "MCParallelGripper.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+// Sets default values
+AMCParallelGripperFleet::AMCParallelGripperFleet()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = ETickingGroup::TG_PrePhysics;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+// Get the fleet of the world, spawn it if it does not exist
+AMCParallelGripperFleet* AMCParallelGripperFleet::Get(UWorld* InWorld)
+{
+	if (!InWorld)
+	{
+		return nullptr;
+	}
+
+	if (AMCParallelGripperFleet* Fleet = Find(InWorld))
+	{
+		return Fleet;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Name = FName("MCParallelGripperFleet");
+	SpawnParams.ObjectFlags |= RF_Transient;
+	return InWorld->SpawnActor<AMCParallelGripperFleet>(SpawnParams);
+}
+
+// Get the fleet of the world, nullptr if it does not exist (never spawns)
+AMCParallelGripperFleet* AMCParallelGripperFleet::Find(UWorld* InWorld)
+{
+	if (!InWorld)
+	{
+		return nullptr;
+	}
+
+	for (TActorIterator<AMCParallelGripperFleet> Itr(InWorld); Itr; ++Itr)
+	{
+		return *Itr;
+	}
+	return nullptr;
+}
+
+// Apply the queued commands and update the grippers
+void AMCParallelGripperFleet::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	AMCParallelGripperFleet::DrainCommandQueue();
+
+	for (int32 Idx = 0; Idx < Grippers.Num(); ++Idx)
+	{
+		UMCParallelGripper* Gripper = Grippers[Idx];
+		if (Gripper == nullptr)
+		{
+			continue;
+		}
+
+		if (DirtyFlags[Idx])
+		{
+			Gripper->SetCommand(Openings[Idx], Forces[Idx]);
+			DirtyFlags[Idx] = false;
+		}
+		Gripper->UpdateGripper();
+	}
+}
+
+// Add the gripper to the fleet, return its handle (index and generation, INDEX_NONE if full)
+int32 AMCParallelGripperFleet::Register(UMCParallelGripper* InGripper)
+{
+	if (InGripper == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 Index;
+	if (FreeIndices.Num() > 0)
+	{
+		Index = FreeIndices.Pop(false);
+		Grippers[Index] = InGripper;
+		DirtyFlags[Index] = false;
+	}
+	else
+	{
+		if (Grippers.Num() > IndexMask)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d the fleet is full (%d grippers).."),
+				*FString(__func__), __LINE__, Grippers.Num());
+			return INDEX_NONE;
+		}
+		Openings.Add(1.f);
+		Forces.Add(-1.f);
+		DirtyFlags.Add(false);
+		Generations.Add(0);
+		Index = Grippers.Add(InGripper);
+	}
+	return (Generations[Index] << IndexBits) | Index;
+}
+
+// Remove the gripper from the fleet, its index can be reused, its handle becomes stale
+void AMCParallelGripperFleet::Unregister(int32 InHandle)
+{
+	int32 Index;
+	if (ResolveHandle(InHandle, Index))
+	{
+		Grippers[Index] = nullptr;
+		DirtyFlags[Index] = false;
+		Generations[Index] = (Generations[Index] + 1) & GenerationMask;
+		FreeIndices.Add(Index);
+	}
+}
+
+// Set the command of the gripper, applied in the next update (game thread), ignored for stale handles
+void AMCParallelGripperFleet::Command(int32 InHandle, float InOpening, float InForce)
+{
+	int32 Index;
+	if (ResolveHandle(InHandle, Index))
+	{
+		Openings[Index] = FMath::Clamp(InOpening, 0.f, 1.f);
+		Forces[Index] = InForce;
+		DirtyFlags[Index] = true;
+	}
+}
+
+// Queue the command of the gripper, applied in the next update (thread safe, lock free), ignored for stale handles
+void AMCParallelGripperFleet::EnqueueCommand(int32 InHandle, float InOpening, float InForce)
+{
+	CommandQueue.Enqueue(FMCGripperCommand{ InHandle, InOpening, InForce });
+}
+
+// Move the queued commands to the pending commands
+void AMCParallelGripperFleet::DrainCommandQueue()
+{
+	// Later commands of the same gripper overwrite the earlier ones
+	FMCGripperCommand Cmd;
+	while (CommandQueue.Dequeue(Cmd))
+	{
+		AMCParallelGripperFleet::Command(Cmd.GripperHandle, Cmd.Opening, Cmd.Force);
+	}
+}
+
+// Get the index of the registered gripper, false if the handle is stale
+bool AMCParallelGripperFleet::ResolveHandle(int32 InHandle, int32& OutIndex) const
+{
+	if (InHandle < 0)
+	{
+		return false;
+	}
+	OutIndex = InHandle & IndexMask;
+	return Grippers.IsValidIndex(OutIndex)
+		&& Grippers[OutIndex] != nullptr
+		&& Generations[OutIndex] == (InHandle >> IndexBits);
+}
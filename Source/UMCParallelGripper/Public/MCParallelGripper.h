@@ -8,6 +8,7 @@
 #include "Engine/StaticMeshActor.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
 #include "MCGripperControlType.h"
+#include "MCGripperGraspState.h"
 #include "MCParallelGripperController.h"
 #include "MCParallelGripper.generated.h"
 
@@ -21,6 +22,11 @@ enum class EMCPGHandType : uint8
 	Right					UMETA(DisplayName = "Right"),
 };
 
+/** Notify the contact, stable grasp and release events */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FMCGripperGraspSignature, AActor* /*SelfActor*/, AActor* /*OtherActor*/, float /*Time*/);
+
+/** Notify the slip event */
+DECLARE_MULTICAST_DELEGATE_FourParams(FMCGripperSlipSignature, AActor* /*SelfActor*/, AActor* /*OtherActor*/, float /*Time*/, float /*SlipSpeed*/);
 
 /**
  * Actor component setting up a parallel gripper constraints and its controller
@@ -38,6 +44,9 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 #if WITH_EDITOR
 	// Called when a property is changed in the editor
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -47,6 +56,33 @@ public:
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	// Set the normalized opening (0 closed - 1 open) and the force, a negative force keeps the current one
+	void SetCommand(float Opening, float Force = -1.f);
+
+	// Register the substep update and detect the grasp state (called by the tick or by the fleet)
+	void UpdateGripper();
+
+	// Get the handle in the fleet (INDEX_NONE if not managed by a fleet)
+	int32 GetFleetHandle() const { return FleetHandle; };
+
+	// Get the current grasp state
+	EMCGripperGraspState GetGraspState() const { return GraspState; };
+
+	// True if the gripper holds an object (stable or slipping)
+	bool IsGrasping() const { return GraspState == EMCGripperGraspState::Stable || GraspState == EMCGripperGraspState::Slipping; };
+
+	// Get the held or touched object (nullptr if free)
+	AActor* GetGraspedObject() const { return GraspedObject.Get(); };
+
+	// Get the left finger contacts of the last physics frame
+	const FMCGripperFingerContact& GetLeftFingerContact() const { return LeftFingerContact; };
+
+	// Get the right finger contacts of the last physics frame
+	const FMCGripperFingerContact& GetRightFingerContact() const { return RightFingerContact; };
+
+	// Get the measured gap between the fingers (only updated by the position, acceleration and force control types)
+	float GetFingerGap() const { return PGController ? PGController->GetFingerGap() : 0.f; };
+
 private:
 	// Set default values to the constraints
 	void SetupConstraint(UPhysicsConstraintComponent* Constraint);
@@ -54,6 +90,30 @@ private:
 	// Set default physics and collision values to the static meshes
 	void SetupPhysics(UStaticMeshComponent* StaticMeshComponent);
 
+	// Aggregate the finger contacts of the last physics frame and broadcast the grasp state changes
+	void UpdateGraspState();
+
+	// Called when a finger collides with an object
+	UFUNCTION()
+	void OnFingerHit(UPrimitiveComponent* HitComponent,
+		AActor* OtherActor,
+		UPrimitiveComponent* OtherComp,
+		FVector NormalImpulse,
+		const FHitResult& Hit);
+
+public:
+	// Called when a finger starts touching an object
+	FMCGripperGraspSignature OnGripperContact;
+
+	// Called when both fingers hold an object without slipping
+	FMCGripperGraspSignature OnGraspStable;
+
+	// Called when the held object starts slipping
+	FMCGripperSlipSignature OnGraspSlip;
+
+	// Called when the held object is released
+	FMCGripperGraspSignature OnGraspRelease;
+
 private:
 #if WITH_EDITORONLY_DATA
 	// Hand type, setup default params
@@ -62,9 +122,17 @@ private:
 #endif // WITH_EDITORONLY_DATA
 
 	// Input axis name
-	UPROPERTY(EditAnywhere, Category = "Parallel Gripper")
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper", meta = (editcondition = "!bUseFleet"))
 	FName InputAxisName;
 
+	// Skip the controller updates if the input did not change enough
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper", meta = (editcondition = "!bUseFleet"))
+	FMCInputFilter InputFilter;
+
+	// Command the gripper programmatically through the world fleet instead of the input axis
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper")
+	bool bUseFleet;
+
 	// Left finger static mesh
 	UPROPERTY(EditAnywhere, Category = "Parallel Gripper")
 	AStaticMeshActor* LeftFinger;
@@ -102,6 +170,51 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Parallel Gripper|PID Driver", meta = (ClampMin = 0))
 	float Max;
 
+	// Anti-windup, derivative filtering and output slew limiting
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper|PID Driver")
+	FMCPIDSettings PIDSettings;
+
+	// Grip force applied once a finger is blocked by an object (Acceleration / Force), scaled by the input, 0 = disabled
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper|PID Driver", meta = (ClampMin = 0))
+	float GripForce;
+
+	// Handle in the fleet
+	int32 FleetHandle;
+
+	/* Grasp state */
+	// Aggregate the finger contacts and broadcast the grasp state events
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper|Grasp State")
+	bool bDetectGraspState;
+
+	// Minimal normal force on each finger for a stable grasp
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper|Grasp State", meta = (ClampMin = 0, editcondition = "bDetectGraspState"))
+	float MinGraspForce;
+
+	// Tangential speed (cm/s) between the object and the fingers above which the grasp is slipping
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper|Grasp State", meta = (ClampMin = 0, editcondition = "bDetectGraspState"))
+	float SlipSpeedThreshold;
+
+	// Number of physics steps without the contacts before the grasp is considered lost (avoids flickering)
+	UPROPERTY(EditAnywhere, Category = "Parallel Gripper|Grasp State", meta = (ClampMin = 1, editcondition = "bDetectGraspState"))
+	int32 GraspLossSteps;
+
+	// Current grasp state
+	EMCGripperGraspState GraspState;
+
+	// Held or touched object
+	TWeakObjectPtr<AActor> GraspedObject;
+
+	// Consecutive steps with fewer contacts than the current state requires
+	int32 NumLostSteps;
+
+	// Finger contacts aggregated from the hit events of the current step
+	FMCGripperFingerContact PendingLeftContact;
+	FMCGripperFingerContact PendingRightContact;
+
+	// Finger contacts of the last completed step
+	FMCGripperFingerContact LeftFingerContact;
+	FMCGripperFingerContact RightFingerContact;
+
 	// Parallel grasp controller (take the input from user and maps it to the gripper)
 	UPROPERTY() // Avoid GC
 	UMCParallelGripperController* PGController;
@@ -0,0 +1,103 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Containers/Queue.h"
+#include "MCParallelGripperFleet.generated.h"
+
+// Forward declaration
+class UMCParallelGripper;
+
+/**
+* Gripper command, the opening is normalized (0 closed - 1 open), a negative force keeps the current force
+*/
+struct FMCGripperCommand
+{
+	// Handle of the gripper in the fleet
+	int32 GripperHandle;
+
+	// Target opening
+	float Opening;
+
+	// Target force
+	float Force;
+};
+
+/**
+ * World level manager of the parallel grippers commanded programmatically,
+ * applies the commands and updates all the registered grippers in one pre physics pass
+ */
+UCLASS(NotPlaceable, Transient)
+class UMCPARALLELGRIPPER_API AMCParallelGripperFleet : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values
+	AMCParallelGripperFleet();
+
+	// Get the fleet of the world, spawn it if it does not exist
+	static AMCParallelGripperFleet* Get(UWorld* InWorld);
+
+	// Get the fleet of the world, nullptr if it does not exist (never spawns)
+	static AMCParallelGripperFleet* Find(UWorld* InWorld);
+
+	// Apply the queued commands and update the grippers
+	virtual void Tick(float DeltaTime) override;
+
+	// Add the gripper to the fleet, return its handle (index and generation, INDEX_NONE if full)
+	int32 Register(UMCParallelGripper* InGripper);
+
+	// Remove the gripper from the fleet, its index can be reused, its handle becomes stale
+	void Unregister(int32 InHandle);
+
+	// Set the command of the gripper, applied in the next update (game thread), ignored for stale handles
+	void Command(int32 InHandle, float InOpening, float InForce = -1.f);
+
+	// Queue the command of the gripper, applied in the next update (thread safe, lock free), ignored for stale handles
+	void EnqueueCommand(int32 InHandle, float InOpening, float InForce = -1.f);
+
+	// Index of the gripper from its handle
+	static int32 GetHandleIndex(int32 InHandle) { return InHandle & IndexMask; };
+
+	// Number of registered grippers
+	int32 Num() const { return Grippers.Num() - FreeIndices.Num(); }
+
+private:
+	// Move the queued commands to the pending commands
+	void DrainCommandQueue();
+
+	// Get the index of the registered gripper, false if the handle is stale
+	bool ResolveHandle(int32 InHandle, int32& OutIndex) const;
+
+private:
+	// Registered grippers (nullptr for the free indices)
+	UPROPERTY()
+	TArray<UMCParallelGripper*> Grippers;
+
+	// Pending openings
+	TArray<float> Openings;
+
+	// Pending forces
+	TArray<float> Forces;
+
+	// Gripper has a pending command
+	TBitArray<> DirtyFlags;
+
+	// Generation of every index, increased when the gripper is unregistered
+	TArray<int32> Generations;
+
+	// Handle layout, the lower bits are the index, the upper ones the generation
+	static constexpr int32 IndexBits = 16;
+	static constexpr int32 IndexMask = (1 << IndexBits) - 1;
+	static constexpr int32 GenerationMask = (1 << (31 - IndexBits)) - 1;
+
+	// Indices of unregistered grippers
+	TArray<int32> FreeIndices;
+
+	// Commands from other threads (multiple producers, consumed by the game thread)
+	TQueue<FMCGripperCommand, EQueueMode::Mpsc> CommandQueue;
+};
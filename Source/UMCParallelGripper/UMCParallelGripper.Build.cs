@@ -45,7 +45,7 @@ public class UMCParallelGripper : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-				//"UMCPIDController",
+				"UMCPIDController", // finger acceleration / force control
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);